@@ -0,0 +1,1186 @@
+/*
+ *  autoplay.c
+ *
+ *  Created on: 17-Oct-2026
+ *      Author: lucas-noce
+ */
+
+/* ==========================================================================================================
+ * Includes
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdint.h>
+#include <stdbool.h>
+#include <string.h>
+#include <stdatomic.h>
+
+#include "main.h"
+#include "game_config.h"
+#include "pieces.h"
+#include "board.h"
+#include "game.h"
+#include "command.h"
+#include "placement.h"
+#include "platform.h"
+#include "autoplay.h"
+
+
+/* ==========================================================================================================
+ * Definitions
+ */
+
+#define AUTOPLAY_ROUND_UP( value, multiple )  ( ( ( (value) + (multiple) - 1 ) / (multiple) ) * (multiple) )
+
+/* A path visits each piece state at most once */
+#define AUTOPLAY_PATH_SIZE( col_size )  \
+  ( ( (size_t) PIECE_ROTATION_COUNT * (col_size) * PLACEMENT_MAX_ROW_SIZE > UINT16_MAX ) ? \
+    UINT16_MAX : (size_t) PIECE_ROTATION_COUNT * (col_size) * PLACEMENT_MAX_ROW_SIZE )
+
+
+/* ==========================================================================================================
+ * Static variables
+ */
+
+/* Weights of the well known four feature player, plus a small penalty on wells so the bot does not dig them */
+static const AUTOPLAY_WEIGHTS_T autoplay_default_weights = {
+  .aggregate_height = -0.510066f,
+  .holes            = -0.35663f,
+  .bumpiness        = -0.184483f,
+  .wells            = -0.05f,
+  .lines            = 0.760666f,
+};
+
+
+/* ==========================================================================================================
+ * Static Function Prototypes
+ */
+
+/*!
+  @brief        Waits for a move to search, scores placements of the root board or expands boards of the beam until
+                none is left, then reports back, until the pool stops.
+
+  @param[in]    data: pointer to the AUTOPLAY_WORKER_T of the thread.
+
+  @returns      0
+*/
+static uint32_t _autoplay_worker_thread( void *data );
+
+/*!
+  @brief        Allocates the placement search and the feature planes of a search context.
+
+  @param[in]    p_autoplay: pointer to the workspace, with its board size set.
+  @param[out]   p_eval: pointer to the context.
+
+  @returns      One of the possible TETRIS_RET_x macro values (defined in main.h).
+*/
+static int8_t _eval_init( const AUTOPLAY_STRUCT_T *p_autoplay, AUTOPLAY_EVAL_T *p_eval );
+
+/*!
+  @brief        Releases a search context.
+
+  @param[in]    p_eval: pointer to the context.
+
+  @returns      void
+*/
+static void _eval_deinit( AUTOPLAY_EVAL_T *p_eval );
+
+/*!
+  @brief        Wakes the pool on the root board or on the beam, takes a share of the work on the calling thread,
+                then waits for every worker to be done.
+
+  @param[in]    p_autoplay: pointer to the workspace.
+  @param[in]    is_expanding: the pool expands the beam instead of scoring the placements of the root board.
+
+  @returns      void
+*/
+static void _run_pool( AUTOPLAY_STRUCT_T *p_autoplay, bool is_expanding );
+
+/*!
+  @brief        Searches the pieces of the preview from the best boards of the current piece, one depth at a time,
+                until the configured depth, the deadline or the node budget.
+
+  @param[in]    p_autoplay: pointer to the workspace, with the placements of the root board scored.
+  @param[in]    p_game: pointer to the game, for the preview.
+  @param[in]    best_idx: best placement of the root board alone, played when every placement ends the game.
+  @param[out]   p_depth: deepest depth completed.
+
+  @returns      The placement of the root board to play.
+*/
+static uint32_t _search_beam( AUTOPLAY_STRUCT_T *p_autoplay, tetris_game_t *p_game, uint32_t best_idx,
+                              uint8_t *p_depth );
+
+/*!
+  @brief        Expands the boards of the beam left to a thread, then steals the boards left to the other threads,
+                until none is left or the deadline passes.
+
+  @param[in]    p_autoplay: pointer to the workspace.
+  @param[in]    p_worker: the thread, entry of the pool.
+
+  @returns      void
+*/
+static void _expand_tasks( AUTOPLAY_STRUCT_T *p_autoplay, AUTOPLAY_WORKER_T *p_worker );
+
+/*!
+  @brief        Scores every placement of the beam piece on a board of the beam and keeps the best of them as the
+                candidates of that board.
+
+  @param[in]    p_autoplay: pointer to the workspace.
+  @param[in]    p_eval: the search context of the calling thread.
+  @param[in]    beam_idx: the board of the beam.
+
+  @returns      void
+*/
+static void _expand_node( AUTOPLAY_STRUCT_T *p_autoplay, AUTOPLAY_EVAL_T *p_eval, uint16_t beam_idx );
+
+/*!
+  @brief        Inserts a board into a list sorted from the best value, dropping the worst one when the list is full.
+                Boards of equal value keep their insertion order.
+
+  @param[in]    p_nodes: the list.
+  @param[in]    p_count: number of boards in the list, updated.
+  @param[in]    width: most boards in the list.
+  @param[in]    p_node: the board to insert.
+
+  @returns      void
+*/
+static void _beam_insert( AUTOPLAY_NODE_T *p_nodes, uint16_t *p_count, uint16_t width, const AUTOPLAY_NODE_T *p_node );
+
+/*!
+  @brief        Inserts a board into the beam being built, unless the same board is already in it with a value as
+                high. A board reached again with a higher value takes the place of the one in the beam.
+
+  @param[in]    p_autoplay: pointer to the workspace, with the boards of the depth stored in its transposition table.
+  @param[in]    p_nodes: the beam.
+  @param[in]    p_count: number of boards in the beam, updated.
+  @param[in]    p_node: the board to insert, its hash is computed here.
+  @param[in]    type: the piece of the last placement.
+  @param[in]    p_from: the board before the last placement, given by its columns.
+  @param[in]    hash: hash of the board before the last placement.
+
+  @returns      void
+*/
+static void _beam_offer( AUTOPLAY_STRUCT_T *p_autoplay, AUTOPLAY_NODE_T *p_nodes, uint16_t *p_count,
+                         const AUTOPLAY_NODE_T *p_node, uint8_t type, const board_word_t *p_from, uint64_t hash );
+
+/*!
+  @brief        Computes the Zobrist hash of a board after a placement from the hash of the board before it: the
+                cells of the piece are added, or the board is hashed again when the piece completes rows.
+
+  @param[in]    p_autoplay: pointer to the workspace.
+  @param[in]    type: the piece.
+  @param[in]    p_placement: the placement.
+  @param[in]    p_from: the board before the move, given by its columns.
+  @param[in]    hash: hash of the board before the move.
+
+  @returns      The hash of the board after the move.
+*/
+static uint64_t _placement_hash( const AUTOPLAY_STRUCT_T *p_autoplay, uint8_t type, const PLACEMENT_T *p_placement,
+                                 const board_word_t *p_from, uint64_t hash );
+
+/*!
+  @brief        Fixes a piece at a placement on a board given by its columns and removes the rows it completes.
+
+  @param[in]    p_autoplay: pointer to the workspace.
+  @param[in]    type: the piece.
+  @param[in]    p_placement: the placement.
+  @param[in]    p_from: the board before the move.
+  @param[out]   p_to: the board after the move.
+
+  @returns      void
+*/
+static void _apply_placement( const AUTOPLAY_STRUCT_T *p_autoplay, uint8_t type, const PLACEMENT_T *p_placement,
+                              const board_word_t *p_from, board_word_t *p_to );
+
+/*!
+  @brief        Computes the features of every column of the board before the move, and their sums.
+
+  @param[in]    p_autoplay: pointer to the workspace.
+  @param[in]    p_eval: the search context, with the columns of the board in its search.
+
+  @returns      void
+*/
+static void _init_move_features( const AUTOPLAY_STRUCT_T *p_autoplay, AUTOPLAY_EVAL_T *p_eval );
+
+/*!
+  @brief        Scores chunks of placements of the root board taken from `next_placement` until every placement is
+                scored.
+
+  @param[in]    p_autoplay: pointer to the workspace.
+
+  @returns      void
+*/
+static void _evaluate_chunks( AUTOPLAY_STRUCT_T *p_autoplay );
+
+/*!
+  @brief        Computes the weighted features of the board once a piece is fixed at a placement.
+
+  @param[in]    p_autoplay: pointer to the workspace.
+  @param[in]    p_eval: the search context, with the features of the board before the move.
+  @param[in]    p_placement: the placement, of the piece of the last search of the context.
+  @param[out]   p_lines: rows cleared by the placement.
+
+  @returns      The score of the placement, AUTOPLAY_SCORE_GAME_OVER if it ends the game.
+*/
+static float _evaluate_placement( const AUTOPLAY_STRUCT_T *p_autoplay, const AUTOPLAY_EVAL_T *p_eval,
+                                  const PLACEMENT_T *p_placement, uint8_t *p_lines );
+
+/*!
+  @brief        Removes rows from a column, the cells above each of them fall by one row.
+
+  @param[in]    cells: the cells of the column.
+  @param[in]    rows: the rows to remove.
+
+  @returns      The cells left.
+*/
+static inline board_word_t _remove_rows( board_word_t cells, board_word_t rows );
+
+/*!
+  @brief        Gets the height of a column.
+
+  @param[in]    p_autoplay: pointer to the workspace.
+  @param[in]    cells: the playable cells of the column.
+
+  @returns      Number of rows from the bottom border up to the highest fixed cell.
+*/
+static inline uint8_t _column_height( const AUTOPLAY_STRUCT_T *p_autoplay, board_word_t cells );
+
+/*!
+  @brief        Counts the holes of a column.
+
+  @param[in]    p_autoplay: pointer to the workspace.
+  @param[in]    cells: the playable cells of the column.
+
+  @returns      Number of empty cells below the highest fixed cell.
+*/
+static inline uint8_t _column_holes( const AUTOPLAY_STRUCT_T *p_autoplay, board_word_t cells );
+
+/*!
+  @brief        Gets the depth of a column below its neighbours.
+
+  @param[in]    left, height, right: heights of the left neighbour, of the column and of the right neighbour.
+
+  @returns      How far the column is below the lower neighbour, 0 if it is not below both.
+*/
+static inline uint8_t _well_depth( uint8_t left, uint8_t height, uint8_t right );
+
+/*!
+  @brief        Gets the absolute difference of two heights.
+
+  @param[in]    a, b: the heights.
+
+  @returns      |a - b|
+*/
+static inline uint8_t _height_diff( uint8_t a, uint8_t b );
+
+
+/* ==========================================================================================================
+ * Global Functions Declaration
+ */
+
+int8_t autoplay_init( AUTOPLAY_STRUCT_T *p_autoplay, uint16_t row_size, uint16_t col_size,
+                      const AUTOPLAY_CONFIG_T *p_config ){
+  memset( p_autoplay, 0, sizeof( AUTOPLAY_STRUCT_T ) );
+
+  /* A row of the board is a bit of a board word */
+  if( row_size < BOARD_MIN_ROW_SIZE || row_size > PLACEMENT_MAX_ROW_SIZE ||
+      col_size < BOARD_MIN_COL_SIZE || col_size > BOARD_MAX_COL_SIZE ){
+    LOG_WRN( "Automatic player does not support a %u x %u board\n", row_size, col_size );
+    return TETRIS_RET_ERR;
+  }
+
+  p_autoplay->config        = *p_config;
+  p_autoplay->weights       = autoplay_default_weights;
+  p_autoplay->row_size      = row_size;
+  p_autoplay->col_size      = col_size;
+  p_autoplay->playable_rows = ( (board_word_t) 1u << ( row_size - 1 ) ) - 1;
+
+  if( p_autoplay->config.depth < 1 )
+    p_autoplay->config.depth = 1;
+
+  if( p_autoplay->config.depth > AUTOPLAY_MAX_DEPTH )
+    p_autoplay->config.depth = AUTOPLAY_MAX_DEPTH;
+
+  if( p_autoplay->config.beam_width < 1 )
+    p_autoplay->config.beam_width = 1;
+
+  if( p_autoplay->config.beam_width > AUTOPLAY_MAX_BEAM_WIDTH )
+    p_autoplay->config.beam_width = AUTOPLAY_MAX_BEAM_WIDTH;
+
+  if( p_autoplay->config.max_workers > AUTOPLAY_MAX_WORKERS )
+    p_autoplay->config.max_workers = AUTOPLAY_MAX_WORKERS;
+
+  if( _eval_init( p_autoplay, &p_autoplay->root ) != TETRIS_RET_OK )
+    return TETRIS_RET_ERR;
+
+  /* The beam is only needed to look ahead */
+  bool is_lookahead     = ( p_autoplay->config.depth > 1 );
+  size_t width          = is_lookahead ? p_autoplay->config.beam_width : 0;
+  size_t path_size      = AUTOPLAY_ROUND_UP( AUTOPLAY_PATH_SIZE( col_size ), GAME_CONFIG_CACHE_LINE_SIZE );
+  size_t beam_size      = AUTOPLAY_ROUND_UP( width * sizeof( AUTOPLAY_NODE_T ), GAME_CONFIG_CACHE_LINE_SIZE );
+  size_t candidate_size = AUTOPLAY_ROUND_UP( width * width * sizeof( AUTOPLAY_NODE_T ), GAME_CONFIG_CACHE_LINE_SIZE );
+  size_t count_size     = AUTOPLAY_ROUND_UP( width * sizeof( uint16_t ), GAME_CONFIG_CACHE_LINE_SIZE );
+  size_t layer_size     = AUTOPLAY_ROUND_UP( width * col_size * sizeof( board_word_t ), GAME_CONFIG_CACHE_LINE_SIZE );
+  size_t key_count      = is_lookahead ? (size_t) row_size * col_size : 0;
+  size_t key_size       = AUTOPLAY_ROUND_UP( key_count * sizeof( uint64_t ), GAME_CONFIG_CACHE_LINE_SIZE );
+  size_t total_size     = path_size + 2 * beam_size + candidate_size + count_size + 2 * layer_size + key_size;
+
+  p_autoplay->p_storage = game_aligned_alloc( total_size );
+  if( p_autoplay->p_storage == NULL ){
+    LOG_WRN( "Failed to allocate %zu bytes for the automatic player\n", total_size );
+    _eval_deinit( &p_autoplay->root );
+    return TETRIS_RET_ERR;
+  }
+
+  memset( p_autoplay->p_storage, 0, total_size );
+  p_autoplay->storage_size = total_size;
+
+  uint8_t *p_plane = (uint8_t *) p_autoplay->p_storage;
+
+  p_autoplay->path             = p_plane;                      p_plane += path_size;
+  p_autoplay->beam             = (AUTOPLAY_NODE_T *) p_plane;  p_plane += beam_size;
+  p_autoplay->next_beam        = (AUTOPLAY_NODE_T *) p_plane;  p_plane += beam_size;
+  p_autoplay->candidates       = (AUTOPLAY_NODE_T *) p_plane;  p_plane += candidate_size;
+  p_autoplay->candidate_counts = (uint16_t *) p_plane;         p_plane += count_size;
+  p_autoplay->beam_columns[0]  = (board_word_t *) p_plane;     p_plane += layer_size;
+  p_autoplay->beam_columns[1]  = (board_word_t *) p_plane;     p_plane += layer_size;
+  p_autoplay->zobrist_keys     = (uint64_t *) p_plane;
+
+  if( is_lookahead ){
+    /* The keys of the game board, so the hashes of the beam and of the game agree */
+    for( uint16_t c=0; c<col_size; c++ ){
+      for( uint16_t r=0; r<row_size; r++ ){
+        p_autoplay->zobrist_keys[(size_t) c * row_size + r] = board_zobrist_key( r, c );
+      }
+    }
+
+    /* At most the width candidates of every board of the beam are stored at each depth, the buckets stay half
+       empty */
+    uint32_t bucket_count = (uint32_t) ( 2 * width * width / TRANSPOSITION_BUCKET_ENTRIES );
+
+    if( bucket_count > AUTOPLAY_MAX_TRANSPOSITION_BUCKETS )
+      bucket_count = AUTOPLAY_MAX_TRANSPOSITION_BUCKETS;
+
+    if( transposition_init( &p_autoplay->transposition, bucket_count ) != TETRIS_RET_OK ){
+      autoplay_deinit( p_autoplay );
+      return TETRIS_RET_ERR;
+    }
+  }
+
+  atomic_init( &p_autoplay->next_placement, 0 );
+  atomic_init( &p_autoplay->is_timed_out, false );
+  atomic_init( &p_autoplay->is_stopping, false );
+
+  /* Entry 0 of the pool is the calling thread */
+  for( uint8_t i=0; i<=AUTOPLAY_MAX_WORKERS; i++ ){
+    p_autoplay->workers[i].p_autoplay = p_autoplay;
+    p_autoplay->workers[i].idx        = i;
+    atomic_init( &p_autoplay->workers[i].next_task, 0 );
+  }
+
+  if( is_lookahead && _eval_init( p_autoplay, &p_autoplay->workers[0].eval ) != TETRIS_RET_OK ){
+    autoplay_deinit( p_autoplay );
+    return TETRIS_RET_ERR;
+  }
+
+  if( !is_lookahead && col_size < AUTOPLAY_POOL_MIN_COL_SIZE )
+    return TETRIS_RET_OK;
+
+  /* A worker that fails to start only makes the pool smaller */
+  for( uint8_t i=0; i<p_autoplay->config.max_workers; i++ ){
+    AUTOPLAY_WORKER_T *p_worker = &p_autoplay->workers[p_autoplay->worker_count + 1];
+
+    if( is_lookahead && _eval_init( p_autoplay, &p_worker->eval ) != TETRIS_RET_OK )
+      break;
+
+    if( platform_event_init( &p_worker->start_event ) != TETRIS_RET_OK ){
+      _eval_deinit( &p_worker->eval );
+      break;
+    }
+
+    if( platform_event_init( &p_worker->done_event ) != TETRIS_RET_OK ){
+      platform_event_deinit( &p_worker->start_event );
+      _eval_deinit( &p_worker->eval );
+      break;
+    }
+
+    if( platform_thread_create( &p_worker->thread, _autoplay_worker_thread, p_worker ) != TETRIS_RET_OK ){
+      platform_event_deinit( &p_worker->done_event );
+      platform_event_deinit( &p_worker->start_event );
+      _eval_deinit( &p_worker->eval );
+      break;
+    }
+
+    p_autoplay->worker_count++;
+  }
+
+  LOG_DBG( "Automatic player started %u workers\n", p_autoplay->worker_count );
+
+  return TETRIS_RET_OK;
+}
+
+
+void autoplay_deinit( AUTOPLAY_STRUCT_T *p_autoplay ){
+  atomic_store( &p_autoplay->is_stopping, true );
+
+  for( uint8_t i=1; i<=p_autoplay->worker_count; i++ ){
+    platform_event_set( &p_autoplay->workers[i].start_event );
+  }
+
+  for( uint8_t i=1; i<=p_autoplay->worker_count; i++ ){
+    platform_thread_join( &p_autoplay->workers[i].thread );
+    platform_event_deinit( &p_autoplay->workers[i].start_event );
+    platform_event_deinit( &p_autoplay->workers[i].done_event );
+    _eval_deinit( &p_autoplay->workers[i].eval );
+  }
+
+  p_autoplay->worker_count = 0;
+  _eval_deinit( &p_autoplay->workers[0].eval );
+
+  game_aligned_free( p_autoplay->p_storage );
+  p_autoplay->p_storage    = NULL;
+  p_autoplay->storage_size = 0;
+
+  transposition_deinit( &p_autoplay->transposition );
+  _eval_deinit( &p_autoplay->root );
+}
+
+
+void autoplay_set_weights( AUTOPLAY_STRUCT_T *p_autoplay, const AUTOPLAY_WEIGHTS_T *p_weights ){
+  p_autoplay->weights = *p_weights;
+}
+
+
+void autoplay_get_default_weights( AUTOPLAY_WEIGHTS_T *p_weights ){
+  *p_weights = autoplay_default_weights;
+}
+
+
+int8_t autoplay_choose( AUTOPLAY_STRUCT_T *p_autoplay, tetris_game_t *p_game, uint64_t deadline_ns,
+                        uint64_t node_budget, const uint8_t **pp_commands, uint16_t *p_count ){
+  PLACEMENT_SEARCH_T *p_search = &p_autoplay->root.search;
+  uint64_t start_ns            = platform_get_time_ns();
+  uint32_t best_idx            = 0;
+  uint8_t depth                = 1;
+
+  *pp_commands = p_autoplay->path;
+  *p_count     = 0;
+
+  if( !p_game->board.has_current_piece )
+    return TETRIS_RET_ERR_NO_PIECE;
+
+  if( p_autoplay->p_storage == NULL || p_game->board.row_size != p_autoplay->row_size ||
+      p_game->board.col_size != p_autoplay->col_size )
+    return TETRIS_RET_ERR;
+
+  if( placement_find_all( p_search, p_game, &p_game->board.current_piece ) != TETRIS_RET_OK ||
+      p_search->placement_count == 0 )
+    return TETRIS_RET_ERR;
+
+  _init_move_features( p_autoplay, &p_autoplay->root );
+  atomic_store_explicit( &p_autoplay->next_placement, 0, memory_order_relaxed );
+  atomic_store_explicit( &p_autoplay->is_timed_out, false, memory_order_relaxed );
+  p_autoplay->deadline_ns = deadline_ns;
+  p_autoplay->node_budget = node_budget;
+
+  if( p_autoplay->worker_count > 0 && p_search->placement_count > AUTOPLAY_CHUNK_PLACEMENTS ){
+    _run_pool( p_autoplay, false );
+  }
+  else{
+    _evaluate_chunks( p_autoplay );
+  }
+
+  p_autoplay->stats.node_count += p_search->placement_count;
+
+  /* Ties go to the first placement found, so the choice does not depend on which thread scored what */
+  for( uint32_t i=1; i<p_search->placement_count; i++ ){
+    if( p_autoplay->root.scores[i] > p_autoplay->root.scores[best_idx] ){
+      best_idx = i;
+    }
+  }
+
+  if( p_autoplay->config.depth > 1 ){
+    best_idx = _search_beam( p_autoplay, p_game, best_idx, &depth );
+  }
+
+  p_autoplay->stats.move_count++;
+  p_autoplay->stats.depth_sum  += depth;
+  p_autoplay->stats.elapsed_ns += platform_get_time_ns() - start_ns;
+
+  if( atomic_load_explicit( &p_autoplay->is_timed_out, memory_order_relaxed ) ){
+    p_autoplay->stats.timeout_count++;
+  }
+
+  return placement_get_path( p_search, &p_search->placements[best_idx], p_autoplay->path,
+                             (uint16_t) AUTOPLAY_PATH_SIZE( p_autoplay->col_size ), p_count );
+}
+
+
+uint64_t autoplay_get_deadline_ns( const tetris_game_t *p_game ){
+  return platform_get_time_ns() +
+         (uint64_t) p_game->clock.gravity_ticks * GAME_CONFIG_TICK_MS * 1000000ull / 2;
+}
+
+
+uint64_t autoplay_get_node_budget( const tetris_game_t *p_game ){
+  return (uint64_t) p_game->clock.gravity_ticks * GAME_CONFIG_TICK_MS * AUTOPLAY_BUDGET_NODES_PER_MS / 2;
+}
+
+
+void autoplay_stats_print( const AUTOPLAY_STATS_T *p_stats, uint8_t depth ){
+  double seconds = (double) p_stats->elapsed_ns / 1e9;
+  double moves   = ( p_stats->move_count > 0 ) ? (double) p_stats->move_count : 1.0;
+
+  fprintf( stderr, "automatic player              moves      depth   timeouts duplicates    nodes/s\n" );
+  fprintf( stderr, "%-22s %10llu %6.2f/%-3u %10llu %10llu %10.0f\n", "lookahead",
+           (unsigned long long) p_stats->move_count,
+           (double) p_stats->depth_sum / moves, depth,
+           (unsigned long long) p_stats->timeout_count,
+           (unsigned long long) p_stats->duplicate_count,
+           ( seconds > 0.0 ) ? (double) p_stats->node_count / seconds : 0.0 );
+}
+
+
+/* ==========================================================================================================
+ * Static Functions Declaration
+ */
+
+static uint32_t _autoplay_worker_thread( void *data ){
+  AUTOPLAY_WORKER_T *p_worker   = (AUTOPLAY_WORKER_T *) data;
+  AUTOPLAY_STRUCT_T *p_autoplay = p_worker->p_autoplay;
+
+  while( 1 ){
+    platform_event_wait( &p_worker->start_event );
+
+    if( atomic_load( &p_autoplay->is_stopping ) )
+      return 0;
+
+    if( p_autoplay->is_expanding ){
+      _expand_tasks( p_autoplay, p_worker );
+    }
+    else{
+      _evaluate_chunks( p_autoplay );
+    }
+
+    platform_event_set( &p_worker->done_event );
+  }
+
+  return 0;
+}
+
+
+static int8_t _eval_init( const AUTOPLAY_STRUCT_T *p_autoplay, AUTOPLAY_EVAL_T *p_eval ){
+  uint16_t col_size = p_autoplay->col_size;
+
+  memset( p_eval, 0, sizeof( AUTOPLAY_EVAL_T ) );
+
+  if( placement_search_init( &p_eval->search, p_autoplay->row_size, col_size ) != TETRIS_RET_OK )
+    return TETRIS_RET_ERR;
+
+  size_t placements   = (size_t) PIECE_ROTATION_COUNT * col_size * PLACEMENT_MAX_ROW_SIZE;
+  size_t scores_size  = AUTOPLAY_ROUND_UP( placements * sizeof( float ), GAME_CONFIG_CACHE_LINE_SIZE );
+  size_t lines_size   = AUTOPLAY_ROUND_UP( placements, GAME_CONFIG_CACHE_LINE_SIZE );
+  size_t feature_size = AUTOPLAY_ROUND_UP( col_size, GAME_CONFIG_CACHE_LINE_SIZE );
+  size_t and_size     = AUTOPLAY_ROUND_UP( col_size * sizeof( board_word_t ), GAME_CONFIG_CACHE_LINE_SIZE );
+  size_t total_size   = scores_size + lines_size + 3 * feature_size + 2 * and_size;
+
+  p_eval->p_storage = game_aligned_alloc( total_size );
+  if( p_eval->p_storage == NULL ){
+    LOG_WRN( "Failed to allocate %zu bytes for the automatic player\n", total_size );
+    placement_search_deinit( &p_eval->search );
+    return TETRIS_RET_ERR;
+  }
+
+  memset( p_eval->p_storage, 0, total_size );
+  p_eval->storage_size = total_size;
+
+  /* Every plane starts at a cache line boundary, so the scores written by the pool share no line with the rest */
+  uint8_t *p_plane = (uint8_t *) p_eval->p_storage;
+
+  p_eval->scores     = (float *) p_plane;         p_plane += scores_size;
+  p_eval->lines      = p_plane;                   p_plane += lines_size;
+  p_eval->heights    = p_plane;                   p_plane += feature_size;
+  p_eval->holes      = p_plane;                   p_plane += feature_size;
+  p_eval->wells      = p_plane;                   p_plane += feature_size;
+  p_eval->and_prefix = (board_word_t *) p_plane;  p_plane += and_size;
+  p_eval->and_suffix = (board_word_t *) p_plane;
+
+  return TETRIS_RET_OK;
+}
+
+
+static void _eval_deinit( AUTOPLAY_EVAL_T *p_eval ){
+  game_aligned_free( p_eval->p_storage );
+  p_eval->p_storage    = NULL;
+  p_eval->storage_size = 0;
+
+  placement_search_deinit( &p_eval->search );
+}
+
+
+static void _run_pool( AUTOPLAY_STRUCT_T *p_autoplay, bool is_expanding ){
+  /* Written before the workers wake up, the event publishes it */
+  p_autoplay->is_expanding = is_expanding;
+
+  for( uint8_t i=1; i<=p_autoplay->worker_count; i++ ){
+    platform_event_set( &p_autoplay->workers[i].start_event );
+  }
+
+  if( is_expanding ){
+    _expand_tasks( p_autoplay, &p_autoplay->workers[0] );
+  }
+  else{
+    _evaluate_chunks( p_autoplay );
+  }
+
+  for( uint8_t i=1; i<=p_autoplay->worker_count; i++ ){
+    platform_event_wait( &p_autoplay->workers[i].done_event );
+  }
+}
+
+
+static uint32_t _search_beam( AUTOPLAY_STRUCT_T *p_autoplay, tetris_game_t *p_game, uint32_t best_idx,
+                              uint8_t *p_depth ){
+  const AUTOPLAY_EVAL_T *p_root = &p_autoplay->root;
+  AUTOPLAY_NODE_T *p_nodes      = NULL;
+  AUTOPLAY_NODE_T node;
+  RANDOMIZER_PIECE_T next_piece;
+  uint16_t width         = p_autoplay->config.beam_width;
+  uint16_t col_size      = p_autoplay->col_size;
+  uint8_t context_count  = p_autoplay->worker_count + 1;
+  uint16_t next_count    = 0;
+  uint8_t next_layer     = 0;
+  uint64_t node_count    = p_root->search.placement_count;
+
+  p_autoplay->beam_count = 0;
+  p_autoplay->beam_layer = 0;
+
+  /* The best placements of the current piece are gathered first, then only the best of each board is kept */
+  for( uint32_t i=0; i<p_root->search.placement_count; i++ ){
+    if( p_root->scores[i] <= AUTOPLAY_SCORE_GAME_OVER )
+      continue;
+
+    node.value       = p_root->scores[i];
+    node.line_reward = p_autoplay->weights.lines * (float) p_root->lines[i];
+    node.root_idx    = i;
+    node.parent_idx  = 0;
+    node.placement   = p_root->search.placements[i];
+
+    _beam_insert( p_autoplay->next_beam, &next_count, width, &node );
+  }
+
+  transposition_new_search( &p_autoplay->transposition );
+
+  for( uint16_t i=0; i<next_count; i++ ){
+    _beam_offer( p_autoplay, p_autoplay->beam, &p_autoplay->beam_count, &p_autoplay->next_beam[i], p_root->search.type,
+                 p_root->search.columns, p_game->board.zobrist_hash );
+  }
+
+  if( p_autoplay->beam_count == 0 )
+    return best_idx;
+
+  for( uint16_t b=0; b<p_autoplay->beam_count; b++ ){
+    _apply_placement( p_autoplay, p_root->search.type, &p_autoplay->beam[b].placement, p_root->search.columns,
+                      &p_autoplay->beam_columns[0][(size_t) b * col_size] );
+  }
+
+  for( uint8_t d=1; d<p_autoplay->config.depth; d++ ){
+    if( p_autoplay->deadline_ns != AUTOPLAY_NO_DEADLINE && platform_get_time_ns() >= p_autoplay->deadline_ns ){
+      atomic_store_explicit( &p_autoplay->is_timed_out, true, memory_order_relaxed );
+      break;
+    }
+
+    /* Only counts of complete depths are compared, so the depth reached does not depend on the threads */
+    if( p_autoplay->node_budget != AUTOPLAY_NO_NODE_BUDGET &&
+        node_count + (uint64_t) p_autoplay->beam_count * p_root->search.placement_count > p_autoplay->node_budget ){
+      atomic_store_explicit( &p_autoplay->is_timed_out, true, memory_order_relaxed );
+      break;
+    }
+
+    next_piece = randomizer_peek_piece( &p_game->randomizer, d - 1 );
+    board_get_spawn_piece( p_game, next_piece.type, next_piece.rotation, &p_autoplay->piece );
+
+    /* Each thread starts with an even share of the beam, the threads done early steal from the others */
+    for( uint8_t k=0; k<context_count; k++ ){
+      atomic_store_explicit( &p_autoplay->workers[k].next_task, (uint32_t) k * p_autoplay->beam_count / context_count,
+                             memory_order_relaxed );
+      p_autoplay->workers[k].last_task = (uint32_t) ( k + 1 ) * p_autoplay->beam_count / context_count;
+    }
+
+    if( p_autoplay->worker_count > 0 ){
+      _run_pool( p_autoplay, true );
+    }
+    else{
+      _expand_tasks( p_autoplay, &p_autoplay->workers[0] );
+    }
+
+    /* A depth cut by the deadline is dropped, the boards of the last complete depth decide */
+    if( atomic_load_explicit( &p_autoplay->is_timed_out, memory_order_relaxed ) )
+      break;
+
+    node_count = p_root->search.placement_count;
+
+    for( uint8_t k=0; k<context_count; k++ ){
+      node_count += p_autoplay->workers[k].eval.node_count;
+    }
+
+    transposition_new_search( &p_autoplay->transposition );
+
+    /* The candidates are merged in the order of their parents, so the beam does not depend on the threads */
+    next_count = 0;
+
+    for( uint16_t b=0; b<p_autoplay->beam_count; b++ ){
+      for( uint16_t c=0; c<p_autoplay->candidate_counts[b]; c++ ){
+        _beam_offer( p_autoplay, p_autoplay->next_beam, &next_count, &p_autoplay->candidates[(size_t) b * width + c],
+                     p_autoplay->piece.type, &p_autoplay->beam_columns[p_autoplay->beam_layer][(size_t) b * col_size],
+                     p_autoplay->beam[b].hash );
+      }
+    }
+
+    /* Every board of the beam ends the game with this piece */
+    if( next_count == 0 )
+      break;
+
+    next_layer = p_autoplay->beam_layer ^ 1;
+
+    for( uint16_t i=0; i<next_count; i++ ){
+      _apply_placement( p_autoplay, p_autoplay->piece.type, &p_autoplay->next_beam[i].placement,
+                        &p_autoplay->beam_columns[p_autoplay->beam_layer][(size_t) p_autoplay->next_beam[i].parent_idx * col_size],
+                        &p_autoplay->beam_columns[next_layer][(size_t) i * col_size] );
+    }
+
+    p_nodes                = p_autoplay->beam;
+    p_autoplay->beam       = p_autoplay->next_beam;
+    p_autoplay->next_beam  = p_nodes;
+    p_autoplay->beam_count = next_count;
+    p_autoplay->beam_layer = next_layer;
+    *p_depth               = (uint8_t) ( d + 1 );
+  }
+
+  for( uint8_t k=0; k<context_count; k++ ){
+    p_autoplay->stats.node_count           += p_autoplay->workers[k].eval.node_count;
+    p_autoplay->workers[k].eval.node_count  = 0;
+  }
+
+  return p_autoplay->beam[0].root_idx;
+}
+
+
+static void _expand_tasks( AUTOPLAY_STRUCT_T *p_autoplay, AUTOPLAY_WORKER_T *p_worker ){
+  uint8_t context_count = p_autoplay->worker_count + 1;
+  uint64_t deadline_ns  = p_autoplay->deadline_ns;
+  AUTOPLAY_WORKER_T *p_owner = NULL;
+  uint32_t task = 0;
+
+  /* Own boards first, then the boards left to the next threads in turn */
+  for( uint8_t k=0; k<context_count; k++ ){
+    p_owner = &p_autoplay->workers[( p_worker->idx + k ) % context_count];
+
+    while( ( task = atomic_fetch_add_explicit( &p_owner->next_task, 1, memory_order_relaxed ) ) < p_owner->last_task ){
+      if( atomic_load_explicit( &p_autoplay->is_timed_out, memory_order_relaxed ) )
+        return;
+
+      if( deadline_ns != AUTOPLAY_NO_DEADLINE && platform_get_time_ns() >= deadline_ns ){
+        atomic_store_explicit( &p_autoplay->is_timed_out, true, memory_order_relaxed );
+        return;
+      }
+
+      _expand_node( p_autoplay, &p_worker->eval, (uint16_t) task );
+    }
+  }
+}
+
+
+static void _expand_node( AUTOPLAY_STRUCT_T *p_autoplay, AUTOPLAY_EVAL_T *p_eval, uint16_t beam_idx ){
+  const AUTOPLAY_NODE_T *p_parent = &p_autoplay->beam[beam_idx];
+  const PLACEMENT_SEARCH_T *p_search = &p_eval->search;
+  uint16_t width   = p_autoplay->config.beam_width;
+  AUTOPLAY_NODE_T *p_candidates = &p_autoplay->candidates[(size_t) beam_idx * width];
+  AUTOPLAY_NODE_T node;
+  uint16_t count   = 0;
+  uint8_t lines    = 0;
+  float score      = 0.0f;
+
+  placement_find_all_in_columns( &p_eval->search,
+                                 &p_autoplay->beam_columns[p_autoplay->beam_layer][(size_t) beam_idx * p_autoplay->col_size],
+                                 &p_autoplay->piece );
+  _init_move_features( p_autoplay, p_eval );
+  p_eval->node_count += p_search->placement_count;
+
+  for( uint32_t i=0; i<p_search->placement_count; i++ ){
+    score = _evaluate_placement( p_autoplay, p_eval, &p_search->placements[i], &lines );
+
+    if( score <= AUTOPLAY_SCORE_GAME_OVER )
+      continue;
+
+    /* The rows cleared on the way count at every depth, the shape of the board only at the last one */
+    node.value       = p_parent->line_reward + score;
+    node.line_reward = p_parent->line_reward + p_autoplay->weights.lines * (float) lines;
+    node.root_idx    = p_parent->root_idx;
+    node.parent_idx  = beam_idx;
+    node.placement   = p_search->placements[i];
+
+    _beam_insert( p_candidates, &count, width, &node );
+  }
+
+  p_autoplay->candidate_counts[beam_idx] = count;
+}
+
+
+static void _beam_insert( AUTOPLAY_NODE_T *p_nodes, uint16_t *p_count, uint16_t width, const AUTOPLAY_NODE_T *p_node ){
+  uint16_t pos = *p_count;
+
+  if( pos == width ){
+    if( p_node->value <= p_nodes[width - 1].value )
+      return;
+
+    pos = width - 1;
+  }
+  else{
+    (*p_count)++;
+  }
+
+  while( pos > 0 && p_nodes[pos - 1].value < p_node->value ){
+    p_nodes[pos] = p_nodes[pos - 1];
+    pos--;
+  }
+
+  p_nodes[pos] = *p_node;
+}
+
+
+static void _beam_offer( AUTOPLAY_STRUCT_T *p_autoplay, AUTOPLAY_NODE_T *p_nodes, uint16_t *p_count,
+                         const AUTOPLAY_NODE_T *p_node, uint8_t type, const board_word_t *p_from, uint64_t hash ){
+  AUTOPLAY_NODE_T node = *p_node;
+  float best           = 0.0f;
+
+  /* Only the boards that enter the beam are hashed, most candidates are dropped here */
+  if( *p_count == p_autoplay->config.beam_width && node.value <= p_nodes[*p_count - 1].value )
+    return;
+
+  node.hash = _placement_hash( p_autoplay, type, &node.placement, p_from, hash );
+
+  /* The first board of the highest value wins, as without the table. A full bucket only lets the duplicates
+     through */
+  if( transposition_probe( &p_autoplay->transposition, node.hash, &best ) ){
+    p_autoplay->stats.duplicate_count++;
+
+    if( best >= node.value )
+      return;
+
+    /* The board in the beam, if not dropped since, is reached again with a higher value */
+    for( uint16_t i=0; i<*p_count; i++ ){
+      if( p_nodes[i].hash == node.hash ){
+        memmove( &p_nodes[i], &p_nodes[i + 1], ( *p_count - i - 1 ) * sizeof( AUTOPLAY_NODE_T ) );
+        (*p_count)--;
+        break;
+      }
+    }
+  }
+
+  transposition_store( &p_autoplay->transposition, node.hash, node.value );
+  _beam_insert( p_nodes, p_count, p_autoplay->config.beam_width, &node );
+}
+
+
+static uint64_t _placement_hash( const AUTOPLAY_STRUCT_T *p_autoplay, uint8_t type, const PLACEMENT_T *p_placement,
+                                 const board_word_t *p_from, uint64_t hash ){
+  const PLACEMENT_SHAPE_T *p_shape = &p_autoplay->root.search.shapes[type][p_placement->rotation];
+  const uint64_t *p_keys           = p_autoplay->zobrist_keys;
+  board_word_t piece[PIECE_LARGEST_MATRIX_ORDER] = { 0 };
+  board_word_t full   = p_autoplay->playable_rows;
+  board_word_t cells  = 0;
+  int32_t row         = p_placement->position_row + p_shape->first_row;
+  int32_t col         = p_placement->position_col + p_shape->first_col;
+  int32_t last_col    = p_autoplay->col_size - 1;
+
+  for( uint8_t k=0; k<p_shape->cell_count; k++ ){
+    piece[p_shape->cell_col[k]] |= (board_word_t) 1u << ( row + p_shape->cell_row[k] );
+  }
+
+  for( int32_t c=1; c<last_col && full != 0; c++ ){
+    full &= ( c >= col && c < col + p_shape->width ) ? p_from[c] | piece[c - col] : p_from[c];
+  }
+
+  if( full == 0 ){
+    for( uint8_t k=0; k<p_shape->cell_count; k++ ){
+      hash ^= p_keys[(size_t) ( col + p_shape->cell_col[k] ) * p_autoplay->row_size + row + p_shape->cell_row[k]];
+    }
+
+    return hash;
+  }
+
+  /* Bit y of a column is row y of the board, as in the hash of the game board */
+  hash = 0;
+
+  for( int32_t c=1; c<last_col; c++ ){
+    cells = p_from[c];
+
+    if( c >= col && c < col + p_shape->width ){
+      cells |= piece[c - col];
+    }
+
+    cells = _remove_rows( cells & p_autoplay->playable_rows, full );
+
+    while( cells != 0 ){
+      hash  ^= p_keys[(size_t) c * p_autoplay->row_size + __builtin_ctzll( cells )];
+      cells &= cells - 1;
+    }
+  }
+
+  return hash;
+}
+
+
+static void _apply_placement( const AUTOPLAY_STRUCT_T *p_autoplay, uint8_t type, const PLACEMENT_T *p_placement,
+                              const board_word_t *p_from, board_word_t *p_to ){
+  const PLACEMENT_SHAPE_T *p_shape = &p_autoplay->root.search.shapes[type][p_placement->rotation];
+  int32_t row       = p_placement->position_row + p_shape->first_row;
+  int32_t col       = p_placement->position_col + p_shape->first_col;
+  uint16_t last_col = p_autoplay->col_size - 1;
+  board_word_t full = p_autoplay->playable_rows;
+
+  memcpy( p_to, p_from, p_autoplay->col_size * sizeof( board_word_t ) );
+
+  for( uint8_t k=0; k<p_shape->cell_count; k++ ){
+    p_to[col + p_shape->cell_col[k]] |= (board_word_t) 1u << ( row + p_shape->cell_row[k] );
+  }
+
+  for( uint16_t c=1; c<last_col; c++ ){
+    full &= p_to[c];
+  }
+
+  if( full == 0 )
+    return;
+
+  /* The border columns and the rows out of the board keep their cells */
+  for( uint16_t c=1; c<last_col; c++ ){
+    p_to[c] = ( p_to[c] & ~p_autoplay->playable_rows ) | _remove_rows( p_to[c] & p_autoplay->playable_rows, full );
+  }
+}
+
+
+static void _init_move_features( const AUTOPLAY_STRUCT_T *p_autoplay, AUTOPLAY_EVAL_T *p_eval ){
+  const board_word_t *p_columns = p_eval->search.columns;
+  uint16_t last_col             = p_autoplay->col_size - 1;
+  uint8_t wall_height           = (uint8_t) ( p_autoplay->row_size - 1 );
+  board_word_t cells            = 0;
+
+  p_eval->aggregate_height = 0;
+  p_eval->hole_count       = 0;
+  p_eval->bumpiness        = 0;
+  p_eval->well_depth       = 0;
+
+  p_eval->heights[0]        = wall_height;
+  p_eval->heights[last_col] = wall_height;
+  p_eval->holes[0]          = 0;
+  p_eval->holes[last_col]   = 0;
+  p_eval->wells[0]          = 0;
+  p_eval->wells[last_col]   = 0;
+
+  for( uint16_t c=1; c<last_col; c++ ){
+    cells = p_columns[c] & p_autoplay->playable_rows;
+
+    p_eval->heights[c]        = _column_height( p_autoplay, cells );
+    p_eval->holes[c]          = _column_holes( p_autoplay, cells );
+    p_eval->aggregate_height += p_eval->heights[c];
+    p_eval->hole_count       += p_eval->holes[c];
+  }
+
+  for( uint16_t c=1; c<last_col; c++ ){
+    p_eval->wells[c]    = _well_depth( p_eval->heights[c - 1], p_eval->heights[c], p_eval->heights[c + 1] );
+    p_eval->well_depth += p_eval->wells[c];
+
+    if( c + 1 < last_col ){
+      p_eval->bumpiness += _height_diff( p_eval->heights[c], p_eval->heights[c + 1] );
+    }
+  }
+
+  /* The border columns are full, they never keep a row from being complete */
+  p_eval->and_prefix[0]        = ~(board_word_t) 0;
+  p_eval->and_suffix[last_col] = ~(board_word_t) 0;
+
+  for( uint16_t c=1; c<=last_col; c++ ){
+    p_eval->and_prefix[c] = p_eval->and_prefix[c - 1] & p_columns[c];
+  }
+
+  for( uint16_t c=last_col; c>0; c-- ){
+    p_eval->and_suffix[c - 1] = p_eval->and_suffix[c] & p_columns[c - 1];
+  }
+}
+
+
+static void _evaluate_chunks( AUTOPLAY_STRUCT_T *p_autoplay ){
+  AUTOPLAY_EVAL_T *p_root            = &p_autoplay->root;
+  const PLACEMENT_SEARCH_T *p_search = &p_root->search;
+  uint32_t count = p_search->placement_count;
+  uint32_t first = 0;
+  uint32_t last  = 0;
+
+  while( ( first = atomic_fetch_add_explicit( &p_autoplay->next_placement, AUTOPLAY_CHUNK_PLACEMENTS,
+                                              memory_order_relaxed ) ) < count ){
+    last = ( first + AUTOPLAY_CHUNK_PLACEMENTS < count ) ? first + AUTOPLAY_CHUNK_PLACEMENTS : count;
+
+    for( uint32_t i=first; i<last; i++ ){
+      p_root->scores[i] = _evaluate_placement( p_autoplay, p_root, &p_search->placements[i], &p_root->lines[i] );
+    }
+  }
+}
+
+
+static float _evaluate_placement( const AUTOPLAY_STRUCT_T *p_autoplay, const AUTOPLAY_EVAL_T *p_eval,
+                                  const PLACEMENT_T *p_placement, uint8_t *p_lines ){
+  const PLACEMENT_SEARCH_T *p_search = &p_eval->search;
+  const PLACEMENT_SHAPE_T *p_shape   = &p_search->shapes[p_search->type][p_placement->rotation];
+  const board_word_t *p_columns      = p_search->columns;
+  const AUTOPLAY_WEIGHTS_T *p_weights = &p_autoplay->weights;
+  board_word_t piece[PIECE_LARGEST_MATRIX_ORDER] = { 0 };
+  board_word_t full   = 0;
+  board_word_t cells  = 0;
+  int32_t row         = p_placement->position_row + p_shape->first_row;
+  int32_t col         = p_placement->position_col + p_shape->first_col;
+  int32_t last_col    = p_autoplay->col_size - 1;
+  int32_t aggregate_height = p_eval->aggregate_height;
+  int32_t hole_count  = p_eval->hole_count;
+  int32_t bumpiness   = p_eval->bumpiness;
+  int32_t well_depth  = p_eval->well_depth;
+  int32_t line_count  = 0;
+
+  *p_lines = 0;
+
+  /* A cell left on the top row ends the game, whatever rows the piece clears */
+  if( row <= 0 )
+    return AUTOPLAY_SCORE_GAME_OVER;
+
+  for( uint8_t k=0; k<p_shape->cell_count; k++ ){
+    piece[p_shape->cell_col[k]] |= (board_word_t) 1u << ( row + p_shape->cell_row[k] );
+  }
+
+  full = p_eval->and_prefix[col - 1] & p_eval->and_suffix[col + p_shape->width];
+
+  for( uint8_t j=0; j<p_shape->width; j++ ){
+    full &= p_columns[col + j] | piece[j];
+  }
+
+  full &= p_autoplay->playable_rows;
+
+  if( full == 0 ){
+    /* Only the columns of the piece change, and the bumpiness and wells of their neighbours:
+       window[k] is the height of column col - 2 + k */
+    uint8_t window[PIECE_LARGEST_MATRIX_ORDER + 4];
+    int32_t first = ( col - 2 > 0 ) ? col - 2 : 0;
+    int32_t last  = ( col + p_shape->width + 1 < last_col ) ? col + p_shape->width + 1 : last_col;
+
+    for( int32_t c=first; c<=last; c++ ){
+      window[c - col + 2] = p_eval->heights[c];
+    }
+
+    for( uint8_t j=0; j<p_shape->width; j++ ){
+      cells = ( p_columns[col + j] | piece[j] ) & p_autoplay->playable_rows;
+
+      window[j + 2]     = _column_height( p_autoplay, cells );
+      aggregate_height += window[j + 2] - p_eval->heights[col + j];
+      hole_count       += _column_holes( p_autoplay, cells ) - p_eval->holes[col + j];
+    }
+
+    first = ( col - 1 > 1 ) ? col - 1 : 1;
+    last  = ( col + p_shape->width < last_col - 1 ) ? col + p_shape->width : last_col - 1;
+
+    for( int32_t c=first; c<=last; c++ ){
+      well_depth += _well_depth( window[c - col + 1], window[c - col + 2], window[c - col + 3] ) - p_eval->wells[c];
+
+      if( c < last ){
+        bumpiness += _height_diff( window[c - col + 2], window[c - col + 3] ) -
+                     _height_diff( p_eval->heights[c], p_eval->heights[c + 1] );
+      }
+    }
+  }
+  else{
+    /* The rows cleared move every column, the whole board is measured again in one pass */
+    uint8_t wall_height = (uint8_t) ( p_autoplay->row_size - 1 );
+    uint8_t left        = wall_height;
+    uint8_t middle      = 0;
+    uint8_t height      = 0;
+
+    line_count       = __builtin_popcountll( full );
+    aggregate_height = 0;
+    hole_count       = 0;
+    bumpiness        = 0;
+    well_depth       = 0;
+
+    for( int32_t c=1; c<last_col; c++ ){
+      cells = p_columns[c];
+
+      if( c >= col && c < col + p_shape->width ){
+        cells |= piece[c - col];
+      }
+
+      cells             = _remove_rows( cells & p_autoplay->playable_rows, full );
+      height            = _column_height( p_autoplay, cells );
+      aggregate_height += height;
+      hole_count       += _column_holes( p_autoplay, cells );
+
+      if( c > 1 ){
+        bumpiness  += _height_diff( middle, height );
+        well_depth += _well_depth( left, middle, height );
+        left        = middle;
+      }
+
+      middle = height;
+    }
+
+    well_depth += _well_depth( left, middle, wall_height );
+    *p_lines    = (uint8_t) line_count;
+  }
+
+  return p_weights->aggregate_height * (float) aggregate_height +
+         p_weights->holes            * (float) hole_count +
+         p_weights->bumpiness        * (float) bumpiness +
+         p_weights->wells            * (float) well_depth +
+         p_weights->lines            * (float) line_count;
+}
+
+
+static inline board_word_t _remove_rows( board_word_t cells, board_word_t rows ){
+  board_word_t above = 0;
+  uint8_t row        = 0;
+
+  /* From the top row down, so the rows still to remove do not move */
+  while( rows != 0 ){
+    row   = (uint8_t) __builtin_ctzll( rows );
+    above = ( (board_word_t) 1u << row ) - 1;
+    cells = ( cells & ~( above | ( (board_word_t) 1u << row ) ) ) | ( ( cells & above ) << 1 );
+    rows &= rows - 1;
+  }
+
+  return cells;
+}
+
+
+static inline uint8_t _column_height( const AUTOPLAY_STRUCT_T *p_autoplay, board_word_t cells ){
+  if( cells == 0 )
+    return 0;
+
+  return (uint8_t) ( p_autoplay->row_size - 1 - __builtin_ctzll( cells ) );
+}
+
+
+static inline uint8_t _column_holes( const AUTOPLAY_STRUCT_T *p_autoplay, board_word_t cells ){
+  if( cells == 0 )
+    return 0;
+
+  return (uint8_t) __builtin_popcountll( p_autoplay->playable_rows & ~cells & ( ~(board_word_t) 0 << __builtin_ctzll( cells ) ) );
+}
+
+
+static inline uint8_t _well_depth( uint8_t left, uint8_t height, uint8_t right ){
+  uint8_t lower = ( left < right ) ? left : right;
+
+  return ( lower > height ) ? (uint8_t) ( lower - height ) : 0;
+}
+
+
+static inline uint8_t _height_diff( uint8_t a, uint8_t b ){
+  return ( a > b ) ? (uint8_t) ( a - b ) : (uint8_t) ( b - a );
+}
@@ -0,0 +1,352 @@
+/*
+ *  autoplay.h
+ *
+ *  Created on: 17-Oct-2026
+ *      Author: lucas-noce
+ */
+
+#ifndef _AUTOPLAY_H_
+#define _AUTOPLAY_H_
+
+
+/* ==========================================================================================================
+ * Includes
+ */
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <stdatomic.h>
+
+#include "main.h"
+#include "game_config.h"
+#include "board.h"
+#include "placement.h"
+#include "transposition.h"
+#include "platform.h"
+
+
+/* ==========================================================================================================
+ * Definitions
+ */
+
+#define AUTOPLAY_MAX_WORKERS         15
+#define AUTOPLAY_POOL_MIN_COL_SIZE   48   // a single piece on a narrower board is evaluated faster than the pool wakes up
+#define AUTOPLAY_CHUNK_PLACEMENTS    32   // placements a worker takes at once
+
+#define AUTOPLAY_MAX_DEPTH           ( 1 + RANDOMIZER_PREVIEW_SIZE )   // the current piece, then the known ones
+#define AUTOPLAY_MAX_BEAM_WIDTH      256
+#define AUTOPLAY_DEFAULT_DEPTH       3
+#define AUTOPLAY_DEFAULT_BEAM_WIDTH  16
+#define AUTOPLAY_NO_DEADLINE         0
+#define AUTOPLAY_NO_NODE_BUDGET      0
+#define AUTOPLAY_BUDGET_NODES_PER_MS 1000   // placements one thread of a slow machine evaluates in a millisecond
+
+#define AUTOPLAY_MAX_TRANSPOSITION_BUCKETS  ( 1u << 15 )   // 2 MiB, the candidates of the widest beam
+
+#define AUTOPLAY_SCORE_GAME_OVER    ( -1e30f )
+
+
+/* ==========================================================================================================
+ * Typedefs
+ */
+
+/*!
+  @brief        Weights of the board features, the placement with the highest weighted sum is played.
+
+  @param        aggregate_height: sum of the column heights.
+  @param        holes: empty cells with a fixed cell above them in the same column.
+  @param        bumpiness: sum of the height differences between neighbouring columns.
+  @param        wells: sum of the depths of the columns lower than both neighbours (the walls count as full).
+  @param        lines: rows cleared by the placement.
+*/
+typedef struct AUTOPLAY_WEIGHTS_TAG{
+  float aggregate_height;
+  float holes;
+  float bumpiness;
+  float wells;
+  float lines;
+} AUTOPLAY_WEIGHTS_T;
+
+/*!
+  @brief        How far and how wide the automatic player looks ahead.
+
+  @param        max_workers: most threads the search pool may start (0 searches on the calling thread only).
+  @param        depth: pieces placed by the search, the current one and then the preview (1 to AUTOPLAY_MAX_DEPTH,
+                1 plays the best placement of the current piece alone).
+  @param        beam_width: boards kept after each piece (1 to AUTOPLAY_MAX_BEAM_WIDTH).
+*/
+typedef struct AUTOPLAY_CONFIG_TAG{
+  uint8_t  max_workers;
+  uint8_t  depth;
+  uint16_t beam_width;
+} AUTOPLAY_CONFIG_T;
+
+/*!
+  @brief        Counters of the moves chosen by the automatic player.
+
+  @param        move_count: moves chosen.
+  @param        node_count: placements evaluated, at every depth.
+  @param        depth_sum: sum of the depth completed by each move.
+  @param        timeout_count: moves whose search was cut short by the deadline or the node budget.
+  @param        duplicate_count: boards left out of the beam because another placement order reached them.
+  @param        elapsed_ns: time spent choosing.
+*/
+typedef struct AUTOPLAY_STATS_TAG{
+  uint64_t move_count;
+  uint64_t node_count;
+  uint64_t depth_sum;
+  uint64_t timeout_count;
+  uint64_t duplicate_count;
+  uint64_t elapsed_ns;
+} AUTOPLAY_STATS_T;
+
+/*!
+  @brief        Placement search and features of one board, the root board or a board of the beam.
+
+  @param        search: finds the placements of a piece on the board.
+  @param        scores: score of each placement of the last search (only filled for the root board).
+  @param        lines: rows cleared by each placement of the last search (only filled for the root board).
+  @param        heights, holes, wells: features of each column of the board before the move.
+  @param        and_prefix, and_suffix: entry c is the AND of the playable columns up to c (from c on), so the rows
+                full outside the columns of a piece are found in two loads.
+  @param        aggregate_height, hole_count, bumpiness, well_depth: sums of the features of the board before the
+                move.
+  @param        node_count: placements evaluated with this context during the current move.
+  @param        p_storage: single cache-aligned allocation that backs all the planes above.
+  @param        storage_size: size in bytes of `p_storage`.
+*/
+typedef struct AUTOPLAY_EVAL_TAG{
+  PLACEMENT_SEARCH_T search;
+  float              *scores;
+  uint8_t            *lines;
+  uint8_t            *heights;
+  uint8_t            *holes;
+  uint8_t            *wells;
+  board_word_t       *and_prefix;
+  board_word_t       *and_suffix;
+  int32_t            aggregate_height;
+  int32_t            hole_count;
+  int32_t            bumpiness;
+  int32_t            well_depth;
+  uint64_t           node_count;
+  void               *p_storage;
+  size_t             storage_size;
+} AUTOPLAY_EVAL_T;
+
+/*!
+  @brief        A board of the beam, reached by placing the pieces up to the current depth.
+
+  @param        value: score of the last placement plus the line rewards of the placements before it.
+  @param        line_reward: weighted rows cleared by every placement up to this board.
+  @param        root_idx: placement of the current piece this board comes from.
+  @param        parent_idx: board of the previous depth this board comes from.
+  @param        placement: placement of the last piece.
+  @param        hash: Zobrist hash of the board (see board_zobrist_key).
+*/
+typedef struct AUTOPLAY_NODE_TAG{
+  float       value;
+  float       line_reward;
+  uint32_t    root_idx;
+  uint16_t    parent_idx;
+  PLACEMENT_T placement;
+  uint64_t    hash;
+} AUTOPLAY_NODE_T;
+
+/*!
+  @brief        One thread of the search pool. Entry 0 of the pool is the calling thread, it has no thread of its own.
+
+  @param        next_task, last_task: the boards of the beam left to expand by this thread, taken from the front by
+                the thread itself and by the threads that ran out of their own.
+  @param        eval: the search context of the thread.
+  @param        thread: the worker thread.
+  @param        start_event: set when a move is ready to be searched (or the pool stops).
+  @param        done_event: set by the worker once there is nothing left to search.
+  @param        p_autoplay: the player that owns the pool.
+  @param        idx: entry of the worker in the pool.
+*/
+typedef struct AUTOPLAY_WORKER_TAG{
+  _Alignas( GAME_CONFIG_CACHE_LINE_SIZE ) atomic_uint next_task;
+  uint32_t                   last_task;
+  AUTOPLAY_EVAL_T            eval;
+  PLATFORM_THREAD_T          thread;
+  PLATFORM_EVENT_T           start_event;
+  PLATFORM_EVENT_T           done_event;
+  struct AUTOPLAY_STRUCT_TAG *p_autoplay;
+  uint8_t                    idx;
+} AUTOPLAY_WORKER_T;
+
+/*!
+  @brief        Workspace of the automatic player, sized for one board size.
+
+  The features of a placement are computed on the columns of the board (see board_get_column_cells): the piece is
+  ORed into the few columns it covers, and only the columns next to it are compared to the board before the move,
+  unless the placement clears rows.
+
+  With a depth above 1 the player runs a beam search over the pieces of the preview: the best `beam_width` boards
+  of each depth are expanded with the next piece, and the placement of the current piece that leads to the best
+  board of the deepest depth completed before the deadline is played. The same board is often reached by placing
+  the pieces in another order or at other columns: the transposition table keeps the best value of each board of a
+  depth, and only that one enters the beam.
+
+  @param        config: depth and width of the search, and size of the pool.
+  @param        weights: the weights of the features.
+  @param        row_size, col_size: size of the boards played.
+  @param        playable_rows: bit y is set for every row above the bottom border.
+  @param        root: search and features of the board of the game.
+  @param        path: commands of the path to the chosen placement.
+  @param        beam, next_beam: the boards of the current depth and of the depth being searched.
+  @param        beam_count: number of entries in `beam`.
+  @param        candidates: beam_width entries per board of `beam`, the best children of that board.
+  @param        candidate_counts: number of children kept for each board of `beam`.
+  @param        beam_columns: two layers of beam_width boards of col_size words, the boards of `beam` and of
+                `next_beam`.
+  @param        beam_layer: layer of `beam_columns` that holds the boards of `beam`.
+  @param        piece: the piece placed on the boards of `beam`, at its starting position.
+  @param        zobrist_keys: key of each cell of the board (see board_zobrist_key), row_size entries per column.
+  @param        transposition: best value of each board of the depth being searched (only allocated for a depth
+                above 1).
+  @param        is_expanding: the pool expands the beam instead of scoring the placements of the root board.
+  @param        deadline_ns: time after which the depth being searched is dropped, AUTOPLAY_NO_DEADLINE if none.
+  @param        node_budget: placements the move may evaluate, a depth that would not fit is not searched
+                (AUTOPLAY_NO_NODE_BUDGET if none).
+  @param        stats: counters of the moves chosen.
+  @param        workers: the search pool, entry 0 is the calling thread (threads only started for a depth above 1,
+                or for boards of AUTOPLAY_POOL_MIN_COL_SIZE columns or more).
+  @param        worker_count: number of threads in `workers`, entry 0 excluded.
+  @param        next_placement: first placement of the root board not taken by a thread yet.
+  @param        is_timed_out: the deadline passed while the beam was expanded.
+  @param        is_stopping: tells the workers to return.
+  @param        p_storage: single cache-aligned allocation that backs the path, the beam and the keys.
+  @param        storage_size: size in bytes of `p_storage`.
+
+  @warning      The workers keep a pointer to the workspace, it must not move once initialized.
+*/
+typedef struct AUTOPLAY_STRUCT_TAG{
+  AUTOPLAY_CONFIG_T     config;
+  AUTOPLAY_WEIGHTS_T    weights;
+  uint16_t              row_size;
+  uint16_t              col_size;
+  board_word_t          playable_rows;
+  AUTOPLAY_EVAL_T       root;
+  uint8_t               *path;
+  AUTOPLAY_NODE_T       *beam;
+  AUTOPLAY_NODE_T       *next_beam;
+  uint16_t              beam_count;
+  AUTOPLAY_NODE_T       *candidates;
+  uint16_t              *candidate_counts;
+  board_word_t          *beam_columns[2];
+  uint8_t               beam_layer;
+  PIECE_STRUCT_T        piece;
+  uint64_t              *zobrist_keys;
+  TRANSPOSITION_TABLE_T transposition;
+  bool                  is_expanding;
+  uint64_t              deadline_ns;
+  uint64_t              node_budget;
+  AUTOPLAY_STATS_T      stats;
+  AUTOPLAY_WORKER_T     workers[AUTOPLAY_MAX_WORKERS + 1];
+  uint8_t               worker_count;
+  atomic_uint           next_placement;
+  atomic_bool           is_timed_out;
+  atomic_bool           is_stopping;
+  void                  *p_storage;
+  size_t                storage_size;
+} AUTOPLAY_STRUCT_T;
+
+
+/* ==========================================================================================================
+ * Global Functions
+ */
+
+/*!
+  @brief        Allocates the workspace of the automatic player and starts its evaluation pool.
+
+  @param[out]   p_autoplay: pointer to the workspace.
+  @param[in]    row_size: number of rows of the boards, bottom border included (up to PLACEMENT_MAX_ROW_SIZE).
+  @param[in]    col_size: number of columns of the boards, borders included.
+  @param[in]    p_config: depth and width of the search, and size of the pool (out of range values are clamped).
+
+  @returns      One of the possible TETRIS_RET_x macro values (defined in main.h).
+*/
+int8_t autoplay_init( AUTOPLAY_STRUCT_T *p_autoplay, uint16_t row_size, uint16_t col_size,
+                      const AUTOPLAY_CONFIG_T *p_config );
+
+/*!
+  @brief        Stops the evaluation pool and releases the workspace of the automatic player.
+
+  @param[in]    p_autoplay: pointer to the workspace.
+
+  @returns      void
+*/
+void autoplay_deinit( AUTOPLAY_STRUCT_T *p_autoplay );
+
+/*!
+  @brief        Replaces the default weights of the features.
+
+  @param[in]    p_autoplay: pointer to the workspace.
+  @param[in]    p_weights: the new weights.
+
+  @returns      void
+*/
+void autoplay_set_weights( AUTOPLAY_STRUCT_T *p_autoplay, const AUTOPLAY_WEIGHTS_T *p_weights );
+
+/*!
+  @brief        Gets the weights of the features a workspace starts with.
+
+  @param[out]   p_weights: the default weights.
+
+  @returns      void
+*/
+void autoplay_get_default_weights( AUTOPLAY_WEIGHTS_T *p_weights );
+
+/*!
+  @brief        Scores every placement of the current piece, looking ahead at the preview up to the configured depth,
+                and gets the commands that bring the piece to the best one.
+
+  @param[in]    p_autoplay: pointer to the workspace, initialized with the size of the board.
+  @param[in]    p_game: pointer to the game, not changed.
+  @param[in]    deadline_ns: time from platform_get_time_ns after which the search answers with the deepest depth
+                completed, AUTOPLAY_NO_DEADLINE to always complete the configured depth (the current piece is
+                always searched in full).
+  @param[in]    node_budget: placements the search may evaluate, AUTOPLAY_NO_NODE_BUDGET if none. The next depth
+                is only searched if it fits, assuming each board of the beam has as many placements as the board of
+                the game: unlike the deadline, the move does not depend on the machine or on the number of threads.
+  @param[out]   pp_commands: the commands, from GAME_COMMANDS_E (kept in the workspace until the next call).
+  @param[out]   p_count: number of commands.
+
+  @returns      TETRIS_RET_OK, TETRIS_RET_ERR_NO_PIECE if there is no current piece, or TETRIS_RET_ERR if the
+                piece has no placement.
+*/
+int8_t autoplay_choose( AUTOPLAY_STRUCT_T *p_autoplay, tetris_game_t *p_game, uint64_t deadline_ns,
+                        uint64_t node_budget, const uint8_t **pp_commands, uint16_t *p_count );
+
+/*!
+  @brief        Gets the deadline of a move that starts now: half the gravity period of the game, so the path is
+                applied before the piece falls another row.
+
+  @param[in]    p_game: pointer to the game.
+
+  @returns      The deadline, from platform_get_time_ns.
+*/
+uint64_t autoplay_get_deadline_ns( const tetris_game_t *p_game );
+
+/*!
+  @brief        Gets the node budget of a move: the placements a slow machine evaluates in the same half gravity
+                period as autoplay_get_deadline_ns, so a faster game leaves less time to look ahead on any machine.
+
+  @param[in]    p_game: pointer to the game.
+
+  @returns      The node budget.
+*/
+uint64_t autoplay_get_node_budget( const tetris_game_t *p_game );
+
+/*!
+  @brief        Prints the search rate and the depth reached by the moves counted, on stderr.
+
+  @param[in]    p_stats: the counters.
+  @param[in]    depth: the configured depth.
+
+  @returns      void
+*/
+void autoplay_stats_print( const AUTOPLAY_STATS_T *p_stats, uint8_t depth );
+
+#endif /* _AUTOPLAY_H_ */
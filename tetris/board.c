@@ -13,194 +13,343 @@
 #include <stdio.h>
 #include <stdint.h>
 #include <stdbool.h>
+#include <string.h>
 
 #include "main.h"
 #include "game_config.h"
 #include "score.h"
 #include "pieces.h"
 #include "board.h"
+#include "game.h"
 
 
 /* ==========================================================================================================
  * Definitions
  */
 
-/*
-  Board is a rectangle matrix of sizes BOARD_PLAYABLE_ROW_SIZE x BOARD_PLAYABLE_COL_SIZE with a U-shaped border, as follows:
-
-  3 0 0 ... 0 3
-  3 0 0 ... 0 3
-  3 0 0 ... 0 3
-  : : :     : :
-  3 0 0 ... 0 3
-  3 3 3 ... 3 3
-*/
-#define BOARD_PLAYABLE_ROW_SIZE   20
-#define BOARD_PLAYABLE_COL_SIZE   15
+#define BOARD_H_DISPLACEMENT_RIGHT  ( (int8_t)  1 )
+#define BOARD_H_DISPLACEMENT_LEFT   ( (int8_t) -1 )
 
-#define BOARD_PLAYABLE_OFFSET     PIECE_LARGEST_MATRIX_ORDER
-#define BOARD_PLAYABLE_START_ROW  BOARD_PLAYABLE_OFFSET
-#define BOARD_PLAYABLE_START_COL  BOARD_PLAYABLE_OFFSET
-#define BOARD_PLAYABLE_END_ROW    BOARD_PLAYABLE_OFFSET + BOARD_PLAYABLE_ROW_SIZE
-#define BOARD_PLAYABLE_END_COL    BOARD_PLAYABLE_OFFSET + BOARD_PLAYABLE_COL_SIZE
+#define BOARD_HASH_FNV_OFFSET       0xCBF29CE484222325ull
+#define BOARD_HASH_FNV_PRIME        0x00000100000001B3ull
 
-// #define BOARD_ROW_SIZE            ( BOARD_PLAYABLE_COL_SIZE + ( 2 * BOARD_PLAYABLE_OFFSET ) )
-// #define BOARD_COL_SIZE            ( BOARD_PLAYABLE_COL_SIZE + ( 2 * BOARD_PLAYABLE_OFFSET ) )
-#define BOARD_ROW_SIZE            BOARD_PLAYABLE_ROW_SIZE
-#define BOARD_COL_SIZE            BOARD_PLAYABLE_COL_SIZE
+#define BOARD_ZOBRIST_CELL_SEED     0x6A09E667F3BCC909ull
+#define BOARD_ZOBRIST_PIECE_SEED    0xBB67AE8584CAA73Bull
 
-#define BOARD_REGION_CENTER_COL   6
-#define BOARD_REGION_BORDER_VALUE 3
+#define BOARD_WORDS_PER_CACHE_LINE  ( GAME_CONFIG_CACHE_LINE_SIZE / sizeof( board_word_t ) )
+#define BOARD_DIRTY_ROW_BITS        64
 
-#define BOARD_H_DISPLACEMENT_RIGHT  ( (int8_t)  1 )
-#define BOARD_H_DISPLACEMENT_LEFT   ( (int8_t) -1 )
+#define BOARD_ROUND_UP( value, multiple )   ( ( ( (value) + (multiple) - 1 ) / (multiple) ) * (multiple) )
 
-#define GAME_PRINT_COLOR_MAGENTA "\033[1;35m"
-#define GAME_PRINT_COLOR_RED     "\033[1;31m"
-#define GAME_PRINT_COLOR_YELLOW  "\033[1;33m"
-#define GAME_PRINT_COLOR_GREEN   "\033[1;32m"
-#define GAME_PRINT_COLOR_CYAN    "\033[1;36m"
-#define GAME_PRINT_COLOR_BLUE    "\033[1;34m"
-#define GAME_PRINT_COLOR_RESET   "\033[0m"
+#define BOARD_ROW_WORDS( p_board, row )     ( &(p_board)->rows[ (size_t) (row) * (p_board)->row_stride ] )
+#define BOARD_ROW_COLORS( p_board, row )    ( &(p_board)->color[ (size_t) (row) * (p_board)->color_stride ] )
+#define BOARD_CELL_IS_SET( p_board, row, col ) \
+  ( ( BOARD_ROW_WORDS( p_board, row )[ (col) / BOARD_WORD_BITS ] >> ( (col) % BOARD_WORD_BITS ) ) & 1u )
+
+#define BOARD_PLAYABLE_CELLS( p_board )     ( (p_board)->col_size - 2 )
+#define BOARD_WORDS_PER_ROW( p_board )      ( ( (p_board)->col_size + BOARD_WORD_BITS - 1 ) / BOARD_WORD_BITS )
+#define BOARD_CENTER_COL( p_board )         ( ( (p_board)->col_size / 2 ) - 1 )
 
 
 /* ==========================================================================================================
  * Static Typedefs
  */
 
-typedef struct BOARD_AREA_TAG{
-  uint8_t start_row;
-  uint8_t start_col;
-  uint8_t end_row;
-  uint8_t end_col;
-} BOARD_AREA_T;
+/*!
+  @brief        Indicates what a piece overlaps when tested against the board at a given position.
+*/
+typedef enum{
+  BOARD_HIT_NONE = 0,
+  BOARD_HIT_BORDER,
+  BOARD_HIT_OBJECT,
+} BOARD_HITS_E;
+
+/*!
+  @brief        Fields of the board saved ahead of its storage by board_save_state (the plane pointers are not saved,
+                they are rebuilt from the storage of the board the state is loaded into).
+
+  @param        row_size, col_size: size of the board, the state only loads into a board of the same size.
+  @param        storage_size: number of bytes of the storage that follows.
+  @param        (others): same as in BOARD_STRUCT_T.
+*/
+typedef struct BOARD_STATE_HEADER_TAG{
+  uint16_t       row_size;
+  uint16_t       col_size;
+  uint32_t       cell_count;
+  int16_t        last_fixed_first_row;
+  int16_t        last_fixed_last_row;
+  uint32_t       piece_count;
+  PIECE_STRUCT_T current_piece;
+  bool           has_current_piece;
+  uint64_t       storage_size;
+} BOARD_STATE_HEADER_T;
 
 
 /* ==========================================================================================================
- * Static variables
+ * Static Function Prototypes
  */
 
-/* Board start on top left corner */
-static board_region_t board[BOARD_ROW_SIZE][BOARD_COL_SIZE]       = { 0 };
-static board_region_t board_color[BOARD_ROW_SIZE][BOARD_COL_SIZE] = { 0 };
+/*!
+  @brief        Allocates the storage of the board planes, or reuses the current one if the size did not change.
 
-static PIECE_STRUCT_T current_piece;
-static PIECE_STRUCT_T *p_current_piece;
+  @param[in]    p_board: pointer to the board.
+  @param[in]    row_size: number of rows, bottom border included.
+  @param[in]    col_size: number of columns, borders included.
 
-static uint32_t piece_count = 0;;
+  @returns      One of the possible TETRIS_RET_x macro values (defined in main.h).
+*/
+static int8_t _alloc_board_storage( BOARD_STRUCT_T *p_board, uint16_t row_size, uint16_t col_size );
 
+/*!
+  @brief        Clears consecutive rows of the board, leaving only the left and right borders.
 
-/* ==========================================================================================================
- * Static Function Prototypes
- */
+  @param[in]    p_board: pointer to the board.
+  @param[in]    first_row: first row to be cleared.
+  @param[in]    row_count: number of rows to be cleared.
+
+  @returns      void
+*/
+static void _clear_board_rows( BOARD_STRUCT_T *p_board, uint16_t first_row, uint16_t row_count );
+
+/*!
+  @brief        Clears the entire board, leaving only the U-shaped border.
+
+  @param[in]    p_board: pointer to the board.
+
+  @returns      void
+*/
+static void _clear_board_entirely( BOARD_STRUCT_T *p_board );
 
 /*!
-  @brief        Clears a portion of the board, specified by the BOARD_AREA_T parameter.
+  @brief        Writes the current piece into the board rows and color matrix, updating the occupancy counters.
 
-  @param[in]    p_area: pointer to the area to be cleared.
+  @param[in]    p_board: pointer to the board.
 
   @returns      void
 */
-static void _clear_board_area( BOARD_AREA_T *p_area );
+static void _set_current_piece_value_to_board( BOARD_STRUCT_T *p_board );
+
+/*!
+  @brief        Removes every complete row in a range at once, moving the rows above them down in a single pass.
+
+  @param[in]    p_board: pointer to the board.
+  @param[in]    first_row: first row that may be complete.
+  @param[in]    last_row: last row that may be complete.
+
+  @returns      The number of rows removed.
+*/
+static uint8_t _clear_complete_rows( BOARD_STRUCT_T *p_board, int16_t first_row, int16_t last_row );
 
 /*!
-  @brief        Clears the entire board, populating the matrix with zeros.
+  @brief        Moves a block of consecutive rows, in the occupancy, color and counter planes.
 
-  @param        none
+  @param[in]    p_board: pointer to the board.
+  @param[in]    src_row: first row of the block.
+  @param[in]    dst_row: row where the first row of the block is moved to.
+  @param[in]    row_count: number of rows in the block.
 
   @returns      void
 */
-static void _clear_board_entirely( void );
+static void _move_board_rows( BOARD_STRUCT_T *p_board, uint16_t src_row, uint16_t dst_row, uint16_t row_count );
 
 /*!
-  @brief        Clears a portion of the board, specified by the piece position.
+  @brief        Flags consecutive rows as changed since the last snapshot.
 
-  @param        none
+  @param[in]    p_board: pointer to the board.
+  @param[in]    first_row: first row that changed.
+  @param[in]    row_count: number of rows that changed.
 
   @returns      void
 */
-static void _remove_current_piece_from_board( void );
+static void _mark_dirty_rows( BOARD_STRUCT_T *p_board, uint16_t first_row, uint16_t row_count );
+
+/*!
+  @brief        Checks if a snapshot was taken from a board of the same size, which a snapshot can hold.
+
+  @param[in]    p_board: pointer to the board.
+  @param[in]    p_snapshot: the snapshot.
+
+  @returns      true if the snapshot can be restored to the board, false otherwise.
+*/
+static bool _is_snapshot_of_board( BOARD_STRUCT_T *p_board, const BOARD_SNAPSHOT_T *p_snapshot );
 
 /*!
-  @brief        Sets a specific value to all positions where the piece value is 1.
+  @brief        Restores the fields of a snapshot that are not rows (column heights, counters, current piece, score
+                and randomizer), and stops tracking the changed rows.
 
-  @param[in]    value: the value to write on the valid positions.
-  @param[in]    reset_color: either reset or not the color to GAME_PIECE_COLOR_RESET.
+  @param[in]    p_game: pointer to the game that owns the board.
+  @param[in]    p_snapshot: the snapshot.
 
   @returns      void
 */
-static void _set_current_piece_value_to_board( uint8_t value, bool reset_color );
+static void _restore_snapshot_fields( tetris_game_t *p_game, const BOARD_SNAPSHOT_T *p_snapshot );
 
 /*!
-  @brief        Clears a row that is full of 1s and moves the above rows one row down.
+  @brief        Updates the column heights after rows have been removed from the board.
 
-  @param[in]    p_area: pointer to the area to be cleared.
+  @param[in]    p_board: pointer to the board.
+  @param[in]    top_row: the highest row that was removed.
+  @param[in]    row_count: the number of rows removed.
 
   @returns      void
 */
-static void _clear_complete_row( BOARD_AREA_T *p_area );
+static void _update_col_heights_after_clear( BOARD_STRUCT_T *p_board, uint16_t top_row, uint16_t row_count );
+
+/*!
+  @brief        Computes the XOR of the Zobrist keys of the fixed cells of some rows, borders excluded.
+
+  @param[in]    p_board: pointer to the board.
+  @param[in]    first_row: first row.
+  @param[in]    row_count: number of rows.
+
+  @returns      The XOR of the keys.
+*/
+static uint64_t _zobrist_rows( BOARD_STRUCT_T *p_board, uint16_t first_row, uint16_t row_count );
+
+/*!
+  @brief        Computes the XOR of the Zobrist keys of the cells set in a word of a row.
+
+  @param[in]    row: the row.
+  @param[in]    word: index of the word in the row.
+  @param[in]    cells: the cells.
+
+  @returns      The XOR of the keys.
+*/
+static uint64_t _zobrist_word( uint16_t row, uint16_t word, board_word_t cells );
+
+/*!
+  @brief        Scrambles a 64-bit value (the splitmix64 finalizer), distinct values give distinct results.
+
+  @param[in]    value: the value.
+
+  @returns      The scrambled value.
+*/
+static uint64_t _zobrist_mix( uint64_t value );
+
+/*!
+  @brief        Tests a piece against the board as if it were placed at the given position.
+
+  @param[in]    p_board: pointer to the board.
+  @param[in]    p_piece: pointer to the piece to be tested.
+  @param[in]    row: board row of the piece's first row (may be negative).
+  @param[in]    col: board column of the piece's first column (may be negative).
+
+  @returns      One of BOARD_HITS_E.
+*/
+static uint8_t _check_piece_position( BOARD_STRUCT_T *p_board, PIECE_STRUCT_T *p_piece, int16_t row, int16_t col );
 
 /*!
   @brief        Check if the piece will collide with another piece or the border after it is moved.
 
+  @param[in]    p_board: pointer to the board.
   @param[in]    direction: which direction to move the piece (from BOARD_DIRECTIONS_E).
 
-  @returns      Which direction to move the piece (from BOARD_DIRECTIONS_E).
+  @returns      BOARD_NO_COLLISION or one of the collision events (from BOARD_COLLISIONS_E).
 */
-static uint8_t _check_current_piece_collision( uint8_t direction );
+static uint8_t _check_current_piece_collision( BOARD_STRUCT_T *p_board, uint8_t direction );
 
 /*!
-  @brief        Move the piece across the board by adding the piece's valid values to the
-                corresponding board values at the next position.
-                
+  @brief        Move the piece across the board by updating its position.
+
+  @param[in]    p_piece: pointer to the piece to be moved.
   @param[in]    direction: which direction to move the piece (from BOARD_DIRECTIONS_E).
 
-  @returns      void
+  @returns      One of the possible TETRIS_RET_x macro values (defined in main.h).
 */
-static int8_t _move_current_piece( uint8_t direction );
+static int8_t _move_current_piece( PIECE_STRUCT_T *p_piece, uint8_t direction );
 
 
 /* ==========================================================================================================
  * Global Functions Declaration
  */
 
-void board_init( void ){
-  score_init();
-  _clear_board_entirely();
+int8_t board_init( tetris_game_t *p_game, uint16_t row_size, uint16_t col_size ){
+  BOARD_STRUCT_T *p_board = &p_game->board;
 
-  /* Board has U-shaped border */
-  for( uint8_t i=0; i<BOARD_ROW_SIZE; i++ ){
-    board[i][0]                    = BOARD_REGION_BORDER_VALUE;
-    board[i][ BOARD_COL_SIZE - 1 ] = BOARD_REGION_BORDER_VALUE;
+  if( row_size < BOARD_MIN_ROW_SIZE || row_size > BOARD_MAX_ROW_SIZE ||
+      col_size < BOARD_MIN_COL_SIZE || col_size > BOARD_MAX_COL_SIZE ){
+    LOG_WRN( "Invalid board size: %u x %u\n", row_size, col_size );
+    return TETRIS_RET_ERR;
   }
 
-  for( uint8_t j=0; j<BOARD_COL_SIZE; j++ ){
-    board[ BOARD_ROW_SIZE - 1 ][j] = BOARD_REGION_BORDER_VALUE;
+  if( _alloc_board_storage( p_board, row_size, col_size ) != TETRIS_RET_OK ){
+    return TETRIS_RET_ERR;
   }
-  
-  /* Test with piece portions: */
-  // board[1][3] = 1;
-  // board[3][6] = 1;
-  // board[1][9] = 1;
+
+  score_init( p_game );
+  _clear_board_entirely( p_board );
+
+  p_board->has_current_piece    = false;
+  p_board->piece_count          = 0;
+  p_board->cell_count           = 0;
+  p_board->last_fixed_first_row = 0;
+  p_board->last_fixed_last_row  = -1;
+  p_board->zobrist_hash         = 0;
+
+  memset( p_board->col_height, 0, p_board->col_size * sizeof( p_board->col_height[0] ) );
+
+  return TETRIS_RET_OK;
+}
+
+
+void board_deinit( tetris_game_t *p_game ){
+  BOARD_STRUCT_T *p_board = &p_game->board;
+
+  game_aligned_free( p_board->p_storage );
+
+  p_board->p_storage    = NULL;
+  p_board->storage_size = 0;
+  p_board->rows         = NULL;
+  p_board->row_count    = NULL;
+  p_board->col_height   = NULL;
+  p_board->color        = NULL;
 }
 
 
-void board_print( void ){
-  for( uint8_t i=0; i<BOARD_ROW_SIZE; i++ ){
-    for( uint8_t j=0; j<BOARD_COL_SIZE; j++ ){
-      if( i == ( BOARD_ROW_SIZE - 1 ) ){
+void board_print( tetris_game_t *p_game ){
+  BOARD_STRUCT_T *p_board = &p_game->board;
+  PIECE_STRUCT_T *p_piece = &p_game->board.current_piece;
+  const PIECE_ORIENTATION_T *p_orientation = PIECE_ORIENTATION( p_piece );
+  const board_region_t *p_colors = NULL;
+  piece_row_t piece_row = 0;
+  int16_t piece_row_idx = 0;
+  int16_t piece_col     = p_piece->position_col + p_orientation->first_col;
+  uint8_t cell_color    = GAME_PIECE_COLOR_RESET;
+  bool board_cell       = false;
+  bool piece_cell       = false;
+
+  for( uint16_t i=0; i<p_board->row_size; i++ ){
+    p_colors  = BOARD_ROW_COLORS( p_board, i );
+    piece_row = 0;
+
+    if( p_board->has_current_piece ){
+      piece_row_idx = (int16_t) i - p_piece->position_row;
+
+      if( piece_row_idx >= 0 && piece_row_idx < p_piece->order ){
+        piece_row = p_orientation->row_mask[piece_row_idx] >> p_orientation->first_col;
+      }
+    }
+
+    for( uint16_t j=0; j<p_board->col_size; j++ ){
+      if( i == ( p_board->row_size - 1 ) ){
         LOG_GAME( GAME_PRINT_COLOR_RESET"* " );
       }
       else{
         if( j == 0 ){
           LOG_GAME( GAME_PRINT_COLOR_RESET"*|" );
         }
-        else if( j == ( BOARD_COL_SIZE - 1 ) ){
+        else if( j == ( p_board->col_size - 1 ) ){
           LOG_GAME( GAME_PRINT_COLOR_RESET"*\n" );
         }
         else{
-          if( board[i][j] != 0 ){
-            switch( board_color[i][j] ){
+          board_cell = BOARD_CELL_IS_SET( p_board, i, j );
+          piece_cell = ( (int16_t) j >= piece_col && ( j - piece_col ) < PIECE_LARGEST_MATRIX_ORDER &&
+                         ( ( piece_row >> ( j - piece_col ) ) & 1u ) );
+
+          if( board_cell || piece_cell ){
+            cell_color = board_cell ? p_colors[j] : p_piece->print_color;
+
+            switch( cell_color ){
               case GAME_PIECE_COLOR_MAGENTA:
                 LOG_GAME( GAME_PRINT_COLOR_MAGENTA"#"GAME_PRINT_COLOR_RESET"|" );
                 break;
@@ -236,109 +385,339 @@ void board_print( void ){
 }
 
 
-void add_new_piece_to_board( uint8_t type ){
-  p_current_piece = &current_piece;
-  piece_get( type, p_current_piece );
+uint64_t board_hash( tetris_game_t *p_game ){
+  BOARD_STRUCT_T *p_board = &p_game->board;
+  PIECE_STRUCT_T *p_piece = &p_game->board.current_piece;
+  const board_word_t *p_row = NULL;
+  uint64_t hash = BOARD_HASH_FNV_OFFSET;
+  uint64_t piece_word = 0;
+
+  /* Only the words that hold cells are hashed, the row padding is not part of the state */
+  for( uint16_t i=0; i<p_board->row_size; i++ ){
+    p_row = BOARD_ROW_WORDS( p_board, i );
+
+    for( uint16_t j=0; j<BOARD_WORDS_PER_ROW( p_board ); j++ ){
+      hash = ( hash ^ p_row[j] ) * BOARD_HASH_FNV_PRIME;
+    }
+  }
+
+  if( p_board->has_current_piece ){
+    piece_word = ( (uint64_t) p_piece->type << 48 ) | ( (uint64_t) p_piece->rotation << 40 ) |
+                 ( (uint64_t) (uint16_t) p_piece->position_row << 16 ) | (uint64_t) (uint16_t) p_piece->position_col;
+    hash = ( hash ^ piece_word ) * BOARD_HASH_FNV_PRIME;
+  }
+
+  return hash;
+}
+
+
+uint64_t board_zobrist_key( uint16_t row, uint16_t col ){
+  return _zobrist_mix( BOARD_ZOBRIST_CELL_SEED + (uint64_t) row * BOARD_MAX_COL_SIZE + col );
+}
 
-  uint8_t start_col       = BOARD_REGION_CENTER_COL - ( current_piece.order / 2 );
-  uint8_t piece_idx       = 0;
-  uint8_t piece_start_row = 0;
 
-  current_piece.position_row   = 0;
-  current_piece.position_col   = start_col;
-  current_piece.displayed_rows = current_piece.order;
-  current_piece.displayed_cols = current_piece.order;
-  
-  uint8_t i = 0;
-  uint8_t j = 0;
-  bool flag_break = false;
+uint64_t board_get_zobrist_hash( tetris_game_t *p_game ){
+  BOARD_STRUCT_T *p_board = &p_game->board;
+  PIECE_STRUCT_T *p_piece = &p_game->board.current_piece;
+  uint64_t piece_word     = 0;
 
-  /* Check for empty rows in the piece upper portion */
-  while( i<current_piece.order && !flag_break ){
-    while( j<current_piece.order ){
-      piece_idx = ( current_piece.order * i ) + j;
+  if( !p_board->has_current_piece )
+    return p_board->zobrist_hash;
 
-      if( current_piece.shape[piece_idx] == 1 ){
-        LOG_DBG( "i: %u\n", i );
-        piece_start_row = i;
-        flag_break = true;
-        break;
-      }
+  piece_word = ( (uint64_t) p_piece->type << 48 ) | ( (uint64_t) p_piece->rotation << 40 ) |
+               ( (uint64_t) (uint16_t) p_piece->position_row << 16 ) | (uint64_t) (uint16_t) p_piece->position_col;
+
+  return p_board->zobrist_hash ^ _zobrist_mix( BOARD_ZOBRIST_PIECE_SEED ^ piece_word );
+}
+
+
+uint64_t board_compute_zobrist_hash( tetris_game_t *p_game ){
+  /* The bottom border row has no playable cell */
+  return _zobrist_rows( &p_game->board, 0, p_game->board.row_size - 1 );
+}
+
+
+size_t board_state_size( tetris_game_t *p_game ){
+  return sizeof( BOARD_STATE_HEADER_T ) + p_game->board.storage_size;
+}
+
+
+void board_save_state( tetris_game_t *p_game, uint8_t *p_state ){
+  BOARD_STRUCT_T *p_board = &p_game->board;
+  BOARD_STATE_HEADER_T header;
+
+  /* Zeroed first so the struct padding is the same in every saved state */
+  memset( &header, 0, sizeof( header ) );
+
+  header.row_size             = p_board->row_size;
+  header.col_size             = p_board->col_size;
+  header.cell_count           = p_board->cell_count;
+  header.last_fixed_first_row = p_board->last_fixed_first_row;
+  header.last_fixed_last_row  = p_board->last_fixed_last_row;
+  header.piece_count          = p_board->piece_count;
+  header.current_piece        = p_board->current_piece;
+  header.has_current_piece    = p_board->has_current_piece;
+  header.storage_size         = p_board->storage_size;
+
+  memcpy( p_state, &header, sizeof( header ) );
+  memcpy( p_state + sizeof( header ), p_board->p_storage, p_board->storage_size );
+}
+
+
+int8_t board_load_state( tetris_game_t *p_game, const uint8_t *p_state, size_t size ){
+  BOARD_STRUCT_T *p_board = &p_game->board;
+  BOARD_STATE_HEADER_T header;
+
+  if( size < sizeof( header ) )
+    return TETRIS_RET_ERR;
+
+  memcpy( &header, p_state, sizeof( header ) );
+
+  if( header.row_size != p_board->row_size || header.col_size != p_board->col_size ||
+      header.storage_size != p_board->storage_size || size != sizeof( header ) + p_board->storage_size ){
+    LOG_WRN( "Board state does not match the board size\n" );
+    return TETRIS_RET_ERR;
+  }
+
+  p_board->cell_count           = header.cell_count;
+  p_board->last_fixed_first_row = header.last_fixed_first_row;
+  p_board->last_fixed_last_row  = header.last_fixed_last_row;
+  p_board->piece_count          = header.piece_count;
+  p_board->current_piece        = header.current_piece;
+  p_board->has_current_piece    = header.has_current_piece;
+
+  memcpy( p_board->p_storage, p_state + sizeof( header ), p_board->storage_size );
+  p_board->dirty_rows = ~(uint64_t) 0;
+
+  /* The hash is not part of the state, so states saved before it existed still load */
+  p_board->zobrist_hash = board_compute_zobrist_hash( p_game );
+
+  return TETRIS_RET_OK;
+}
+
+
+int8_t board_snapshot( tetris_game_t *p_game, BOARD_SNAPSHOT_T *p_snapshot ){
+  BOARD_STRUCT_T *p_board = &p_game->board;
+
+  if( p_board->row_size > BOARD_SNAPSHOT_MAX_ROW_SIZE || p_board->col_size > BOARD_SNAPSHOT_MAX_COL_SIZE )
+    return TETRIS_RET_ERR;
+
+  /* A row of one word has no padding, so each plane is copied in one go */
+  memcpy( p_snapshot->rows, p_board->rows, p_board->row_size * sizeof( board_word_t ) );
+  memcpy( p_snapshot->row_count, p_board->row_count, p_board->row_size * sizeof( p_board->row_count[0] ) );
+  memcpy( p_snapshot->col_height, p_board->col_height, p_board->col_size * sizeof( p_board->col_height[0] ) );
+
+  p_snapshot->row_size             = p_board->row_size;
+  p_snapshot->col_size             = p_board->col_size;
+  p_snapshot->cell_count           = p_board->cell_count;
+  p_snapshot->last_fixed_first_row = p_board->last_fixed_first_row;
+  p_snapshot->last_fixed_last_row  = p_board->last_fixed_last_row;
+  p_snapshot->piece_count          = p_board->piece_count;
+  p_snapshot->current_piece        = p_board->current_piece;
+  p_snapshot->has_current_piece    = p_board->has_current_piece;
+  p_snapshot->score                = p_game->score;
+  p_snapshot->randomizer           = p_game->randomizer;
+  p_snapshot->zobrist_hash         = p_board->zobrist_hash;
 
-      j++;
+  p_board->dirty_rows = 0;
+
+  return TETRIS_RET_OK;
+}
+
+
+int8_t board_restore( tetris_game_t *p_game, const BOARD_SNAPSHOT_T *p_snapshot ){
+  BOARD_STRUCT_T *p_board = &p_game->board;
+
+  if( !_is_snapshot_of_board( p_board, p_snapshot ) )
+    return TETRIS_RET_ERR;
+
+  memcpy( p_board->rows, p_snapshot->rows, p_board->row_size * sizeof( board_word_t ) );
+  memcpy( p_board->row_count, p_snapshot->row_count, p_board->row_size * sizeof( p_board->row_count[0] ) );
+
+  _restore_snapshot_fields( p_game, p_snapshot );
+
+  return TETRIS_RET_OK;
+}
+
+
+int8_t board_restore_changed( tetris_game_t *p_game, const BOARD_SNAPSHOT_T *p_snapshot ){
+  BOARD_STRUCT_T *p_board = &p_game->board;
+  uint64_t dirty_rows     = p_board->dirty_rows;
+  uint16_t row            = 0;
+
+  if( !_is_snapshot_of_board( p_board, p_snapshot ) )
+    return TETRIS_RET_ERR;
+
+  /* Fixing a piece touches a handful of rows, only a line clear moves the whole stack above it */
+  while( dirty_rows != 0 ){
+    row        = __builtin_ctzll( dirty_rows );
+    dirty_rows &= dirty_rows - 1;
+
+    if( row >= p_board->row_size )
+      break;
+
+    p_board->rows[row]      = p_snapshot->rows[row];
+    p_board->row_count[row] = p_snapshot->row_count[row];
+  }
+
+  _restore_snapshot_fields( p_game, p_snapshot );
+
+  return TETRIS_RET_OK;
+}
+
+
+void board_get_cells( tetris_game_t *p_game, board_region_t *p_cells ){
+  BOARD_STRUCT_T *p_board = &p_game->board;
+  PIECE_STRUCT_T *p_piece = &p_game->board.current_piece;
+  const PIECE_ORIENTATION_T *p_orientation = PIECE_ORIENTATION( p_piece );
+  const board_region_t *p_colors = NULL;
+  board_region_t *p_row_cells    = NULL;
+  piece_row_t piece_row = 0;
+  uint16_t board_row    = 0;
+  uint16_t board_col    = 0;
+
+  for( uint16_t i=0; i<(p_board->row_size - 1); i++ ){
+    p_colors    = BOARD_ROW_COLORS( p_board, i );
+    p_row_cells = &p_cells[ (size_t) i * p_board->col_size ];
+
+    p_row_cells[0]                     = BOARD_CELL_BORDER;
+    p_row_cells[p_board->col_size - 1] = BOARD_CELL_BORDER;
+
+    for( uint16_t j=1; j<(p_board->col_size - 1); j++ ){
+      p_row_cells[j] = BOARD_CELL_IS_SET( p_board, i, j ) ? p_colors[j] : BOARD_CELL_EMPTY;
     }
+  }
+
+  memset( &p_cells[ (size_t) ( p_board->row_size - 1 ) * p_board->col_size ], BOARD_CELL_BORDER, p_board->col_size );
+
+  if( !p_board->has_current_piece )
+    return;
 
-    j = 0;
-    i++;
+  /* The current piece is drawn over the empty cells only, like in board_print */
+  board_col = p_piece->position_col + p_orientation->first_col;
+
+  for( uint8_t i=p_orientation->first_row; i<=p_orientation->last_row; i++ ){
+    board_row   = p_piece->position_row + i;
+    piece_row   = p_orientation->row_mask[i] >> p_orientation->first_col;
+    p_row_cells = &p_cells[ (size_t) board_row * p_board->col_size + board_col ];
+
+    for( uint8_t j=0; j<PIECE_LARGEST_MATRIX_ORDER; j++ ){
+      if( ( ( piece_row >> j ) & 1u ) && p_row_cells[j] == BOARD_CELL_EMPTY ){
+        p_row_cells[j] = p_piece->print_color;
+      }
+    }
   }
+}
 
-  current_piece.position_row -= piece_start_row;
 
-  uint8_t board_row_idx = 0;
-  i = 0;
-  j = 0;
+int8_t board_get_column_cells( tetris_game_t *p_game, board_word_t *p_columns ){
+  BOARD_STRUCT_T *p_board = &p_game->board;
+  const board_word_t *p_row = NULL;
+  board_word_t cells        = 0;
+  board_word_t below_board  = 0;
+
+  if( p_board->row_size > BOARD_WORD_BITS )
+    return TETRIS_RET_ERR;
+
+  below_board = ( p_board->row_size < BOARD_WORD_BITS ) ? ( ~(board_word_t) 0 << p_board->row_size ) : 0;
+
+  for( uint16_t j=0; j<p_board->col_size; j++ ){
+    p_columns[j] = below_board;
+  }
+
+  /* Most cells are empty, so only the set bits of each row are visited */
+  for( uint16_t i=0; i<p_board->row_size; i++ ){
+    p_row = BOARD_ROW_WORDS( p_board, i );
 
-  for( i=piece_start_row; i<current_piece.order; i++ ){
-    for( j=0; j<current_piece.order; j++ ){
-      piece_idx = ( current_piece.order * i ) + j;
+    for( uint16_t w=0; w<BOARD_WORDS_PER_ROW( p_board ); w++ ){
+      cells = p_row[w];
 
-      board[board_row_idx][start_col + j] = current_piece.shape[piece_idx];
-      
-      if( current_piece.shape[piece_idx] != 0 ){
-        board_color[board_row_idx][start_col + j] = current_piece.print_color;
+      while( cells != 0 ){
+        p_columns[w * BOARD_WORD_BITS + __builtin_ctzll( cells )] |= (board_word_t) 1u << i;
+        cells &= cells - 1;
       }
     }
-    board_row_idx++;
   }
 
-  piece_count++;
+  return TETRIS_RET_OK;
+}
+
+
+void board_get_spawn_piece( tetris_game_t *p_game, uint8_t type, uint8_t rotation, PIECE_STRUCT_T *p_piece ){
+  piece_get( type, p_piece );
+
+  p_piece->rotation = rotation % PIECE_ROTATION_COUNT;
+
+  /* Skip the empty rows in the piece upper portion, so the first filled row starts at the top of the board */
+  p_piece->position_row = -(int16_t) PIECE_ORIENTATION( p_piece )->first_row;
+  p_piece->position_col = BOARD_CENTER_COL( &p_game->board ) - ( p_piece->order / 2 );
+}
+
+
+void add_new_piece_to_board( tetris_game_t *p_game, uint8_t type, uint8_t rotation ){
+  BOARD_STRUCT_T *p_board = &p_game->board;
+
+  p_board->has_current_piece = true;
+  board_get_spawn_piece( p_game, type, rotation, &p_board->current_piece );
+
+  p_board->piece_count++;
 }
 
 
-int8_t move_current_piece_through_board( uint8_t direction ){
-  if( p_current_piece == NULL )
+int8_t move_current_piece_through_board( tetris_game_t *p_game, uint8_t direction ){
+  BOARD_STRUCT_T *p_board = &p_game->board;
+  PIECE_STRUCT_T *p_piece = &p_game->board.current_piece;
+
+  if( !p_board->has_current_piece )
     return TETRIS_RET_ERR_NO_PIECE;
 
-  /*! TODO: debug this section of checking the hits */
-  uint8_t ret = _check_current_piece_collision( direction );
+  uint8_t ret = _check_current_piece_collision( p_board, direction );
 
   if( ret != BOARD_NO_COLLISION ){
     return (int8_t) ret;
   }
 
-  /* Clear the piece in the current position */
-  _remove_current_piece_from_board();
-
   /* Move the piece */
-  return _move_current_piece( direction );
-
-  // return TETRIS_RET_OK;
+  return _move_current_piece( p_piece, direction );
 }
 
 
-void rotate_current_piece_through_board( void ){
-  _remove_current_piece_from_board();
-  piece_rotate_90deg( p_current_piece );
-  _set_current_piece_value_to_board( 1, false );
+void rotate_current_piece_through_board( tetris_game_t *p_game ){
+  BOARD_STRUCT_T *p_board = &p_game->board;
+  PIECE_STRUCT_T *p_piece = &p_game->board.current_piece;
+
+  if( !p_board->has_current_piece )
+    return;
+
+  uint8_t previous_rotation = p_piece->rotation;
+  piece_rotate_90deg( p_piece );
+
+  /* Rotation is only kept if the rotated piece fits in the current position */
+  if( _check_piece_position( p_board, p_piece, p_piece->position_row, p_piece->position_col ) != BOARD_HIT_NONE ){
+    p_piece->rotation = previous_rotation;
+  }
 }
 
 
-uint8_t fix_current_piece_on_board( void ){
-  if( p_current_piece == NULL )
+uint8_t fix_current_piece_on_board( tetris_game_t *p_game ){
+  BOARD_STRUCT_T *p_board = &p_game->board;
+  PIECE_STRUCT_T *p_piece = &p_game->board.current_piece;
+
+  if( !p_board->has_current_piece )
     return TETRIS_RET_ERR_NO_PIECE;
 
-  if( !current_piece.is_moving ){  // fix the piece
-    _set_current_piece_value_to_board( 1, false );
-    score_increment_fix_piece();
-    p_current_piece = NULL;
+  if( !p_piece->is_moving ){  // fix the piece
+    _set_current_piece_value_to_board( p_board );
+    score_increment_fix_piece( p_game );
+    p_board->has_current_piece = false;
     return TETRIS_RET_READY;
   }
   else{
-    if( current_piece.is_colliding ){
-      current_piece.is_moving = false;
+    if( p_piece->is_colliding ){
+      p_piece->is_moving = false;
     }
     else{
-      current_piece.is_moving = true;
+      p_piece->is_moving = true;
     }
 
     return TETRIS_RET_OK;
@@ -346,51 +725,28 @@ uint8_t fix_current_piece_on_board( void ){
 }
 
 
-uint8_t check_complete_row( void ){
-  uint8_t seg_count = 0;  // segment sum
-  uint8_t win_count = 0;  // win check
-  uint8_t piece_row = 0;  // corresponding row in piece shape
-  uint8_t piece_col = 0;  // corresponding col in piece shape
-  uint8_t piece_idx = 0;  // corresponding col in piece shape
+uint8_t check_complete_row( tetris_game_t *p_game ){
+  BOARD_STRUCT_T *p_board = &p_game->board;
+  uint8_t cleared_rows     = 0;
 
-  /* Check for game over condition (first row with at least a 1, current piece doesn't count) */
-  for( uint8_t j=1; j<(BOARD_COL_SIZE-1); j++ ){    // discard first and last col (borders)
-    if( board[0][j] != 0 &&                                               // there is a 1 in the baord
-        p_current_piece->position_col <= j &&                             // col j is in between the piece horizontal length
-        ( p_current_piece->position_col + p_current_piece->order) > j ){
-      piece_row = p_current_piece->position_row + p_current_piece->order;
-      piece_col = j - p_current_piece->position_col;
-      piece_idx = ( p_current_piece->order * piece_row ) + piece_col;
-
-      if( p_current_piece->shape[piece_idx] == 0 ){  // the piece is not "causing" the 1 in the board, so it is a previous piece
-        return TETRIS_GAME_OVER;
-      }
-    }
+  /* Check for game over condition (first row with at least a fixed cell, current piece is not in the board) */
+  if( p_board->row_count[0] != 0 ){
+    return TETRIS_GAME_OVER;
   }
 
-  /* Check for game score condition (rows full of 1) */
-  for( uint8_t i=(BOARD_ROW_SIZE-2); i>=1; i-- ){   // discard first and last row (game over and border)
-    seg_count = 0;
+  /* Check for game score condition (rows full of 1), only the rows touched by the last fixed piece */
+  cleared_rows = _clear_complete_rows( p_board, p_board->last_fixed_first_row, p_board->last_fixed_last_row );
 
-    for( uint8_t j=1; j<(BOARD_COL_SIZE-1); j++ ){  // discard first and last col (borders)
-      if( board[i][j] == 0 ){
-        break;
-      }
-      else{
-        win_count++;
-        seg_count += board[i][j];
-      }
-    }
+  for( uint8_t i=0; i<cleared_rows; i++ ){
+    score_increment_complete_row( p_game );
+  }
 
-    if( seg_count >= ( BOARD_COL_SIZE - 2 ) ){
-      BOARD_AREA_T area = { i, 1, i, ( BOARD_COL_SIZE - 1 ) };
-      _clear_complete_row( &area );
-      score_increment_complete_row();
-    }
+  /* The range is consumed, so a later call without a new fixed piece does nothing */
+  p_board->last_fixed_first_row = 0;
+  p_board->last_fixed_last_row  = -1;
 
-    if( win_count == 0 && piece_count > 1 ){
-      return TETRIS_GAME_WON;
-    }
+  if( p_board->cell_count == 0 && p_board->piece_count > 1 ){
+    return TETRIS_GAME_WON;
   }
 
   return TETRIS_GAME_NOT_OVER;
@@ -402,181 +758,354 @@ uint8_t check_complete_row( void ){
  */
 
 
-static inline void _clear_board_area( BOARD_AREA_T *p_area ){
-  if( p_area->start_row == p_area->end_row )
-    p_area->end_row++;
-  
-  if( p_area->start_col == p_area->end_col )
-    p_area->end_col++;
+static int8_t _alloc_board_storage( BOARD_STRUCT_T *p_board, uint16_t row_size, uint16_t col_size ){
+  uint16_t row_words    = BOARD_ROUND_UP( col_size, BOARD_WORD_BITS ) / BOARD_WORD_BITS;
+  uint16_t row_stride   = 1;
+  uint16_t color_stride = BOARD_ROUND_UP( col_size, GAME_CONFIG_CACHE_LINE_SIZE );
+
+  /* Rows up to a cache line are padded to a power of two words, so they never cross a cache line */
+  if( row_words > BOARD_WORDS_PER_CACHE_LINE ){
+    row_stride = BOARD_ROUND_UP( row_words, BOARD_WORDS_PER_CACHE_LINE );
+  }
+  else{
+    while( row_stride < row_words ){
+      row_stride *= 2;
+    }
+  }
+
+  size_t rows_size   = BOARD_ROUND_UP( (size_t) row_size * row_stride * sizeof( board_word_t ), GAME_CONFIG_CACHE_LINE_SIZE );
+  size_t color_size  = (size_t) row_size * color_stride;
+  size_t count_size  = BOARD_ROUND_UP( (size_t) row_size * sizeof( uint16_t ), GAME_CONFIG_CACHE_LINE_SIZE );
+  size_t height_size = BOARD_ROUND_UP( (size_t) col_size * sizeof( uint16_t ), GAME_CONFIG_CACHE_LINE_SIZE );
+  size_t total_size  = rows_size + color_size + count_size + height_size;
+
+  if( p_board->p_storage == NULL || p_board->storage_size != total_size ){
+    game_aligned_free( p_board->p_storage );
 
-  for( uint8_t i=p_area->start_row; i<p_area->end_row; i++ ){
-    for( uint8_t j=p_area->start_col; j<p_area->end_col; j++ ){
-      if( board[i][j] != BOARD_REGION_BORDER_VALUE )
-        board[i][j] = 0;
+    p_board->p_storage = game_aligned_alloc( total_size );
+    if( p_board->p_storage == NULL ){
+      LOG_WRN( "Failed to allocate %zu bytes for the board\n", total_size );
+      p_board->storage_size = 0;
+      return TETRIS_RET_ERR;
     }
+
+    /* The padding between the planes is saved along with them (board_save_state), so it must not hold garbage */
+    memset( p_board->p_storage, 0, total_size );
+    p_board->storage_size = total_size;
   }
+
+  /* Every plane starts at a cache line boundary */
+  p_board->rows       = (board_word_t *) p_board->p_storage;
+  p_board->color      = (board_region_t *) ( (uint8_t *) p_board->p_storage + rows_size );
+  p_board->row_count  = (uint16_t *) ( (uint8_t *) p_board->p_storage + rows_size + color_size );
+  p_board->col_height = (uint16_t *) ( (uint8_t *) p_board->p_storage + rows_size + color_size + count_size );
+
+  p_board->row_size     = row_size;
+  p_board->col_size     = col_size;
+  p_board->row_stride   = row_stride;
+  p_board->color_stride = color_stride;
+
+  return TETRIS_RET_OK;
 }
 
 
-static void _clear_board_entirely( void ){
-  BOARD_AREA_T area = { 0, 0, BOARD_ROW_SIZE, BOARD_COL_SIZE };
-  _clear_board_area( &area );
+static void _clear_board_rows( BOARD_STRUCT_T *p_board, uint16_t first_row, uint16_t row_count ){
+  uint16_t last_col = p_board->col_size - 1;
+
+  memset( BOARD_ROW_WORDS( p_board, first_row ), 0, (size_t) row_count * p_board->row_stride * sizeof( board_word_t ) );
+  memset( BOARD_ROW_COLORS( p_board, first_row ), GAME_PIECE_COLOR_RESET, (size_t) row_count * p_board->color_stride );
+  memset( &p_board->row_count[first_row], 0, row_count * sizeof( p_board->row_count[0] ) );
+  _mark_dirty_rows( p_board, first_row, row_count );
+
+  /* Border cells are never cleared */
+  for( uint16_t i=first_row; i<(first_row + row_count); i++ ){
+    BOARD_ROW_WORDS( p_board, i )[0]                          |= (board_word_t) 1u;
+    BOARD_ROW_WORDS( p_board, i )[last_col / BOARD_WORD_BITS] |= (board_word_t) 1u << ( last_col % BOARD_WORD_BITS );
+  }
 }
 
 
-static void _remove_current_piece_from_board( void ){
-  _set_current_piece_value_to_board( 0, true );
+static void _clear_board_entirely( BOARD_STRUCT_T *p_board ){
+  board_word_t *p_bottom_row = BOARD_ROW_WORDS( p_board, p_board->row_size - 1 );
+
+  _clear_board_rows( p_board, 0, p_board->row_size );
+
+  /* Board has U-shaped border */
+  for( uint16_t j=0; j<p_board->col_size; j++ ){
+    p_bottom_row[j / BOARD_WORD_BITS] |= (board_word_t) 1u << ( j % BOARD_WORD_BITS );
+  }
 }
 
 
-static void _set_current_piece_value_to_board( uint8_t value, bool reset_color ){
-  uint8_t piece_idx = 0;
-  uint8_t piece_row = 0;
-  uint8_t board_row = 0;
-  uint8_t board_col = 0;
+static void _set_current_piece_value_to_board( BOARD_STRUCT_T *p_board ){
+  PIECE_STRUCT_T *p_piece                  = &p_board->current_piece;
+  const PIECE_ORIENTATION_T *p_orientation = PIECE_ORIENTATION( p_piece );
+  board_word_t *p_row     = NULL;
+  board_region_t *p_color = NULL;
+  board_word_t new_cells  = 0;
+  piece_row_t piece_row   = 0;
+  uint16_t board_row      = 0;
+  uint16_t board_col      = p_piece->position_col + p_orientation->first_col;
+  uint16_t word           = board_col / BOARD_WORD_BITS;
+  uint16_t bit            = board_col % BOARD_WORD_BITS;
+  uint8_t added_cells     = 0;
+
+  for( uint8_t i=p_orientation->first_row; i<=p_orientation->last_row; i++ ){
+    board_row = p_piece->position_row + i;
+    piece_row = p_orientation->row_mask[i] >> p_orientation->first_col;
+    p_row     = BOARD_ROW_WORDS( p_board, board_row );
+    p_color   = BOARD_ROW_COLORS( p_board, board_row );
+
+    /* A piece spawned over fixed cells may overlap them, so only the newly filled cells are counted */
+    new_cells              = ( (board_word_t) piece_row << bit ) & ~p_row[word];
+    added_cells            = __builtin_popcountll( new_cells );
+    p_board->zobrist_hash ^= _zobrist_word( board_row, word, new_cells );
+    p_row[word]           |= (board_word_t) piece_row << bit;
+
+    /* The piece row may continue on the next word */
+    if( ( bit + PIECE_LARGEST_MATRIX_ORDER ) > BOARD_WORD_BITS ){
+      new_cells              = ( (board_word_t) piece_row >> ( BOARD_WORD_BITS - bit ) ) & ~p_row[word + 1];
+      added_cells           += __builtin_popcountll( new_cells );
+      p_board->zobrist_hash ^= _zobrist_word( board_row, word + 1, new_cells );
+      p_row[word + 1]       |= (board_word_t) piece_row >> ( BOARD_WORD_BITS - bit );
+    }
 
-  for( uint8_t i=0; i<current_piece.order; i++ ){
-    piece_row = ( current_piece.order * i );
-    board_row = current_piece.position_row + i;
+    p_board->row_count[board_row] += added_cells;
+    p_board->cell_count           += added_cells;
 
-    for( uint8_t j=0; j<current_piece.order; j++ ){
-      piece_idx = piece_row + j;
-      board_col = current_piece.position_col + j;
+    for( uint8_t j=0; j<PIECE_LARGEST_MATRIX_ORDER; j++ ){
+      if( ( piece_row >> j ) & 1u ){
+        p_color[board_col + j] = p_piece->print_color;
 
-      if( current_piece.shape[piece_idx] != 0 ){
-        board[board_row][board_col]       = value;
-        board_color[board_row][board_col] = ( reset_color ? GAME_PIECE_COLOR_RESET : current_piece.print_color );
+        if( p_board->col_height[board_col + j] < ( p_board->row_size - 1 - board_row ) )
+          p_board->col_height[board_col + j] = p_board->row_size - 1 - board_row;
       }
     }
   }
+
+  p_board->last_fixed_first_row = p_piece->position_row + p_orientation->first_row;
+  p_board->last_fixed_last_row  = p_piece->position_row + p_orientation->last_row;
+
+  _mark_dirty_rows( p_board, p_board->last_fixed_first_row, p_orientation->last_row - p_orientation->first_row + 1 );
 }
 
 
-static void _clear_complete_row( BOARD_AREA_T *p_area ){
-  _clear_board_area( p_area );  // clear the row
+static uint8_t _clear_complete_rows( BOARD_STRUCT_T *p_board, int16_t first_row, int16_t last_row ){
+  uint16_t complete_rows[PIECE_LARGEST_MATRIX_ORDER];
+  uint8_t complete_count = 0;
+  uint16_t run_start     = 0;
 
-  /* Move all the rows above the cleared row one row down */
-  for( int8_t i=p_area->start_row; i>0; i-- ){  // row
-    for( uint8_t j=1; j<(BOARD_COL_SIZE-1); j++ ){
-      board[i][j] = board[i-1][j];
+  /* Complete rows, from the bottom up */
+  for( int16_t i=last_row; i>=first_row && i>=0; i-- ){
+    if( p_board->row_count[i] == BOARD_PLAYABLE_CELLS( p_board ) ){
+      complete_rows[complete_count++] = i;
     }
   }
 
-  for( uint8_t j=1; j<(BOARD_COL_SIZE-1); j++ ){
-    board[0][j] = board[1][j];
+  if( complete_count == 0 )
+    return 0;
+
+  p_board->cell_count -= complete_count * BOARD_PLAYABLE_CELLS( p_board );
+
+  /* Only the rows down to the lowest complete row change, their keys are removed now and added back once moved */
+  p_board->zobrist_hash ^= _zobrist_rows( p_board, 0, complete_rows[0] + 1 );
+
+  /*
+    Each run of surviving rows above a complete row moves down by the number of complete rows below it. Runs are
+    moved from the bottom up, so a run never overwrites rows that were not moved yet. The last run is the whole
+    stack above the highest complete row.
+  */
+  for( uint8_t k=0; k<complete_count; k++ ){
+    run_start = ( k + 1 < complete_count ) ? ( complete_rows[k+1] + 1 ) : 0;
+    _move_board_rows( p_board, run_start, run_start + k + 1, complete_rows[k] - run_start );
   }
+
+  /* Rows left empty at the top */
+  _clear_board_rows( p_board, 0, complete_count );
+
+  p_board->zobrist_hash ^= _zobrist_rows( p_board, 0, complete_rows[0] + 1 );
+
+  _update_col_heights_after_clear( p_board, complete_rows[complete_count-1], complete_count );
+
+  return complete_count;
 }
 
 
-static uint8_t _check_current_piece_collision( uint8_t direction ){
-  uint8_t offset_row = 0;
-  uint8_t offset_col = 0;
-  uint8_t piece_idx  = 0;
+static void _move_board_rows( BOARD_STRUCT_T *p_board, uint16_t src_row, uint16_t dst_row, uint16_t row_count ){
+  if( row_count == 0 )
+    return;
+
+  memmove( BOARD_ROW_WORDS( p_board, dst_row ), BOARD_ROW_WORDS( p_board, src_row ),
+           (size_t) row_count * p_board->row_stride * sizeof( board_word_t ) );
+  memmove( BOARD_ROW_COLORS( p_board, dst_row ), BOARD_ROW_COLORS( p_board, src_row ),
+           (size_t) row_count * p_board->color_stride );
+  memmove( &p_board->row_count[dst_row], &p_board->row_count[src_row], row_count * sizeof( p_board->row_count[0] ) );
+  _mark_dirty_rows( p_board, dst_row, row_count );
+}
+
 
-  current_piece.is_colliding = false;
+static void _mark_dirty_rows( BOARD_STRUCT_T *p_board, uint16_t first_row, uint16_t row_count ){
+  uint16_t end_row = first_row + row_count;
+
+  if( first_row >= BOARD_DIRTY_ROW_BITS || row_count == 0 )
+    return;
+
+  if( end_row > BOARD_DIRTY_ROW_BITS )
+    end_row = BOARD_DIRTY_ROW_BITS;
+
+  if( end_row - first_row == BOARD_DIRTY_ROW_BITS ){
+    p_board->dirty_rows = ~(uint64_t) 0;
+  }
+  else{
+    p_board->dirty_rows |= ( ( (uint64_t) 1u << ( end_row - first_row ) ) - 1 ) << first_row;
+  }
+}
+
+
+static bool _is_snapshot_of_board( BOARD_STRUCT_T *p_board, const BOARD_SNAPSHOT_T *p_snapshot ){
+  return p_snapshot->row_size == p_board->row_size && p_snapshot->col_size == p_board->col_size &&
+         p_board->row_size <= BOARD_SNAPSHOT_MAX_ROW_SIZE && p_board->col_size <= BOARD_SNAPSHOT_MAX_COL_SIZE;
+}
+
+
+static void _restore_snapshot_fields( tetris_game_t *p_game, const BOARD_SNAPSHOT_T *p_snapshot ){
+  BOARD_STRUCT_T *p_board = &p_game->board;
+
+  memcpy( p_board->col_height, p_snapshot->col_height, p_board->col_size * sizeof( p_board->col_height[0] ) );
+
+  p_board->cell_count           = p_snapshot->cell_count;
+  p_board->last_fixed_first_row = p_snapshot->last_fixed_first_row;
+  p_board->last_fixed_last_row  = p_snapshot->last_fixed_last_row;
+  p_board->piece_count          = p_snapshot->piece_count;
+  p_board->current_piece        = p_snapshot->current_piece;
+  p_board->has_current_piece    = p_snapshot->has_current_piece;
+  p_board->dirty_rows           = 0;
+  p_game->score                 = p_snapshot->score;
+  p_game->randomizer            = p_snapshot->randomizer;
+  p_board->zobrist_hash         = p_snapshot->zobrist_hash;
+}
+
+
+static void _update_col_heights_after_clear( BOARD_STRUCT_T *p_board, uint16_t top_row, uint16_t row_count ){
+  uint16_t top_row_height = p_board->row_size - 1 - top_row;
+
+  for( uint16_t j=1; j<(p_board->col_size-1); j++ ){
+    if( p_board->col_height[j] > top_row_height ){
+      /* Highest cell was above the removed rows, so it moved down by all of them */
+      p_board->col_height[j] -= row_count;
+    }
+    else{
+      /* Highest cell was in the highest removed row, look for the next fixed cell below the empty top rows */
+      p_board->col_height[j] = 0;
+
+      for( uint16_t i=row_count; i<(p_board->row_size-1); i++ ){
+        if( BOARD_CELL_IS_SET( p_board, i, j ) ){
+          p_board->col_height[j] = p_board->row_size - 1 - i;
+          break;
+        }
+      }
+    }
+  }
+}
+
+
+static uint8_t _check_piece_position( BOARD_STRUCT_T *p_board, PIECE_STRUCT_T *p_piece, int16_t row, int16_t col ){
+  const PIECE_ORIENTATION_T *p_orientation = PIECE_ORIENTATION( p_piece );
+  const board_word_t *p_row = NULL;
+  board_word_t hit          = 0;
+  piece_row_t piece_row     = 0;
+  int16_t board_row         = 0;
+  int16_t board_col         = col + p_orientation->first_col;
+  uint16_t word             = 0;
+  uint16_t bit              = 0;
+  uint16_t right_border_col = 0;
+
+  /* Filled piece rows above or below the board always hit the border */
+  if( ( row + p_orientation->first_row ) < 0 || ( row + p_orientation->last_row ) >= p_board->row_size )
+    return BOARD_HIT_BORDER;
+
+  /* So do filled piece columns shifted out of the left or right side of the row */
+  if( board_col < 0 || ( col + p_orientation->last_col ) >= p_board->col_size )
+    return BOARD_HIT_BORDER;
+
+  word             = board_col / BOARD_WORD_BITS;
+  bit              = board_col % BOARD_WORD_BITS;
+  right_border_col = p_board->col_size - 1 - board_col;
+
+  for( uint8_t i=p_orientation->first_row; i<=p_orientation->last_row; i++ ){
+    board_row = row + i;
+    piece_row = p_orientation->row_mask[i] >> p_orientation->first_col;
+    p_row     = BOARD_ROW_WORDS( p_board, board_row );
+
+    hit = p_row[word] & ( (board_word_t) piece_row << bit );
+
+    /* The piece row may continue on the next word */
+    if( ( bit + PIECE_LARGEST_MATRIX_ORDER ) > BOARD_WORD_BITS && ( word + 1 ) < p_board->row_stride ){
+      hit |= p_row[word + 1] & ( (board_word_t) piece_row >> ( BOARD_WORD_BITS - bit ) );
+    }
+
+    if( hit != 0 ){
+      if( board_row == ( p_board->row_size - 1 ) ||
+          ( board_col == 0 && ( piece_row & 1u ) ) ||
+          ( right_border_col < PIECE_LARGEST_MATRIX_ORDER && ( ( piece_row >> right_border_col ) & 1u ) ) )
+        return BOARD_HIT_BORDER;
+      else
+        return BOARD_HIT_OBJECT;
+    }
+  }
+
+  return BOARD_HIT_NONE;
+}
+
+
+static uint8_t _check_current_piece_collision( BOARD_STRUCT_T *p_board, uint8_t direction ){
+  PIECE_STRUCT_T *p_piece = &p_board->current_piece;
+  uint8_t hit             = BOARD_HIT_NONE;
+
+  p_piece->is_colliding = false;
 
   /* Check if piece will hit something */
   switch( direction ){
     case BOARD_DIRECTION_DOWN:
-    {
-      uint8_t collision_result = 0;
-
-      for( int8_t j=(current_piece.order-1); j>=0; j-- ){    // col
-        for( int8_t i=(current_piece.order-1); i>=0; i-- ){  // row
-          piece_idx = ( current_piece.order * i ) + j;
-          LOG_DBG( "current_piece.shape[%u][%u]: %u\n", i, j, current_piece.shape[piece_idx] );
-
-          if( current_piece.shape[piece_idx] == 1 ){  // this cell can hit something
-            offset_col = current_piece.position_col + j;
-            offset_row = current_piece.position_row + i + 1;  // one row below
-            collision_result = board[offset_row][offset_col] + current_piece.shape[piece_idx];
-            
-            LOG_DBG( "board[%u][%u]: %u\n", offset_row, offset_col, board[offset_row][offset_col] );
-
-            if( collision_result == 2 ){
-              LOG_INF( "*** piece hit another piece at the bottom ***\n" );
-              current_piece.is_colliding = true;
-              return BOARD_COLLISION_OBJECT_BOTTOM;
-            }
-            else if( collision_result > 3 ){
-              LOG_INF( "*** piece hit bottom border ***\n" );
-              current_piece.is_colliding = true;
-              return BOARD_COLLISION_BORDER_BOTTOM;
-            }
+      hit = _check_piece_position( p_board, p_piece, p_piece->position_row + 1, p_piece->position_col );
 
-            break;
-          }
-        }
+      if( hit == BOARD_HIT_OBJECT ){
+        LOG_INF( "*** piece hit another piece at the bottom ***\n" );
+        p_piece->is_colliding = true;
+        return BOARD_COLLISION_OBJECT_BOTTOM;
+      }
+      else if( hit == BOARD_HIT_BORDER ){
+        LOG_INF( "*** piece hit bottom border ***\n" );
+        p_piece->is_colliding = true;
+        return BOARD_COLLISION_BORDER_BOTTOM;
       }
-      
       break;
-    }
 
     case BOARD_DIRECTION_LEFT:
-    {
-      uint8_t collision_result = 0;
-
-      for( int8_t i=0; i<current_piece.order; i++ ){    // row
-        for( int8_t j=0; j<current_piece.order; j++ ){  // col
-          piece_idx = ( current_piece.order * i ) + j;
-          LOG_DBG( "current_piece.shape[%u][%u]: %u\n", i, j, current_piece.shape[piece_idx] );
-
-          if( current_piece.shape[piece_idx] == 1 ){  // this cell can hit something
-            offset_col = current_piece.position_col + j - 1;  // one col to the left
-            offset_row = current_piece.position_row + i;
-            collision_result = board[offset_row][offset_col] + current_piece.shape[piece_idx];
-            
-            LOG_DBG( "board[%u][%u]: %u\n", offset_row, offset_col, board[offset_row][offset_col] );
-
-            if( collision_result == 2 ){
-              LOG_INF( "*** piece hit another piece to the left ***\n" );
-              return BOARD_COLLISION_OBJECT_LEFT;
-            }
-            else if( collision_result > 3 ){
-              LOG_INF( "*** piece hit left-side border ***\n" );
-              return BOARD_COLLISION_BORDER_LEFT;
-            }
+      hit = _check_piece_position( p_board, p_piece, p_piece->position_row, p_piece->position_col + BOARD_H_DISPLACEMENT_LEFT );
 
-            break;
-          }
-        }
+      if( hit == BOARD_HIT_OBJECT ){
+        LOG_INF( "*** piece hit another piece to the left ***\n" );
+        return BOARD_COLLISION_OBJECT_LEFT;
+      }
+      else if( hit == BOARD_HIT_BORDER ){
+        LOG_INF( "*** piece hit left-side border ***\n" );
+        return BOARD_COLLISION_BORDER_LEFT;
       }
-      
       break;
-    }
 
     case BOARD_DIRECTION_RIGHT:
-    {
-      uint8_t collision_result = 0;
-
-      for( int8_t i=0; i<current_piece.order; i++ ){         // row
-        for( int8_t j=(current_piece.order-1); j>=0; j-- ){  // col
-          piece_idx = ( current_piece.order * i ) + j;
-          LOG_DBG( "current_piece.shape[%u][%u]: %u\n", i, j, current_piece.shape[piece_idx] );
-
-          if( current_piece.shape[piece_idx] == 1 ){  // this cell can hit something
-            offset_col = current_piece.position_col + j + 1;  // one col to the right
-            offset_row = current_piece.position_row + i;
-            collision_result = board[offset_row][offset_col] + current_piece.shape[piece_idx];
-            
-            LOG_DBG( "board[%u][%u]: %u\n", offset_row, offset_col, board[offset_row][offset_col] );
-
-            if( collision_result == 2 ){
-              LOG_INF( "*** piece hit another piece to the right ***\n" );
-              return BOARD_COLLISION_OBJECT_RIGHT;
-            }
-            else if( collision_result > 3 ){
-              LOG_INF( "*** piece hit right-side border ***\n" );
-              return BOARD_COLLISION_BORDER_RIGHT;
-            }
+      hit = _check_piece_position( p_board, p_piece, p_piece->position_row, p_piece->position_col + BOARD_H_DISPLACEMENT_RIGHT );
 
-            break;
-          }
-        }
+      if( hit == BOARD_HIT_OBJECT ){
+        LOG_INF( "*** piece hit another piece to the right ***\n" );
+        return BOARD_COLLISION_OBJECT_RIGHT;
+      }
+      else if( hit == BOARD_HIT_BORDER ){
+        LOG_INF( "*** piece hit right-side border ***\n" );
+        return BOARD_COLLISION_BORDER_RIGHT;
       }
-      
       break;
-    }
 
     case BOARD_DIRECTION_LAST_IDX:
     default:
@@ -587,76 +1116,75 @@ static uint8_t _check_current_piece_collision( uint8_t direction ){
 }
 
 
-static int8_t _move_current_piece( uint8_t direction ){
-  int8_t horizontal_direction = BOARD_H_DISPLACEMENT_RIGHT;
-  uint8_t offset_row          = 0;
-  uint8_t offset_col          = 0;
-  uint8_t piece_idx           = 0;
-
+static int8_t _move_current_piece( PIECE_STRUCT_T *p_piece, uint8_t direction ){
   switch( direction ){
     case BOARD_DIRECTION_DOWN:
-    {
-      uint8_t piece_start_row = 0;
-      
-      if( current_piece.displayed_rows < current_piece.order ){
-        offset_row = current_piece.position_row;
-        piece_start_row = current_piece.order - current_piece.displayed_rows - 1;
-      }
-      else{
-        offset_row = current_piece.position_row + 1;
-        piece_start_row = current_piece.order - current_piece.displayed_rows;
-      }
+      p_piece->position_row++;
+      break;
 
-      for( uint8_t i=piece_start_row; i<current_piece.order; i++ ){
-        for( uint8_t j=0; j<current_piece.order; j++ ){
-          offset_col = current_piece.position_col + j;
-          piece_idx  = (current_piece.order * i) + j;
+    case BOARD_DIRECTION_LEFT:
+      p_piece->position_col += BOARD_H_DISPLACEMENT_LEFT;
+      break;
 
-          board[offset_row][offset_col] += current_piece.shape[piece_idx];
+    case BOARD_DIRECTION_RIGHT:
+      p_piece->position_col += BOARD_H_DISPLACEMENT_RIGHT;
+      break;
 
-          if( current_piece.shape[piece_idx] != 0 ){
-            board_color[offset_row][offset_col] = current_piece.print_color;
-          }
-        }
-        offset_row++;
-      }
+    case BOARD_DIRECTION_LAST_IDX:
+    default:
+      return TETRIS_RET_ERR;
+  }
 
-      if( current_piece.displayed_rows < current_piece.order ) current_piece.displayed_rows++;
-      else current_piece.position_row++;
+  return TETRIS_RET_OK;
+}
 
-      break;
-    }
 
-    case BOARD_DIRECTION_LEFT:
-      horizontal_direction = BOARD_H_DISPLACEMENT_LEFT;
+static uint64_t _zobrist_rows( BOARD_STRUCT_T *p_board, uint16_t first_row, uint16_t row_count ){
+  const board_word_t *p_row = NULL;
+  uint16_t last_col         = p_board->col_size - 1;
+  uint16_t last_word        = last_col / BOARD_WORD_BITS;
+  board_word_t cells        = 0;
+  uint64_t hash             = 0;
 
-    case BOARD_DIRECTION_RIGHT:
-    {
-      uint8_t piece_start_row = current_piece.order - current_piece.displayed_rows;
-      offset_row = current_piece.position_row;
+  for( uint16_t i=first_row; i<(first_row + row_count); i++ ){
+    /* Most rows of a stack are empty */
+    if( p_board->row_count[i] == 0 )
+      continue;
 
-      for( uint8_t i=piece_start_row; i<current_piece.order; i++ ){
-        for( uint8_t j=0; j<current_piece.displayed_cols; j++ ){
-          offset_col = current_piece.position_col + j + horizontal_direction;
-          piece_idx  = ( current_piece.order * i ) + j;
+    p_row = BOARD_ROW_WORDS( p_board, i );
 
-          board[offset_row][offset_col] += current_piece.shape[piece_idx];
+    for( uint16_t j=0; j<=last_word; j++ ){
+      cells = p_row[j];
 
-          if( current_piece.shape[piece_idx] != 0 ){
-            board_color[offset_row][offset_col] = current_piece.print_color;
-          }
-        }
-        offset_row++;
-      }
+      if( j == 0 )
+        cells &= ~(board_word_t) 1u;
 
-      current_piece.position_col += horizontal_direction;
-      break;
+      if( j == last_word )
+        cells &= ~( (board_word_t) 1u << ( last_col % BOARD_WORD_BITS ) );
+
+      hash ^= _zobrist_word( i, j, cells );
     }
+  }
 
-    case BOARD_DIRECTION_LAST_IDX:
-    default:
-      return TETRIS_RET_ERR;
+  return hash;
+}
+
+
+static uint64_t _zobrist_word( uint16_t row, uint16_t word, board_word_t cells ){
+  uint64_t hash = 0;
+
+  while( cells != 0 ){
+    hash  ^= board_zobrist_key( row, (uint16_t) ( word * BOARD_WORD_BITS + __builtin_ctzll( cells ) ) );
+    cells &= cells - 1;
   }
 
-  return TETRIS_RET_OK;
+  return hash;
+}
+
+
+static uint64_t _zobrist_mix( uint64_t value ){
+  value = ( value ^ ( value >> 30 ) ) * 0xBF58476D1CE4E5B9ull;
+  value = ( value ^ ( value >> 27 ) ) * 0x94D049BB133111EBull;
+
+  return value ^ ( value >> 31 );
 }
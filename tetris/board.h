@@ -14,13 +14,53 @@
  */
 
 #include <stdint.h>
+#include <stdbool.h>
+#include <stddef.h>
 
+#include "main.h"
+#include "game_config.h"
 #include "pieces.h"
+#include "score.h"
+#include "randomizer.h"
 
 /* ==========================================================================================================
  * Definitions
  */
 
+/*
+  Board is a rectangle matrix of sizes row_size x col_size (chosen in board_init) with a U-shaped border, as follows:
+
+  3 0 0 ... 0 3
+  3 0 0 ... 0 3
+  3 0 0 ... 0 3
+  : : :     : :
+  3 0 0 ... 0 3
+  3 3 3 ... 3 3
+
+  Each row is stored as a bitmask of row_stride words (board_word_t), where bit k of word w represents column
+  64 * w + k. Border cells are always set, so the row above looks like 1 0 0 ... 0 1 and the bottom row is all 1s.
+  Only fixed pieces are stored in the board, the current piece is kept apart and is tested against the board
+  with AND operations.
+*/
+#define BOARD_WORD_BITS           64
+
+#define BOARD_MIN_ROW_SIZE        ( PIECE_LARGEST_MATRIX_ORDER + 1 )
+#define BOARD_MIN_COL_SIZE        ( PIECE_LARGEST_MATRIX_ORDER + 2 )
+#define BOARD_MAX_ROW_SIZE        16384
+#define BOARD_MAX_COL_SIZE        512
+
+/*
+  Values of a cell in a frame (see board_get_cells). A filled cell holds the color of the piece that fills it
+  (from GAME_PIECE_COLOR_x), which never collides with these.
+*/
+#define BOARD_CELL_EMPTY          0x80
+#define BOARD_CELL_BORDER         0x81
+
+/* Largest board a BOARD_SNAPSHOT_T holds: one word per row, and every row tracked in `dirty_rows` */
+#define BOARD_SNAPSHOT_MAX_ROW_SIZE  32
+#define BOARD_SNAPSHOT_MAX_COL_SIZE  BOARD_WORD_BITS
+
+
 /* ==========================================================================================================
  * Typedefs
  */
@@ -55,72 +95,311 @@ typedef enum{
 */
 typedef uint8_t board_region_t;
 
+/*!
+  @brief        Wrapper type used to indicate a word of a board row bitmask (bit k is set when the column is filled
+                or is a border).
+*/
+typedef uint64_t board_word_t;
+
+/*!
+  @brief        Holds the state of a board and of the piece moving through it.
+
+  @param        row_size: number of rows, bottom border included.
+  @param        col_size: number of columns, left and right borders included.
+  @param        row_stride: number of words of each row in `rows` (padded so a row never crosses a cache line
+                unless it is larger than one).
+  @param        color_stride: number of bytes of each row in `color` (padded to a multiple of a cache line).
+  @param        rows: row_size x row_stride words, with the fixed pieces and the border (starts on top left corner).
+  @param        row_count: number of fixed cells in each row, borders excluded.
+  @param        col_height: number of rows from the bottom border up to the highest fixed cell of each column.
+  @param        color: row_size x color_stride bytes, the color of each fixed cell (from GAME_PIECE_COLOR_x).
+  @param        cell_count: number of fixed cells in the whole playable area.
+  @param        last_fixed_first_row: first row touched by the last fixed piece.
+  @param        last_fixed_last_row: last row touched by the last fixed piece (less than the first row if none).
+  @param        piece_count: number of pieces added to the board so far.
+  @param        current_piece: the piece moving through the board, valid only if `has_current_piece` is set.
+  @param        has_current_piece: whether there is a piece moving through the board.
+  @param        p_storage: single cache-aligned allocation that backs all the planes above.
+  @param        storage_size: size in bytes of `p_storage`.
+  @param        dirty_rows: bit k is set when row k changed since the last board_snapshot or board_restore (rows
+                from 64 on are not tracked).
+  @param        zobrist_hash: XOR of the board_zobrist_key of every fixed cell, borders excluded.
+
+  @note         The counters and the hash are only updated when a piece is fixed or a row is cleared.
+*/
+typedef struct BOARD_STRUCT_TAG{
+  uint16_t       row_size;
+  uint16_t       col_size;
+  uint16_t       row_stride;
+  uint16_t       color_stride;
+  board_word_t   *rows;
+  uint16_t       *row_count;
+  uint16_t       *col_height;
+  board_region_t *color;
+  uint32_t       cell_count;
+  int16_t        last_fixed_first_row;
+  int16_t        last_fixed_last_row;
+  uint32_t       piece_count;
+  PIECE_STRUCT_T current_piece;
+  bool           has_current_piece;
+  void           *p_storage;
+  size_t         storage_size;
+  uint64_t       dirty_rows;
+  uint64_t       zobrist_hash;
+} BOARD_STRUCT_T;
+
+/*!
+  @brief        Fixed-size copy of the rule state of a game whose board fits in BOARD_SNAPSHOT_MAX_ROW_SIZE x
+                BOARD_SNAPSHOT_MAX_COL_SIZE. It holds no pointer, so snapshots are copied with a plain assignment.
+
+  @param        rows: one word per row, as in BOARD_STRUCT_T (row_size words used).
+  @param        row_count, col_height: same as in BOARD_STRUCT_T (row_size and col_size entries used).
+  @param        row_size, col_size: size of the board, the snapshot only restores into a board of the same size.
+  @param        score, randomizer: the score and the upcoming pieces of the game.
+  @param        (others): same as in BOARD_STRUCT_T.
+
+  @note         The colors of the fixed cells are not part of the snapshot, they only matter to the display.
+*/
+typedef struct BOARD_SNAPSHOT_TAG{
+  _Alignas( GAME_CONFIG_CACHE_LINE_SIZE ) board_word_t rows[BOARD_SNAPSHOT_MAX_ROW_SIZE];
+  uint16_t            row_count[BOARD_SNAPSHOT_MAX_ROW_SIZE];
+  uint16_t            col_height[BOARD_SNAPSHOT_MAX_COL_SIZE];
+  uint16_t            row_size;
+  uint16_t            col_size;
+  uint32_t            cell_count;
+  int16_t             last_fixed_first_row;
+  int16_t             last_fixed_last_row;
+  uint32_t            piece_count;
+  PIECE_STRUCT_T      current_piece;
+  bool                has_current_piece;
+  SCORE_STRUCT_T      score;
+  RANDOMIZER_STRUCT_T randomizer;
+  uint64_t            zobrist_hash;
+} BOARD_SNAPSHOT_T;
+
 
 /* ==========================================================================================================
  * Global Functions
  */
 
 /*!
-  @brief        Initializes the board with zeros and U-shaped border.
+  @brief        Initializes the board with zeros and U-shaped border, and the game score.
 
-  @param        none
+  @param[in]    p_game: pointer to the game that owns the board.
+  @param[in]    row_size: number of rows, bottom border included (from BOARD_MIN_ROW_SIZE to BOARD_MAX_ROW_SIZE).
+  @param[in]    col_size: number of columns, borders included (from BOARD_MIN_COL_SIZE to BOARD_MAX_COL_SIZE).
+
+  @returns      One of the possible TETRIS_RET_x macro values (defined in main.h).
+
+  @warning      The board storage is reused when the size does not change, so the game must be zero-initialized
+                (or created with game_create) before the first call.
+*/
+int8_t board_init( tetris_game_t *p_game, uint16_t row_size, uint16_t col_size );
+
+/*!
+  @brief        Releases the storage of the board.
+
+  @param[in]    p_game: pointer to the game that owns the board.
 
   @returns      void
 */
-void board_init( void );
+void board_deinit( tetris_game_t *p_game );
 
 /*!
   @brief        Prints the board in its current state.
 
-  @param        none
+  @param[in]    p_game: pointer to the game that owns the board.
+
+  @returns      void
+*/
+void board_print( tetris_game_t *p_game );
+
+/*!
+  @brief        Writes every cell of the board as it should be displayed, current piece included.
+
+  @param[in]    p_game: pointer to the game that owns the board.
+  @param[out]   p_cells: row_size x col_size cells, each one BOARD_CELL_EMPTY, BOARD_CELL_BORDER or the color of the
+                piece that fills it.
 
   @returns      void
 */
-void board_print( void );
+void board_get_cells( tetris_game_t *p_game, board_region_t *p_cells );
 
 /*!
-  @brief        Adds the bottom row of a piece to the top center of the board.
+  @brief        Computes a 64-bit hash (FNV-1a) of the fixed cells of the board and of the current piece, used to
+                check that two games reached the same state.
+
+  @param[in]    p_game: pointer to the game that owns the board.
+
+  @returns      The hash.
+*/
+uint64_t board_hash( tetris_game_t *p_game );
+
+/*!
+  @brief        Gets the Zobrist key of a cell: a fixed board is hashed as the XOR of the keys of its fixed cells, so
+                fixing or clearing a cell updates the hash with one XOR.
+
+  @param[in]    row: row of the cell.
+  @param[in]    col: column of the cell.
+
+  @returns      The key, the same for every board size.
+*/
+uint64_t board_zobrist_key( uint16_t row, uint16_t col );
+
+/*!
+  @brief        Gets the Zobrist hash of the game: the hash of the fixed cells, kept up to date by the board, mixed
+                with the current piece. Costs no more than a few multiplications, so two games are compared cheaply.
+
+  @param[in]    p_game: pointer to the game that owns the board.
+
+  @returns      The hash.
+*/
+uint64_t board_get_zobrist_hash( tetris_game_t *p_game );
+
+/*!
+  @brief        Computes the Zobrist hash of the fixed cells from scratch, to check the one kept by the board.
+
+  @param[in]    p_game: pointer to the game that owns the board.
+
+  @returns      The hash, equal to `zobrist_hash` unless the board was corrupted.
+*/
+uint64_t board_compute_zobrist_hash( tetris_game_t *p_game );
 
+/*!
+  @brief        Gets the number of bytes board_save_state writes, which only depends on the board size.
+
+  @param[in]    p_game: pointer to the game that owns the board.
+
+  @returns      The size of the state.
+*/
+size_t board_state_size( tetris_game_t *p_game );
+
+/*!
+  @brief        Saves the whole state of the board (fixed cells, counters and current piece) to a buffer.
+
+  @param[in]    p_game: pointer to the game that owns the board.
+  @param[out]   p_state: buffer of board_state_size bytes.
+
+  @returns      void
+
+  @note         The state is a memory image of the board, it only loads on a machine with the same byte order.
+*/
+void board_save_state( tetris_game_t *p_game, uint8_t *p_state );
+
+/*!
+  @brief        Loads a state saved by board_save_state.
+
+  @param[in]    p_game: pointer to the game that owns the board, initialized with the size of the saved board.
+  @param[in]    p_state: the state.
+  @param[in]    size: number of bytes in `p_state`.
+
+  @returns      TETRIS_RET_OK, or TETRIS_RET_ERR if the state does not match the size of the board.
+*/
+int8_t board_load_state( tetris_game_t *p_game, const uint8_t *p_state, size_t size );
+
+/*!
+  @brief        Copies the rule state of the game (board, current piece, score and randomizer) to a snapshot, and
+                starts tracking the rows changed from then on.
+
+  @param[in]    p_game: pointer to the game that owns the board.
+  @param[out]   p_snapshot: the snapshot.
+
+  @returns      TETRIS_RET_OK, or TETRIS_RET_ERR if the board is larger than a snapshot holds.
+*/
+int8_t board_snapshot( tetris_game_t *p_game, BOARD_SNAPSHOT_T *p_snapshot );
+
+/*!
+  @brief        Brings the game back to a snapshot, copying every row.
+
+  @param[in]    p_game: pointer to the game that owns the board.
+  @param[in]    p_snapshot: the snapshot, taken from a board of the same size.
+
+  @returns      TETRIS_RET_OK, or TETRIS_RET_ERR if the snapshot does not match the size of the board.
+*/
+int8_t board_restore( tetris_game_t *p_game, const BOARD_SNAPSHOT_T *p_snapshot );
+
+/*!
+  @brief        Brings the game back to a snapshot, copying only the rows changed since it was taken.
+
+  @param[in]    p_game: pointer to the game that owns the board.
+  @param[in]    p_snapshot: the snapshot.
+
+  @returns      TETRIS_RET_OK, or TETRIS_RET_ERR if the snapshot does not match the size of the board.
+
+  @warning      The snapshot must be the last one taken from or restored to this game, the rows that changed
+                between them are not tracked.
+*/
+int8_t board_restore_changed( tetris_game_t *p_game, const BOARD_SNAPSHOT_T *p_snapshot );
+
+/*!
+  @brief        Writes the fixed cells of each column as a bitmask of rows, the transpose of the row bitmasks.
+
+  @param[in]    p_game: pointer to the game that owns the board, with at most BOARD_WORD_BITS rows.
+  @param[out]   p_columns: col_size words, bit r of word c is set when cell (r, c) is filled or is a border. Bits
+                from row_size on are set too, as if the bottom border went on below the board.
+
+  @returns      TETRIS_RET_OK, or TETRIS_RET_ERR if the board has too many rows.
+*/
+int8_t board_get_column_cells( tetris_game_t *p_game, board_word_t *p_columns );
+
+/*!
+  @brief        Gets a piece as add_new_piece_to_board would place it on the board, without adding it.
+
+  @param[in]    p_game: pointer to the game that owns the board.
+  @param[in]    type: one of the piece shape types (from PIECE_SHAPES_E).
+  @param[in]    rotation: initial orientation of the piece, from 0 to PIECE_ROTATION_COUNT - 1.
+  @param[out]   p_piece: the piece, at its spawn position.
+
+  @returns      void
+*/
+void board_get_spawn_piece( tetris_game_t *p_game, uint8_t type, uint8_t rotation, PIECE_STRUCT_T *p_piece );
+
+/*!
+  @brief        Adds a new piece to the top center of the board, with its first filled row at the top row.
+
+  @param[in]    p_game: pointer to the game that owns the board.
   @param[in]    type: one of the piece shape types (from PIECE_SHAPES_E).
+  @param[in]    rotation: initial orientation of the piece, from 0 to PIECE_ROTATION_COUNT - 1.
 
   @returns      void
 */
-void add_new_piece_to_board( uint8_t type );
+void add_new_piece_to_board( tetris_game_t *p_game, uint8_t type, uint8_t rotation );
 
 /*!
   @brief        Moves a piece through the board, if said movement is valid.
 
+  @param[in]    p_game: pointer to the game that owns the board.
   @param[in]    direction: which direction to move the piece (from BOARD_DIRECTIONS_E).
 
   @returns      One of the possible TETRIS_RET_x macro values (defined in main.h).
 */
-int8_t move_current_piece_through_board( uint8_t direction );
+int8_t move_current_piece_through_board( tetris_game_t *p_game, uint8_t direction );
 
 /*!
-  @brief        Moves a piece through the board, if said movement is valid.
+  @brief        Rotates a piece 90 degrees clockwise, if the rotated piece fits in the board.
 
-  @param        none
+  @param[in]    p_game: pointer to the game that owns the board.
 
   @returns      void
 */
-void rotate_current_piece_through_board( void );
+void rotate_current_piece_through_board( tetris_game_t *p_game );
 
 /*!
   @brief        Fix the current piece in its current position. After that, it can no longer be moved.
 
-  @param        none
+  @param[in]    p_game: pointer to the game that owns the board.
 
-  @returns      void
+  @returns      One of the possible TETRIS_RET_x macro values (defined in main.h).
 */
-uint8_t fix_current_piece_on_board( void );
+uint8_t fix_current_piece_on_board( tetris_game_t *p_game );
 
 /*!
   @brief        Checks if a row has been completed, i.e. player has scored.
 
-  @param        none
+  @param[in]    p_game: pointer to the game that owns the board.
 
   @returns      TETRIS_GAME_OVER, TETRIS_GAME_NOT_OVER or TETRIS_GAME_WON.
 */
-uint8_t check_complete_row( void );
+uint8_t check_complete_row( tetris_game_t *p_game );
 
-#endif /* _BOARD_H_ */
\ No newline at end of file
+#endif /* _BOARD_H_ */
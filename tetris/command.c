@@ -0,0 +1,80 @@
+/*
+ *  command.c
+ *
+ *  Created on: 17-Oct-2026
+ *      Author: lucas-noce
+ */
+
+/* ==========================================================================================================
+ * Includes
+ */
+
+#include <stdlib.h>
+#include <stdint.h>
+#include <stdatomic.h>
+
+#include "main.h"
+#include "game_config.h"
+#include "command.h"
+
+
+/* ==========================================================================================================
+ * Global Functions Declaration
+ */
+
+void command_ring_init( COMMAND_RING_T *p_ring ){
+  atomic_init( &p_ring->head, 0 );
+  atomic_init( &p_ring->tail, 0 );
+}
+
+
+int8_t command_push( COMMAND_RING_T *p_ring, const COMMAND_STRUCT_T *p_command ){
+  unsigned int tail = atomic_load_explicit( &p_ring->tail, memory_order_relaxed );
+  unsigned int head = atomic_load_explicit( &p_ring->head, memory_order_acquire );
+
+  if( ( tail - head ) >= COMMAND_RING_SIZE )
+    return TETRIS_RET_ERR;
+
+  p_ring->slots[tail % COMMAND_RING_SIZE] = *p_command;
+
+  /* Publishes the slot: the consumer sees the new tail only after the command is written */
+  atomic_store_explicit( &p_ring->tail, tail + 1, memory_order_release );
+
+  return TETRIS_RET_OK;
+}
+
+
+int8_t command_pop( COMMAND_RING_T *p_ring, COMMAND_STRUCT_T *p_command ){
+  unsigned int head = atomic_load_explicit( &p_ring->head, memory_order_relaxed );
+  unsigned int tail = atomic_load_explicit( &p_ring->tail, memory_order_acquire );
+
+  if( head == tail )
+    return TETRIS_RET_ERR;
+
+  *p_command = p_ring->slots[head % COMMAND_RING_SIZE];
+
+  /* Hands the slot back: the producer reuses it only after the command is copied out */
+  atomic_store_explicit( &p_ring->head, head + 1, memory_order_release );
+
+  return TETRIS_RET_OK;
+}
+
+
+uint8_t command_from_key( char key ){
+  switch( key ){
+    case GAME_MOVE_DOWN_CHAR:
+      return GAME_COMMAND_MOVE_DOWN;
+
+    case GAME_MOVE_LEFT_CHAR:
+      return GAME_COMMAND_MOVE_LEFT;
+
+    case GAME_MOVE_RIGHT_CHAR:
+      return GAME_COMMAND_MOVE_RIGHT;
+
+    case GAME_ROTATE_CHAR:
+      return GAME_COMMAND_ROTATE;
+
+    default:
+      return GAME_COMMAND_LAST_IDX;
+  }
+}
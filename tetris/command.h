@@ -0,0 +1,119 @@
+/*
+ *  command.h
+ *
+ *  Created on: 17-Oct-2026
+ *      Author: lucas-noce
+ */
+
+#ifndef _COMMAND_H_
+#define _COMMAND_H_
+
+
+/* ==========================================================================================================
+ * Includes
+ */
+
+#include <stdint.h>
+#include <stdatomic.h>
+
+#include "main.h"
+#include "game_config.h"
+
+
+/* ==========================================================================================================
+ * Definitions
+ */
+
+#define COMMAND_RING_SIZE  64  // must be a power of 2
+
+
+/* ==========================================================================================================
+ * Typedefs
+ */
+
+/*!
+  @brief        Indicates the possible player actions.
+*/
+typedef enum{
+  GAME_COMMAND_MOVE_DOWN = 0,
+  GAME_COMMAND_MOVE_LEFT,
+  GAME_COMMAND_MOVE_RIGHT,
+  GAME_COMMAND_ROTATE,
+  GAME_COMMAND_LAST_IDX,
+} GAME_COMMANDS_E;
+
+/*!
+  @brief        A player action, waiting to be applied by the simulation.
+
+  @param        type: one of the GAME_COMMANDS_E values.
+  @param        timestamp_ns: monotonic time at which the key that generated the command was read, in nanoseconds.
+*/
+typedef struct COMMAND_STRUCT_TAG{
+  uint8_t  type;
+  uint64_t timestamp_ns;
+} COMMAND_STRUCT_T;
+
+/*!
+  @brief        Bounded ring of commands, with a single producer and a single consumer that never lock.
+
+  @param        head: number of commands popped so far, written only by the consumer.
+  @param        tail: number of commands pushed so far, written only by the producer.
+  @param        slots: the commands, indexed by head and tail modulo COMMAND_RING_SIZE.
+
+  @note         head and tail live in different cache lines, so the producer and the consumer do not invalidate
+                each other's line on every push and pop.
+*/
+typedef struct COMMAND_RING_TAG{
+  _Alignas( GAME_CONFIG_CACHE_LINE_SIZE ) atomic_uint head;
+  _Alignas( GAME_CONFIG_CACHE_LINE_SIZE ) atomic_uint tail;
+  _Alignas( GAME_CONFIG_CACHE_LINE_SIZE ) COMMAND_STRUCT_T slots[COMMAND_RING_SIZE];
+} COMMAND_RING_T;
+
+
+/* ==========================================================================================================
+ * Global Functions
+ */
+
+/*!
+  @brief        Empties a command ring.
+
+  @param[in]    p_ring: pointer to the ring.
+
+  @returns      void
+*/
+void command_ring_init( COMMAND_RING_T *p_ring );
+
+/*!
+  @brief        Adds a command to the end of the ring.
+
+  @param[in]    p_ring: pointer to the ring.
+  @param[in]    p_command: pointer to the command to be copied into the ring.
+
+  @returns      TETRIS_RET_OK, or TETRIS_RET_ERR if the ring is full (the command is not added).
+
+  @warning      Only one thread may push.
+*/
+int8_t command_push( COMMAND_RING_T *p_ring, const COMMAND_STRUCT_T *p_command );
+
+/*!
+  @brief        Removes the oldest command from the ring.
+
+  @param[in]    p_ring: pointer to the ring.
+  @param[out]   p_command: pointer to where the command is copied.
+
+  @returns      TETRIS_RET_OK, or TETRIS_RET_ERR if the ring is empty.
+
+  @warning      Only one thread may pop.
+*/
+int8_t command_pop( COMMAND_RING_T *p_ring, COMMAND_STRUCT_T *p_command );
+
+/*!
+  @brief        Translates a key into the command it is bound to (see the GAME_x_CHAR macros in game_config.h).
+
+  @param[in]    key: the character of the key.
+
+  @returns      One of the GAME_COMMANDS_E values, or GAME_COMMAND_LAST_IDX if the key is not bound to a command.
+*/
+uint8_t command_from_key( char key );
+
+#endif /* _COMMAND_H_ */
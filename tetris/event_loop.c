@@ -0,0 +1,485 @@
+/*
+ *  event_loop.c
+ *
+ *  Created on: 17-Oct-2026
+ *      Author: lucas-noce
+ */
+
+/* ==========================================================================================================
+ * Includes
+ */
+
+#include <stdlib.h>
+#include <stdio.h>
+#include <stdint.h>
+#include <stdbool.h>
+
+#include "main.h"
+#include "game_config.h"
+#include "graphics.h"
+#include "board.h"
+#include "score.h"
+#include "game.h"
+#include "frame.h"
+#include "input.h"
+#include "command.h"
+#include "timer_wheel.h"
+#include "platform.h"
+#include "latency.h"
+#include "replay.h"
+#include "autoplay.h"
+#include "event_loop.h"
+
+
+/* ==========================================================================================================
+ * Definitions
+ */
+
+/* The wheel ticks are milliseconds since the loop started */
+#define EVENT_LOOP_POLL_MAX_MS  INT32_MAX
+
+
+/* ==========================================================================================================
+ * Static Typedefs
+ */
+
+/*!
+  @brief        Holds one game driven by the event loop. A session owns no thread, only two timers in the wheel.
+
+  @param        p_game: the game.
+  @param        frames: frames published by the simulation and drawn by the render timer.
+  @param        commands: player commands waiting for the next tick.
+  @param        tick_timer: fires on the next game tick that does something (gravity step, speed-up or command).
+  @param        render_timer: fires when the latest frame is due to be drawn.
+  @param        latency: input latency of the session.
+  @param        replay: records the commands of the session (not open when the game is not recorded).
+  @param        autoplay: the automatic player (only initialized when `is_autoplay` is set).
+  @param        autoplay_piece_count: number of pieces the automatic player has moved so far.
+  @param        p_autoplay_path: path of the current piece (in `autoplay`), queued as the ring drains.
+  @param        autoplay_path_count: number of commands in `p_autoplay_path`.
+  @param        autoplay_path_idx: first command of `p_autoplay_path` not queued yet.
+  @param        start_ms: wheel time of the game tick 0 (moved forward when a stall is dropped).
+  @param        last_render_ms: wheel time of the last frame drawn.
+  @param        game_status: TETRIS_GAME_OVER, TETRIS_GAME_NOT_OVER or TETRIS_GAME_WON.
+  @param        is_running: false once the player quits or the end of the game is displayed.
+  @param        is_autoplay: whether the automatic player moves the pieces instead of the keys.
+*/
+typedef struct EVENT_LOOP_SESSION_TAG{
+  tetris_game_t     *p_game;
+  FRAME_BUFFER_T    frames;
+  COMMAND_RING_T    commands;
+  TIMER_STRUCT_T    tick_timer;
+  TIMER_STRUCT_T    render_timer;
+  LATENCY_STATS_T   latency;
+  REPLAY_WRITER_T   replay;
+  AUTOPLAY_STRUCT_T autoplay;
+  uint32_t          autoplay_piece_count;
+  const uint8_t     *p_autoplay_path;
+  uint16_t          autoplay_path_count;
+  uint16_t          autoplay_path_idx;
+  uint64_t          start_ms;
+  uint64_t          last_render_ms;
+  uint8_t           game_status;
+  bool              is_running;
+  bool              is_autoplay;
+} EVENT_LOOP_SESSION_T;
+
+
+/* ==========================================================================================================
+ * Static variables
+ */
+
+static TIMER_WHEEL_T event_loop_wheel;
+static EVENT_LOOP_SESSION_T event_loop_session;
+static uint64_t event_loop_start_ns;
+
+
+/* ==========================================================================================================
+ * Static Function Prototypes
+ */
+
+/*!
+  @brief        Tick timer callback: applies the pending commands and runs the game ticks up to now, then re-arms
+                the timer for the next tick that does something.
+
+  @param[in]    p_arg: pointer to the session.
+
+  @returns      void
+*/
+static void _session_tick( void *p_arg );
+
+/*!
+  @brief        Render timer callback: draws the latest frame of the session.
+
+  @param[in]    p_arg: pointer to the session.
+
+  @returns      void
+*/
+static void _session_render( void *p_arg );
+
+/*!
+  @brief        Turns a key into a command for the session, and brings its next tick forward so the command is
+                applied right away.
+
+  @param[in]    p_session: pointer to the session.
+  @param[in]    p_event: the key pressed.
+
+  @returns      void
+*/
+static void _session_handle_key( EVENT_LOOP_SESSION_T *p_session, const INPUT_KEY_EVENT_T *p_event );
+
+/*!
+  @brief        Lets the automatic player choose where a piece just spawned goes, and queues the commands of its
+                path that fit in the ring (the others are queued on the next ticks).
+
+  @param[in]    p_session: pointer to the session.
+
+  @returns      true if commands were queued, false otherwise.
+*/
+static bool _session_autoplay( EVENT_LOOP_SESSION_T *p_session );
+
+/*!
+  @brief        Publishes a frame of the session and arms the render timer, at most once per render period.
+
+  @param[in]    p_session: pointer to the session.
+
+  @returns      void
+*/
+static void _session_publish_frame( EVENT_LOOP_SESSION_T *p_session );
+
+/*!
+  @brief        Gets the wheel time of a game tick of the session.
+
+  @param[in]    p_session: pointer to the session.
+  @param[in]    tick: the game tick.
+
+  @returns      Milliseconds since the loop started.
+*/
+static uint64_t _session_tick_time_ms( EVENT_LOOP_SESSION_T *p_session, uint64_t tick );
+
+/*!
+  @brief        Restores the terminal, closes the replay and frees the game and the automatic player of the session,
+                whatever part of it was initialized.
+
+  @param[in]    p_session: pointer to the session.
+
+  @returns      void
+*/
+static void _session_release( EVENT_LOOP_SESSION_T *p_session );
+
+/*!
+  @brief        Gets the time elapsed since the loop started.
+
+  @returns      The time in milliseconds.
+*/
+static uint64_t _get_elapsed_ms( void );
+
+
+/* ==========================================================================================================
+ * Global Functions Declaration
+ */
+
+int event_loop_run( uint16_t board_row_size, uint16_t board_col_size, uint64_t seed, uint8_t difficulty,
+                    const char *p_replay_path, const AUTOPLAY_CONFIG_T *p_autoplay_config ){
+  EVENT_LOOP_SESSION_T *p_session = &event_loop_session;
+  AUTOPLAY_CONFIG_T autoplay_config;
+  bool is_autoplay       = ( p_autoplay_config != NULL );
+  INPUT_KEY_EVENT_T key_event;
+  uint64_t ticks_to_next = 0;
+  uint64_t now_ms        = 0;
+  int32_t timeout_ms     = 0;
+
+  p_session->p_game = game_create( board_row_size, board_col_size );
+  if( p_session->p_game == NULL ){
+    printf( "Invalid board size: %u x %u\n", board_row_size, board_col_size );
+    return 1;
+  }
+
+  /* Set once the automatic player is initialized, `_session_release()` frees it */
+  p_session->is_autoplay = false;
+
+  score_init( p_session->p_game );
+  score_set_difficulty( p_session->p_game, difficulty );
+  game_set_seed( p_session->p_game, seed );
+
+  if( p_replay_path != NULL ){
+    REPLAY_HEADER_T replay_header = {
+      .seed       = seed,
+      .row_size   = board_row_size,
+      .col_size   = board_col_size,
+      .difficulty = score_get_difficulty( p_session->p_game ),
+      .tick_ms    = GAME_CONFIG_TICK_MS
+    };
+
+    if( replay_writer_open( &p_session->replay, p_replay_path, &replay_header ) != TETRIS_RET_OK ){
+      printf( "Failed to record the replay to %s\n", p_replay_path );
+      _session_release( p_session );
+      return 1;
+    }
+  }
+
+  /* The search pool would be the only other threads, the placements are scored on the loop thread instead */
+  if( is_autoplay ){
+    autoplay_config             = *p_autoplay_config;
+    autoplay_config.max_workers = 0;
+  }
+
+  if( is_autoplay && autoplay_init( &p_session->autoplay, board_row_size, board_col_size, &autoplay_config ) != TETRIS_RET_OK ){
+    printf( "The automatic player does not support a %u x %u board\n", board_row_size, board_col_size );
+    _session_release( p_session );
+    return 1;
+  }
+
+  p_session->is_autoplay = is_autoplay;
+
+  if( graphics_init( board_row_size, board_col_size ) != 0 ){
+    _session_release( p_session );
+    return 1;
+  }
+
+  if( frame_buffer_init( &p_session->frames, board_row_size, board_col_size ) != TETRIS_RET_OK ){
+    LOG_DBG( "Failed to allocate the frame buffer\n" );
+    _session_release( p_session );
+    return 1;
+  }
+
+  if( input_init() != TETRIS_RET_OK ){
+    _session_release( p_session );
+    return 1;
+  }
+
+  event_loop_start_ns = platform_get_time_ns();
+
+  command_ring_init( &p_session->commands );
+  latency_stats_reset( &p_session->latency );
+  latency_install_dump_signal();
+  timer_wheel_init( &event_loop_wheel, 0 );
+  timer_init( &p_session->tick_timer, _session_tick, p_session );
+  timer_init( &p_session->render_timer, _session_render, p_session );
+
+  p_session->start_ms             = 0;
+  p_session->last_render_ms       = 0;
+  p_session->game_status          = TETRIS_GAME_NOT_OVER;
+  p_session->is_running           = true;
+  p_session->autoplay_piece_count = 0;
+  p_session->autoplay_path_count  = 0;
+  p_session->autoplay_path_idx    = 0;
+
+  /* The board is displayed right away, before the first gravity step */
+  _session_publish_frame( p_session );
+  timer_wheel_add( &event_loop_wheel, &p_session->tick_timer,
+                   _session_tick_time_ms( p_session, 1 + game_get_idle_ticks( p_session->p_game ) ) );
+
+  while( p_session->is_running ){
+    ticks_to_next = timer_wheel_ticks_to_next( &event_loop_wheel );
+    now_ms        = _get_elapsed_ms();
+
+    /* The poller sleeps until a key arrives or the next timer is due, whichever comes first */
+    if( ticks_to_next == TIMER_WHEEL_NO_TIMER ){
+      timeout_ms = INPUT_WAIT_FOREVER;
+    }
+    else if( event_loop_wheel.current_tick + ticks_to_next <= now_ms ){
+      timeout_ms = 0;
+    }
+    else{
+      ticks_to_next = event_loop_wheel.current_tick + ticks_to_next - now_ms;
+      timeout_ms    = ( ticks_to_next > EVENT_LOOP_POLL_MAX_MS ) ? EVENT_LOOP_POLL_MAX_MS : (int32_t) ticks_to_next;
+    }
+
+    if( input_wait_key( &key_event, timeout_ms ) == TETRIS_RET_OK ){
+      _session_handle_key( p_session, &key_event );
+    }
+
+    timer_wheel_advance( &event_loop_wheel, _get_elapsed_ms() );
+
+    if( latency_take_dump_request() ){
+      latency_stats_print( &p_session->latency );
+    }
+  }
+
+  _session_release( p_session );
+  latency_stats_print( &p_session->latency );
+
+  if( p_session->is_autoplay ){
+    autoplay_stats_print( &p_session->autoplay.stats, p_session->autoplay.config.depth );
+  }
+
+  return 0;
+}
+
+
+/* ==========================================================================================================
+ * Static Functions Declaration
+ */
+
+static void _session_tick( void *p_arg ){
+  EVENT_LOOP_SESSION_T *p_session = (EVENT_LOOP_SESSION_T *) p_arg;
+  tetris_game_t *p_game           = p_session->p_game;
+  COMMAND_STRUCT_T command;
+  uint64_t now_ms                 = _get_elapsed_ms();
+  uint64_t target_tick            = ( now_ms - p_session->start_ms ) / GAME_CONFIG_TICK_MS;
+  uint64_t due_tick               = ( p_session->tick_timer.expire_tick - p_session->start_ms ) / GAME_CONFIG_TICK_MS;
+  uint64_t step_count             = p_game->clock.step_count;
+  bool is_changed                 = false;
+
+  /* After a stall only a few ticks past the one the timer was armed for are caught up, the game slows down for a
+     moment instead of jumping ahead */
+  if( target_tick > due_tick + GAME_CONFIG_MAX_CATCH_UP_TICKS ){
+    p_session->start_ms += ( target_tick - due_tick - GAME_CONFIG_MAX_CATCH_UP_TICKS ) * GAME_CONFIG_TICK_MS;
+    target_tick          = due_tick + GAME_CONFIG_MAX_CATCH_UP_TICKS;
+  }
+
+  while( p_game->clock.tick < target_tick && p_session->game_status == TETRIS_GAME_NOT_OVER ){
+    /* The keys were pressed after the previous tick ran, their commands are applied at the start of the latest
+       tick due, in the order the keys were pressed (the ticks before it were idle) */
+    while( ( p_game->clock.tick + 1 ) == target_tick && command_pop( &p_session->commands, &command ) == TETRIS_RET_OK ){
+      game_apply_command( p_game, command.type );
+      replay_record_command( &p_session->replay, p_game->clock.tick, command.type );
+      frame_add_input_sample( &p_session->frames, command.timestamp_ns, platform_get_time_ns() );
+      is_changed = true;
+    }
+
+    p_session->game_status = game_tick( p_game );
+
+    if( p_session->game_status == TETRIS_GAME_NOT_OVER ){
+      replay_record_state( &p_session->replay, p_game );
+    }
+  }
+
+  if( is_changed || p_game->clock.step_count != step_count ){
+    _session_publish_frame( p_session );
+  }
+
+  if( p_session->game_status != TETRIS_GAME_NOT_OVER )
+    return;
+
+  /* The path of a new piece is applied on the next ticks, as keys would be */
+  if( p_session->is_autoplay && _session_autoplay( p_session ) ){
+    timer_wheel_add( &event_loop_wheel, &p_session->tick_timer, _session_tick_time_ms( p_session, p_game->clock.tick + 1 ) );
+    return;
+  }
+
+  /* Gravity, lock delay and speed-ups are all counted in ticks, so the ticks in between can be run in one go */
+  timer_wheel_add( &event_loop_wheel, &p_session->tick_timer,
+                   _session_tick_time_ms( p_session, p_game->clock.tick + 1 + game_get_idle_ticks( p_game ) ) );
+}
+
+
+static void _session_render( void *p_arg ){
+  EVENT_LOOP_SESSION_T *p_session = (EVENT_LOOP_SESSION_T *) p_arg;
+  const FRAME_STRUCT_T *p_frame   = frame_acquire( &p_session->frames );
+
+  if( p_frame == NULL )
+    return;
+
+  p_session->last_render_ms = _get_elapsed_ms();
+
+  if( graphics_draw_frame( p_frame ) != TETRIS_RET_OK ){
+    p_session->is_running = false;
+  }
+
+  latency_record_frame( &p_session->latency, p_frame, platform_get_time_ns() );
+}
+
+
+static void _session_handle_key( EVENT_LOOP_SESSION_T *p_session, const INPUT_KEY_EVENT_T *p_event ){
+  COMMAND_STRUCT_T command;
+  uint64_t next_tick_ms = 0;
+
+  LOG_INF( "You pressed: %c\n", p_event->key );
+
+  if( p_event->key == GAME_QUIT_CHAR ){
+    LOG_INF( "Quit\n" );
+    p_session->is_running = false;
+    return;
+  }
+
+  command.type         = command_from_key( p_event->key );
+  command.timestamp_ns = p_event->timestamp_ns;
+
+  if( command.type == GAME_COMMAND_LAST_IDX || p_session->game_status != TETRIS_GAME_NOT_OVER ||
+      p_session->is_autoplay )
+    return;
+
+  if( command_push( &p_session->commands, &command ) != TETRIS_RET_OK ){
+    LOG_WRN( "Command queue full, key %c dropped\n", p_event->key );
+    return;
+  }
+
+  /* The game clock only moves when the tick timer fires, the next tick is taken from the wheel time instead */
+  next_tick_ms = _session_tick_time_ms( p_session, ( ( _get_elapsed_ms() - p_session->start_ms ) / GAME_CONFIG_TICK_MS ) + 1 );
+
+  if( !timer_is_pending( &p_session->tick_timer ) || p_session->tick_timer.expire_tick > next_tick_ms ){
+    timer_wheel_add( &event_loop_wheel, &p_session->tick_timer, next_tick_ms );
+  }
+}
+
+
+static bool _session_autoplay( EVENT_LOOP_SESSION_T *p_session ){
+  tetris_game_t *p_game = p_session->p_game;
+  COMMAND_STRUCT_T command;
+  uint16_t first_idx    = 0;
+
+  if( p_game->board.has_current_piece && p_game->board.piece_count != p_session->autoplay_piece_count ){
+    p_session->autoplay_piece_count = p_game->board.piece_count;
+    p_session->autoplay_path_idx    = 0;
+
+    /* The loop blocks while the player searches, the deadline keeps it from missing the next gravity step */
+    if( autoplay_choose( &p_session->autoplay, p_game, autoplay_get_deadline_ns( p_game ), AUTOPLAY_NO_NODE_BUDGET,
+                         &p_session->p_autoplay_path, &p_session->autoplay_path_count ) != TETRIS_RET_OK ){
+      p_session->autoplay_path_count = 0;
+    }
+  }
+
+  command.timestamp_ns = platform_get_time_ns();
+  first_idx            = p_session->autoplay_path_idx;
+
+  while( p_session->autoplay_path_idx < p_session->autoplay_path_count ){
+    command.type = p_session->p_autoplay_path[p_session->autoplay_path_idx];
+
+    if( command_push( &p_session->commands, &command ) != TETRIS_RET_OK )
+      break;
+
+    p_session->autoplay_path_idx++;
+  }
+
+  return p_session->autoplay_path_idx != first_idx;
+}
+
+
+static void _session_publish_frame( EVENT_LOOP_SESSION_T *p_session ){
+  uint64_t render_ms = p_session->last_render_ms + GAME_CONFIG_RENDER_PERIOD_MS;
+  uint64_t now_ms    = _get_elapsed_ms();
+
+  frame_publish( &p_session->frames, p_session->p_game, p_session->game_status );
+
+  /* A frame already due is drawn on the next wheel tick, the ones published meanwhile replace it */
+  if( !timer_is_pending( &p_session->render_timer ) ){
+    timer_wheel_add( &event_loop_wheel, &p_session->render_timer, ( render_ms > now_ms ) ? render_ms : now_ms );
+  }
+}
+
+
+static uint64_t _session_tick_time_ms( EVENT_LOOP_SESSION_T *p_session, uint64_t tick ){
+  return p_session->start_ms + ( tick * GAME_CONFIG_TICK_MS );
+}
+
+
+static void _session_release( EVENT_LOOP_SESSION_T *p_session ){
+  /* The terminal is restored first, so that the messages printed from here on are readable */
+  input_deinit();
+  replay_writer_close( &p_session->replay, p_session->p_game );
+  graphics_deinit();
+  frame_buffer_deinit( &p_session->frames );
+  game_destroy( p_session->p_game );
+  p_session->p_game = NULL;
+
+  if( p_session->is_autoplay ){
+    autoplay_deinit( &p_session->autoplay );
+  }
+}
+
+
+static uint64_t _get_elapsed_ms( void ){
+  return ( platform_get_time_ns() - event_loop_start_ns ) / 1000000u;
+}
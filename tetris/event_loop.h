@@ -0,0 +1,34 @@
+/*
+ *  event_loop.h
+ *
+ *  Created on: 17-Oct-2026
+ *      Author: lucas-noce
+ */
+
+#ifndef _EVENT_LOOP_H_
+#define _EVENT_LOOP_H_
+
+#include <stdint.h>
+#include <stdbool.h>
+
+#include "autoplay.h"
+
+/*!
+  @brief        Runs a game on the calling thread only: a single poller waits for keys or for the next timer of the
+                session (simulation ticks and render deadlines), kept in a hierarchical timer wheel.
+
+  @param[in]    board_row_size: number of board rows, bottom border included.
+  @param[in]    board_col_size: number of board columns, borders included.
+  @param[in]    seed: seed of the sequence of pieces.
+  @param[in]    difficulty: difficulty of the game (from GAME_DIFFICULTIES_E), sets the gravity speed up and the
+                points of a row.
+  @param[in]    p_replay_path: file the game is recorded to, or NULL.
+  @param[in]    p_autoplay_config: search of the automatic player that moves the pieces (the keys only quit), or NULL
+                to play with the keys.
+
+  @returns      0 when the game ends or the player quits, 1 on initialization errors.
+*/
+int event_loop_run( uint16_t board_row_size, uint16_t board_col_size, uint64_t seed, uint8_t difficulty,
+                    const char *p_replay_path, const AUTOPLAY_CONFIG_T *p_autoplay_config );
+
+#endif /* _EVENT_LOOP_H_ */
@@ -0,0 +1,112 @@
+/*
+ *  frame.c
+ *
+ *  Created on: 17-Oct-2026
+ *      Author: lucas-noce
+ */
+
+/* ==========================================================================================================
+ * Includes
+ */
+
+#include <stdlib.h>
+#include <stdint.h>
+#include <string.h>
+#include <stdatomic.h>
+
+#include "main.h"
+#include "board.h"
+#include "score.h"
+#include "game.h"
+#include "frame.h"
+
+
+/* ==========================================================================================================
+ * Definitions
+ */
+
+#define FRAME_BUFFER_IDX_MASK   0x3u
+#define FRAME_BUFFER_FRESH_BIT  0x4u
+
+
+/* ==========================================================================================================
+ * Global Functions Declaration
+ */
+
+int8_t frame_buffer_init( FRAME_BUFFER_T *p_buffer, uint16_t row_size, uint16_t col_size ){
+  memset( p_buffer, 0, sizeof( FRAME_BUFFER_T ) );
+
+  for( uint8_t i=0; i<FRAME_BUFFER_SLOT_COUNT; i++ ){
+    p_buffer->slots[i].row_size    = row_size;
+    p_buffer->slots[i].col_size    = col_size;
+    p_buffer->slots[i].game_status = TETRIS_GAME_NOT_OVER;
+    p_buffer->slots[i].p_cells     = malloc( (size_t) row_size * col_size * sizeof( board_region_t ) );
+
+    if( p_buffer->slots[i].p_cells == NULL ){
+      frame_buffer_deinit( p_buffer );
+      return TETRIS_RET_ERR;
+    }
+  }
+
+  /* Slot 0 is the writer's, slot 1 the reader's and slot 2 holds the latest (nothing published yet) */
+  p_buffer->write_idx = 0;
+  p_buffer->read_idx  = 1;
+  atomic_init( &p_buffer->latest_state, 2 );
+
+  return TETRIS_RET_OK;
+}
+
+
+void frame_buffer_deinit( FRAME_BUFFER_T *p_buffer ){
+  for( uint8_t i=0; i<FRAME_BUFFER_SLOT_COUNT; i++ ){
+    free( p_buffer->slots[i].p_cells );
+    p_buffer->slots[i].p_cells = NULL;
+  }
+}
+
+
+void frame_publish( FRAME_BUFFER_T *p_buffer, tetris_game_t *p_game, uint8_t game_status ){
+  FRAME_STRUCT_T *p_frame = &p_buffer->slots[p_buffer->write_idx];
+  unsigned int previous_state = 0;
+
+  board_get_cells( p_game, p_frame->p_cells );
+  p_frame->score       = score_get_game_score( p_game );
+  p_frame->game_status = game_status;
+  p_frame->sequence    = p_buffer->sequence++;
+
+  /* The written slot becomes the latest, and the previous latest (taken or not) becomes the writer's */
+  previous_state      = atomic_exchange_explicit( &p_buffer->latest_state, p_buffer->write_idx | FRAME_BUFFER_FRESH_BIT,
+                                                  memory_order_acq_rel );
+  p_buffer->write_idx = previous_state & FRAME_BUFFER_IDX_MASK;
+
+  /* A slot that was still fresh was never drawn: its input samples are kept and go out with the next frame */
+  if( ( previous_state & FRAME_BUFFER_FRESH_BIT ) == 0 ){
+    p_buffer->slots[p_buffer->write_idx].input_sample_count = 0;
+  }
+}
+
+
+void frame_add_input_sample( FRAME_BUFFER_T *p_buffer, uint64_t capture_ns, uint64_t apply_ns ){
+  FRAME_STRUCT_T *p_frame = &p_buffer->slots[p_buffer->write_idx];
+
+  if( p_frame->input_sample_count >= FRAME_MAX_INPUT_SAMPLES )
+    return;
+
+  p_frame->input_samples[p_frame->input_sample_count].capture_ns = capture_ns;
+  p_frame->input_samples[p_frame->input_sample_count].apply_ns   = apply_ns;
+  p_frame->input_sample_count++;
+}
+
+
+const FRAME_STRUCT_T *frame_acquire( FRAME_BUFFER_T *p_buffer ){
+  unsigned int previous_state = 0;
+
+  if( ( atomic_load_explicit( &p_buffer->latest_state, memory_order_acquire ) & FRAME_BUFFER_FRESH_BIT ) == 0 )
+    return NULL;
+
+  /* The latest slot becomes the reader's, and the reader's previous slot is handed back as the latest (not fresh) */
+  previous_state     = atomic_exchange_explicit( &p_buffer->latest_state, p_buffer->read_idx, memory_order_acq_rel );
+  p_buffer->read_idx = previous_state & FRAME_BUFFER_IDX_MASK;
+
+  return &p_buffer->slots[p_buffer->read_idx];
+}
@@ -0,0 +1,155 @@
+/*
+ *  frame.h
+ *
+ *  Created on: 17-Oct-2026
+ *      Author: lucas-noce
+ */
+
+#ifndef _FRAME_H_
+#define _FRAME_H_
+
+
+/* ==========================================================================================================
+ * Includes
+ */
+
+#include <stdint.h>
+#include <stdatomic.h>
+
+#include "main.h"
+#include "board.h"
+
+
+/* ==========================================================================================================
+ * Definitions
+ */
+
+#define FRAME_BUFFER_SLOT_COUNT  3
+#define FRAME_MAX_INPUT_SAMPLES  32
+
+
+/* ==========================================================================================================
+ * Typedefs
+ */
+
+/*!
+  @brief        Timestamps of a player command on its way to the screen (platform_get_time_ns).
+
+  @param        capture_ns: when the key was read from the terminal.
+  @param        apply_ns: when the simulation applied the command to the game.
+*/
+typedef struct FRAME_INPUT_SAMPLE_TAG{
+  uint64_t capture_ns;
+  uint64_t apply_ns;
+} FRAME_INPUT_SAMPLE_T;
+
+/*!
+  @brief        Immutable picture of a game, captured by the simulation and consumed by the renderer.
+
+  @param        p_cells: row_size x col_size cells (from board_get_cells).
+  @param        row_size: number of board rows.
+  @param        col_size: number of board columns.
+  @param        score: score of the game when the frame was captured.
+  @param        game_status: TETRIS_GAME_OVER, TETRIS_GAME_NOT_OVER or TETRIS_GAME_WON.
+  @param        sequence: number of frames published before this one.
+  @param        input_samples: commands whose effect is first shown by this frame (including the ones of frames
+                dropped before being drawn).
+  @param        input_sample_count: number of valid input_samples.
+*/
+typedef struct FRAME_STRUCT_TAG{
+  board_region_t       *p_cells;
+  uint16_t             row_size;
+  uint16_t             col_size;
+  uint32_t             score;
+  uint8_t              game_status;
+  uint32_t             sequence;
+  FRAME_INPUT_SAMPLE_T input_samples[FRAME_MAX_INPUT_SAMPLES];
+  uint8_t              input_sample_count;
+} FRAME_STRUCT_T;
+
+/*!
+  @brief        Triple buffer of frames, with a single writer and a single reader that never wait for each other.
+
+  @param        slots: the frames. At any time one belongs to the writer, one to the reader and one is the latest
+                published frame.
+  @param        latest_state: index of the latest published slot, with FRAME_BUFFER_FRESH_BIT set when the reader
+                has not taken it yet.
+  @param        write_idx: slot owned by the writer.
+  @param        read_idx: slot owned by the reader.
+  @param        sequence: number of frames published so far.
+
+  @note         A writer that publishes faster than the reader consumes simply replaces the latest frame, so
+                frames are dropped instead of delaying the writer.
+*/
+typedef struct FRAME_BUFFER_TAG{
+  FRAME_STRUCT_T slots[FRAME_BUFFER_SLOT_COUNT];
+  atomic_uint    latest_state;
+  uint8_t        write_idx;
+  uint8_t        read_idx;
+  uint32_t       sequence;
+} FRAME_BUFFER_T;
+
+
+/* ==========================================================================================================
+ * Global Functions
+ */
+
+/*!
+  @brief        Allocates the frames of a triple buffer for a board of the given size.
+
+  @param[in]    p_buffer: pointer to the buffer.
+  @param[in]    row_size: number of board rows.
+  @param[in]    col_size: number of board columns.
+
+  @returns      One of the possible TETRIS_RET_x macro values (defined in main.h).
+*/
+int8_t frame_buffer_init( FRAME_BUFFER_T *p_buffer, uint16_t row_size, uint16_t col_size );
+
+/*!
+  @brief        Releases the frames of a triple buffer.
+
+  @param[in]    p_buffer: pointer to the buffer.
+
+  @returns      void
+*/
+void frame_buffer_deinit( FRAME_BUFFER_T *p_buffer );
+
+/*!
+  @brief        Captures the game into the writer slot and publishes it as the latest frame.
+
+  @param[in]    p_buffer: pointer to the buffer.
+  @param[in]    p_game: pointer to the game to be captured.
+  @param[in]    game_status: TETRIS_GAME_OVER, TETRIS_GAME_NOT_OVER or TETRIS_GAME_WON.
+
+  @returns      void
+
+  @warning      Only one thread may publish at a time.
+*/
+void frame_publish( FRAME_BUFFER_T *p_buffer, tetris_game_t *p_game, uint8_t game_status );
+
+/*!
+  @brief        Attaches the timestamps of an applied command to the frame being written, so the reader can measure
+                when its effect reached the screen. Samples beyond FRAME_MAX_INPUT_SAMPLES are dropped.
+
+  @param[in]    p_buffer: pointer to the buffer.
+  @param[in]    capture_ns: when the key was read from the terminal.
+  @param[in]    apply_ns: when the command was applied to the game.
+
+  @returns      void
+
+  @warning      Only the publishing thread may add samples.
+*/
+void frame_add_input_sample( FRAME_BUFFER_T *p_buffer, uint64_t capture_ns, uint64_t apply_ns );
+
+/*!
+  @brief        Takes the latest published frame, if the reader has not taken it yet.
+
+  @param[in]    p_buffer: pointer to the buffer.
+
+  @returns      Pointer to the frame, valid until the next call, or NULL if no new frame was published.
+
+  @warning      Only one thread may read.
+*/
+const FRAME_STRUCT_T *frame_acquire( FRAME_BUFFER_T *p_buffer );
+
+#endif /* _FRAME_H_ */
@@ -0,0 +1,254 @@
+/*
+ *  game.c
+ *
+ *  Created on: 17-Oct-2026
+ *      Author: lucas-noce
+ */
+
+/* ==========================================================================================================
+ * Includes
+ */
+
+#ifndef _WIN32
+#define _POSIX_C_SOURCE 200112L   // posix_memalign
+#endif /* _WIN32 */
+
+#include <stdlib.h>
+#include <stdint.h>
+#include <string.h>
+
+#ifdef _WIN32
+#include <malloc.h>
+#endif /* _WIN32 */
+
+#include "main.h"
+#include "game_config.h"
+#include "pieces.h"
+#include "board.h"
+#include "command.h"
+#include "score.h"
+#include "randomizer.h"
+#include "game.h"
+
+
+/* ==========================================================================================================
+ * Definitions
+ */
+
+#define GAME_SPEED_UP_TICKS  GAME_CONFIG_MS_TO_TICKS( TETRIS_GAME_INCREMENT_SPEED_DELAY_MS )
+
+#define GAME_STATE_HEADER_SIZE  ( sizeof( SCORE_STRUCT_T ) + sizeof( GAME_CLOCK_STRUCT_T ) + sizeof( RANDOMIZER_STRUCT_T ) )
+
+
+/* ==========================================================================================================
+ * Static variables
+ */
+
+static const float game_gravity_speed_rate[GAME_DIFFICULTY_LAST_IDX] = {
+  0.9, 0.75, 0.65, 0.5
+};
+
+
+/* ==========================================================================================================
+ * Static Function Prototypes
+ */
+
+/*!
+  @brief        Gets the number of ticks between gravity steps for the current piece.
+
+  @param[in]    p_game: pointer to the game.
+
+  @returns      The gravity period, or the lock delay if the piece rests on the stack.
+*/
+static uint32_t _get_step_period( tetris_game_t *p_game );
+
+
+/* ==========================================================================================================
+ * Global Functions Declaration
+ */
+
+tetris_game_t *game_create( uint16_t row_size, uint16_t col_size ){
+  tetris_game_t *p_game = game_aligned_alloc( sizeof( tetris_game_t ) );
+
+  if( p_game == NULL )
+    return NULL;
+
+  memset( p_game, 0, sizeof( tetris_game_t ) );
+
+  if( board_init( p_game, row_size, col_size ) != TETRIS_RET_OK ){
+    game_destroy( p_game );
+    return NULL;
+  }
+
+  game_clock_init( p_game );
+  game_set_seed( p_game, 0 );
+
+  return p_game;
+}
+
+
+void game_destroy( tetris_game_t *p_game ){
+  if( p_game == NULL )
+    return;
+
+  board_deinit( p_game );
+  game_aligned_free( p_game );
+}
+
+
+void game_set_seed( tetris_game_t *p_game, uint64_t seed ){
+  randomizer_init( &p_game->randomizer, seed );
+}
+
+
+void game_clock_init( tetris_game_t *p_game ){
+  GAME_CLOCK_STRUCT_T *p_clock = &p_game->clock;
+
+  p_clock->tick          = 0;
+  p_clock->step_count    = 0;
+  p_clock->gravity_ticks = GAME_CONFIG_MS_TO_TICKS( GAME_CONFIG_BOARD_REPOSITION_MS );
+  p_clock->step_counter  = 0;
+}
+
+
+uint8_t game_tick( tetris_game_t *p_game ){
+  GAME_CLOCK_STRUCT_T *p_clock = &p_game->clock;
+
+  p_clock->tick++;
+
+  if( ( p_clock->tick % GAME_SPEED_UP_TICKS ) == 0 ){
+    p_clock->gravity_ticks = (uint32_t) ( (float) p_clock->gravity_ticks * game_gravity_speed_rate[score_get_difficulty( p_game )] );
+
+    if( p_clock->gravity_ticks == 0 )
+      p_clock->gravity_ticks = 1;
+  }
+
+  p_clock->step_counter++;
+  if( p_clock->step_counter < _get_step_period( p_game ) )
+    return TETRIS_GAME_NOT_OVER;
+
+  p_clock->step_counter = 0;
+  p_clock->step_count++;
+
+  return game_step( p_game );
+}
+
+
+uint32_t game_get_idle_ticks( tetris_game_t *p_game ){
+  GAME_CLOCK_STRUCT_T *p_clock = &p_game->clock;
+  uint32_t step_period         = _get_step_period( p_game );
+  uint32_t ticks_to_step       = ( p_clock->step_counter < step_period ) ? ( step_period - p_clock->step_counter ) : 1;
+  uint32_t ticks_to_speed_up   = GAME_SPEED_UP_TICKS - (uint32_t) ( p_clock->tick % GAME_SPEED_UP_TICKS );
+
+  return ( ( ticks_to_step < ticks_to_speed_up ) ? ticks_to_step : ticks_to_speed_up ) - 1;
+}
+
+
+uint8_t game_step( tetris_game_t *p_game ){
+  if( fix_current_piece_on_board( p_game ) != TETRIS_RET_OK ){
+    RANDOMIZER_PIECE_T new_piece;
+    uint8_t ret = 0;
+
+    ret = check_complete_row( p_game );
+    if( ret != TETRIS_GAME_NOT_OVER ){
+      return ret;
+    }
+
+    LOG_INF( "fix piece\n" );
+
+    new_piece = randomizer_next_piece( &p_game->randomizer );
+
+    add_new_piece_to_board( p_game, new_piece.type, new_piece.rotation );
+  }
+
+  move_current_piece_through_board( p_game, BOARD_DIRECTION_DOWN );
+
+  return TETRIS_GAME_NOT_OVER;
+}
+
+
+int8_t game_apply_command( tetris_game_t *p_game, uint8_t command_type ){
+  switch( command_type ){
+    case GAME_COMMAND_MOVE_DOWN:
+      return move_current_piece_through_board( p_game, BOARD_DIRECTION_DOWN );
+
+    case GAME_COMMAND_MOVE_LEFT:
+      return move_current_piece_through_board( p_game, BOARD_DIRECTION_LEFT );
+
+    case GAME_COMMAND_MOVE_RIGHT:
+      return move_current_piece_through_board( p_game, BOARD_DIRECTION_RIGHT );
+
+    case GAME_COMMAND_ROTATE:
+      rotate_current_piece_through_board( p_game );
+      return TETRIS_RET_OK;
+
+    default:
+      return TETRIS_RET_ERR;
+  }
+}
+
+
+size_t game_state_size( tetris_game_t *p_game ){
+  return GAME_STATE_HEADER_SIZE + board_state_size( p_game );
+}
+
+
+void game_save_state( tetris_game_t *p_game, uint8_t *p_state ){
+  /* The score, clock and randomizer hold no pointers, they are saved as they are */
+  memcpy( p_state, &p_game->score, sizeof( SCORE_STRUCT_T ) );
+  memcpy( p_state + sizeof( SCORE_STRUCT_T ), &p_game->clock, sizeof( GAME_CLOCK_STRUCT_T ) );
+  memcpy( p_state + sizeof( SCORE_STRUCT_T ) + sizeof( GAME_CLOCK_STRUCT_T ), &p_game->randomizer,
+          sizeof( RANDOMIZER_STRUCT_T ) );
+
+  board_save_state( p_game, p_state + GAME_STATE_HEADER_SIZE );
+}
+
+
+int8_t game_load_state( tetris_game_t *p_game, const uint8_t *p_state, size_t size ){
+  if( size < GAME_STATE_HEADER_SIZE ||
+      board_load_state( p_game, p_state + GAME_STATE_HEADER_SIZE, size - GAME_STATE_HEADER_SIZE ) != TETRIS_RET_OK )
+    return TETRIS_RET_ERR;
+
+  memcpy( &p_game->score, p_state, sizeof( SCORE_STRUCT_T ) );
+  memcpy( &p_game->clock, p_state + sizeof( SCORE_STRUCT_T ), sizeof( GAME_CLOCK_STRUCT_T ) );
+  memcpy( &p_game->randomizer, p_state + sizeof( SCORE_STRUCT_T ) + sizeof( GAME_CLOCK_STRUCT_T ),
+          sizeof( RANDOMIZER_STRUCT_T ) );
+
+  return TETRIS_RET_OK;
+}
+
+
+void *game_aligned_alloc( size_t size ){
+#ifdef _WIN32
+  return _aligned_malloc( size, GAME_CONFIG_CACHE_LINE_SIZE );
+#else
+  void *p_memory = NULL;
+
+  if( posix_memalign( &p_memory, GAME_CONFIG_CACHE_LINE_SIZE, size ) != 0 )
+    return NULL;
+
+  return p_memory;
+#endif /* _WIN32 */
+}
+
+
+void game_aligned_free( void *p_memory ){
+#ifdef _WIN32
+  _aligned_free( p_memory );
+#else
+  free( p_memory );
+#endif /* _WIN32 */
+}
+
+
+/* ==========================================================================================================
+ * Static Functions Declaration
+ */
+
+static uint32_t _get_step_period( tetris_game_t *p_game ){
+  /* A piece resting on the stack waits the lock delay instead, which does not shrink as the game speeds up */
+  if( p_game->board.has_current_piece && p_game->board.current_piece.is_colliding )
+    return GAME_CONFIG_MS_TO_TICKS( GAME_CONFIG_LOCK_DELAY_MS );
+
+  return p_game->clock.gravity_ticks;
+}
@@ -0,0 +1,205 @@
+/*
+ *  game.h
+ *
+ *  Created on: 17-Oct-2026
+ *      Author: lucas-noce
+ */
+
+#ifndef _GAME_H_
+#define _GAME_H_
+
+
+/* ==========================================================================================================
+ * Includes
+ */
+
+#include <stdint.h>
+#include <stddef.h>
+
+#include "main.h"
+#include "game_config.h"
+#include "board.h"
+#include "score.h"
+#include "command.h"
+#include "randomizer.h"
+
+
+/* ==========================================================================================================
+ * Typedefs
+ */
+
+/*!
+  @brief        Holds the timing of a game, counted in simulation ticks (GAME_CONFIG_TICK_MS each) so that a game
+                fed the same commands at the same ticks always plays the same way.
+
+  @param        tick: number of ticks run so far.
+  @param        step_count: number of gravity steps run so far.
+  @param        gravity_ticks: ticks between gravity steps of a falling piece (shrinks as the game speeds up).
+  @param        step_counter: ticks since the last gravity step.
+*/
+typedef struct GAME_CLOCK_STRUCT_TAG{
+  uint64_t tick;
+  uint64_t step_count;
+  uint32_t gravity_ticks;
+  uint32_t step_counter;
+} GAME_CLOCK_STRUCT_T;
+
+/*!
+  @brief        Holds the whole state of one game, passed to every board_x and score_x function.
+
+  @param        board: the board and the piece moving through it.
+  @param        score: the score, speed and difficulty of the game.
+  @param        clock: the tick count and the gravity timing of the game.
+  @param        randomizer: deals the pieces of the game, from the game seed.
+
+  @note         The struct is aligned to (and its size is a multiple of) a cache line, so games allocated next to
+                each other, e.g. one per worker thread, never share a cache line.
+*/
+struct TETRIS_GAME_TAG{
+  _Alignas( GAME_CONFIG_CACHE_LINE_SIZE ) BOARD_STRUCT_T board;
+  SCORE_STRUCT_T score;
+  GAME_CLOCK_STRUCT_T clock;
+  RANDOMIZER_STRUCT_T randomizer;
+};
+
+_Static_assert( ( sizeof( tetris_game_t ) % GAME_CONFIG_CACHE_LINE_SIZE ) == 0,
+                "tetris_game_t must be a multiple of the cache line size" );
+
+
+/* ==========================================================================================================
+ * Global Functions
+ */
+
+/*!
+  @brief        Allocates and initializes a game with a board of the given size.
+
+  @param[in]    row_size: number of board rows, bottom border included.
+  @param[in]    col_size: number of board columns, borders included.
+
+  @returns      Pointer to the new game, or NULL if the size is invalid or the allocation failed.
+
+  @note         The game is seeded with 0, see game_set_seed.
+*/
+tetris_game_t *game_create( uint16_t row_size, uint16_t col_size );
+
+/*!
+  @brief        Releases a game created with game_create, along with its board storage.
+
+  @param[in]    p_game: pointer to the game (may be NULL).
+
+  @returns      void
+*/
+void game_destroy( tetris_game_t *p_game );
+
+/*!
+  @brief        Restarts the sequence of pieces of a game. Two games with the same seed get the same pieces, in the
+                same order and with the same spawn rotations.
+
+  @param[in]    p_game: pointer to the game.
+  @param[in]    seed: the seed.
+
+  @returns      void
+*/
+void game_set_seed( tetris_game_t *p_game, uint64_t seed );
+
+/*!
+  @brief        Resets the clock of a game to tick 0, at the initial gravity speed.
+
+  @param[in]    p_game: pointer to the game.
+
+  @returns      void
+*/
+void game_clock_init( tetris_game_t *p_game );
+
+/*!
+  @brief        Advances the game by one tick: runs a gravity step when one is due and speeds the game up every
+                TETRIS_GAME_INCREMENT_SPEED_DELAY_MS worth of ticks.
+
+  @param[in]    p_game: pointer to the game.
+
+  @returns      TETRIS_GAME_OVER, TETRIS_GAME_NOT_OVER or TETRIS_GAME_WON.
+
+  @note         Player commands for the tick must be applied (game_apply_command) before calling this function.
+*/
+uint8_t game_tick( tetris_game_t *p_game );
+
+/*!
+  @brief        Counts the coming ticks that only advance the clock, i.e. before the next gravity step or speed-up.
+                Without player commands, running them one by one or all at once later gives the same game.
+
+  @param[in]    p_game: pointer to the game.
+
+  @returns      Number of idle ticks (0 if the next tick does something).
+*/
+uint32_t game_get_idle_ticks( tetris_game_t *p_game );
+
+/*!
+  @brief        Advances the game by one gravity step: fixes the current piece if it can no longer fall, clears the
+                completed rows, spawns a new piece and moves the current piece down.
+
+  @param[in]    p_game: pointer to the game.
+
+  @returns      TETRIS_GAME_OVER, TETRIS_GAME_NOT_OVER or TETRIS_GAME_WON.
+*/
+uint8_t game_step( tetris_game_t *p_game );
+
+/*!
+  @brief        Applies a player command to the current piece.
+
+  @param[in]    p_game: pointer to the game.
+  @param[in]    command_type: one of the GAME_COMMANDS_E values.
+
+  @returns      One of the possible TETRIS_RET_x macro values (defined in main.h).
+*/
+int8_t game_apply_command( tetris_game_t *p_game, uint8_t command_type );
+
+/*!
+  @brief        Gets the number of bytes game_save_state writes, which only depends on the board size.
+
+  @param[in]    p_game: pointer to the game.
+
+  @returns      The size of the state.
+*/
+size_t game_state_size( tetris_game_t *p_game );
+
+/*!
+  @brief        Saves the whole state of a game (board, score, clock and randomizer) to a buffer, so it can be
+                resumed later with game_load_state.
+
+  @param[in]    p_game: pointer to the game.
+  @param[out]   p_state: buffer of game_state_size bytes.
+
+  @returns      void
+*/
+void game_save_state( tetris_game_t *p_game, uint8_t *p_state );
+
+/*!
+  @brief        Loads a state saved by game_save_state. The game then plays exactly as the saved one would have.
+
+  @param[in]    p_game: pointer to the game, with a board of the size of the saved one.
+  @param[in]    p_state: the state.
+  @param[in]    size: number of bytes in `p_state`.
+
+  @returns      TETRIS_RET_OK, or TETRIS_RET_ERR if the state does not match the size of the board.
+*/
+int8_t game_load_state( tetris_game_t *p_game, const uint8_t *p_state, size_t size );
+
+/*!
+  @brief        Allocates memory aligned to a cache line.
+
+  @param[in]    size: number of bytes to allocate.
+
+  @returns      Pointer to the memory, or NULL if the allocation failed. Must be released with game_aligned_free.
+*/
+void *game_aligned_alloc( size_t size );
+
+/*!
+  @brief        Releases memory allocated with game_aligned_alloc.
+
+  @param[in]    p_memory: pointer to the memory (may be NULL).
+
+  @returns      void
+*/
+void game_aligned_free( void *p_memory );
+
+#endif /* _GAME_H_ */
@@ -23,15 +23,37 @@
 #define GAME_PIECE_COLOR_BLUE     6
 #define GAME_PIECE_COLOR_COUNT    7
 
+/*!
+  @brief        ANSI escape sequences used to print each piece color.
+*/
+#define GAME_PRINT_COLOR_MAGENTA "\033[1;35m"
+#define GAME_PRINT_COLOR_RED     "\033[1;31m"
+#define GAME_PRINT_COLOR_YELLOW  "\033[1;33m"
+#define GAME_PRINT_COLOR_GREEN   "\033[1;32m"
+#define GAME_PRINT_COLOR_CYAN    "\033[1;36m"
+#define GAME_PRINT_COLOR_BLUE    "\033[1;34m"
+#define GAME_PRINT_COLOR_RESET   "\033[0m"
+
 #define GAME_MOVE_DOWN_CHAR   's'
 #define GAME_MOVE_LEFT_CHAR   'a'
 #define GAME_MOVE_RIGHT_CHAR  'd'
 #define GAME_ROTATE_CHAR      'r'
 #define GAME_QUIT_CHAR        'q'
 
-#define GAME_CONFIG_KEY_SAMPLE_RATE_MS    10
-#define GAME_CONFIG_BOARD_REPOSITION_MS   ( (uint64_t) 800 )
-#define GAME_CONFIG_PLAYER_MOVE_DELAY_MS  250
+#define GAME_CONFIG_CACHE_LINE_SIZE       64
+
+#define GAME_CONFIG_BOARD_ROW_SIZE        20
+#define GAME_CONFIG_BOARD_COL_SIZE        15
+
+#define GAME_CONFIG_TICK_MS               10
+#define GAME_CONFIG_MAX_CATCH_UP_TICKS    5     // ticks run back to back after a stall, the rest of the stall is dropped
+#define GAME_CONFIG_RENDER_PERIOD_MS      16    // event loop only, frames published meanwhile are drawn as one
+#define GAME_CONFIG_BOARD_REPOSITION_MS   800
+#define GAME_CONFIG_LOCK_DELAY_MS         400   // gravity period of a piece resting on the stack (fixed on the 2nd step)
+
+#define GAME_CONFIG_PREVIEW_SIZE          5     // next pieces known ahead of the spawn
+
+#define GAME_CONFIG_MS_TO_TICKS( ms )     ( ( ms ) / GAME_CONFIG_TICK_MS )
 
 #define GAME_CONFIG_PRINT_BOARD_PIECE_SQUARE_COLOR     GAME_PIECE_COLOR_YELLOW
 #define GAME_CONFIG_PRINT_BOARD_PIECE_T_COLOR          GAME_PIECE_COLOR_RED
@@ -12,17 +12,79 @@
 #include <stdlib.h>
 #include <stdio.h>
 #include <stdint.h>
-#include <time.h>
-#include <windows.h>
+#include <string.h>
 
 #include "main.h"
+#include "game_config.h"
 #include "score.h"
 #include "pieces.h"
 #include "board.h"
+#include "game.h"
+#include "frame.h"
+#include "platform.h"
 #include "graphics.h"
 
 
-static HANDLE h_graphics_mutex;
+/*
+  The terminal is 1-based, and each board cell takes 2 characters. The score is printed after an empty line below
+  the bottom border, and the cursor is parked 2 lines below it, where the end-of-game texts are printed.
+*/
+#define GRAPHICS_CLEAR_SCREEN       "\033[2J\033[H"
+#define GRAPHICS_CLEAR_LINE         "\033[K"
+#define GRAPHICS_CELL_WIDTH         2
+#define GRAPHICS_SCORE_LINE_OFFSET  2
+#define GRAPHICS_PARK_LINE_OFFSET   4
+
+/*
+  Worst case of a single cell: a cursor move ("\033[RRRRR;CCCCH"), a color change ("\033[1;3Xm") and the cell text.
+  The rest of the frame (screen clear, score and cursor park) fits in the extra bytes.
+*/
+#define GRAPHICS_MAX_CELL_BYTES     24
+#define GRAPHICS_EXTRA_FRAME_BYTES  128
+
+#define GRAPHICS_COLOR_DEFAULT      GAME_PIECE_COLOR_RESET
+
+#define GRAPHICS_APPEND_LITERAL( p_screen, text )  _graphics_append( p_screen, text, sizeof( text ) - 1 )
+
+
+/*!
+  @brief        Holds the cells currently displayed, so only the cells of a new frame that differ from them are
+                written to the terminal.
+
+  @param        p_displayed: cells currently displayed, same layout as the frame cells.
+  @param        row_size: number of board rows.
+  @param        col_size: number of board columns.
+  @param        displayed_score: score currently displayed.
+  @param        is_displayed: whether `p_displayed` matches the terminal, cleared to force a full redraw.
+  @param        p_output: bytes of the frame, written to the terminal at once.
+  @param        output_size: number of bytes in `p_output`.
+  @param        output_capacity: size of `p_output`, enough for a full redraw.
+  @param        output_color: color the terminal is printing with after the bytes in `p_output`.
+*/
+typedef struct GRAPHICS_SCREEN_TAG{
+  board_region_t *p_displayed;
+  uint16_t       row_size;
+  uint16_t       col_size;
+  uint32_t       displayed_score;
+  bool           is_displayed;
+  char           *p_output;
+  size_t         output_size;
+  size_t         output_capacity;
+  uint8_t        output_color;
+} GRAPHICS_SCREEN_T;
+
+
+static GRAPHICS_SCREEN_T graphics_screen;
+
+static const char *graphics_color_text[GAME_PIECE_COLOR_COUNT] = {
+  [GAME_PIECE_COLOR_RESET]   = GAME_PRINT_COLOR_RESET,
+  [GAME_PIECE_COLOR_MAGENTA] = GAME_PRINT_COLOR_MAGENTA,
+  [GAME_PIECE_COLOR_RED]     = GAME_PRINT_COLOR_RED,
+  [GAME_PIECE_COLOR_YELLOW]  = GAME_PRINT_COLOR_YELLOW,
+  [GAME_PIECE_COLOR_GREEN]   = GAME_PRINT_COLOR_GREEN,
+  [GAME_PIECE_COLOR_CYAN]    = GAME_PRINT_COLOR_CYAN,
+  [GAME_PIECE_COLOR_BLUE]    = GAME_PRINT_COLOR_BLUE,
+};
 
 static char *game_over_text[] = {
 "  _______      ___      .___  ___.  _______          ",
@@ -59,83 +121,64 @@ static char *you_win_text[] = {
 
 static void _graphics_print_game_over( void );
 static void _graphics_print_you_win( void );
+static void _graphics_draw_cells( const FRAME_STRUCT_T *p_frame );
+static void _graphics_draw_cell( GRAPHICS_SCREEN_T *p_screen, board_region_t cell, uint16_t row, uint16_t col );
+static void _graphics_append( GRAPHICS_SCREEN_T *p_screen, const char *p_text, size_t length );
+static void _graphics_append_number( GRAPHICS_SCREEN_T *p_screen, uint32_t number );
+static void _graphics_append_cursor( GRAPHICS_SCREEN_T *p_screen, uint32_t row, uint32_t col );
+static void _graphics_append_color( GRAPHICS_SCREEN_T *p_screen, uint8_t color );
+static void _graphics_flush_output( GRAPHICS_SCREEN_T *p_screen );
 
 
-uint8_t graphics_init( void ){
-  h_graphics_mutex = CreateMutex(NULL, FALSE, NULL);
+uint8_t graphics_init( uint16_t row_size, uint16_t col_size ){
+  graphics_screen.row_size     = row_size;
+  graphics_screen.col_size     = col_size;
+  graphics_screen.is_displayed = false;
+  graphics_screen.p_displayed  = malloc( (size_t) row_size * col_size * sizeof( board_region_t ) );
 
-  if( h_graphics_mutex == NULL ){
-    printf("Failed to create h_graphics_mutex. Error: %lu\n", GetLastError());
+  graphics_screen.output_size     = 0;
+  graphics_screen.output_color    = GRAPHICS_COLOR_DEFAULT;
+  graphics_screen.output_capacity = (size_t) row_size * col_size * GRAPHICS_MAX_CELL_BYTES + GRAPHICS_EXTRA_FRAME_BYTES;
+  graphics_screen.p_output        = malloc( graphics_screen.output_capacity );
+
+  if( graphics_screen.p_displayed == NULL || graphics_screen.p_output == NULL ){
+    printf("Failed to allocate the graphics frames\n");
     return 1;
   }
-  
-  board_init();
-  score_reset_to_zero();
+
+  platform_console_init();
 
   return 0;
 }
 
 void graphics_deinit( void ){
-  CloseHandle( h_graphics_mutex );
+  free( graphics_screen.p_displayed );
+  free( graphics_screen.p_output );
+  graphics_screen.p_displayed = NULL;
+  graphics_screen.p_output    = NULL;
 }
 
 
 void graphics_clear_screen( void ){
-  HANDLE hConsole = GetStdHandle( STD_OUTPUT_HANDLE );
-
-  CONSOLE_SCREEN_BUFFER_INFO csbi;
-  DWORD written;
-  DWORD consoleSize;
-
-  GetConsoleScreenBufferInfo( hConsole, &csbi );
-  consoleSize = csbi.dwSize.X * csbi.dwSize.Y;
-
-  FillConsoleOutputCharacter( hConsole, ' ', consoleSize, (COORD){0, 0}, &written );
-
-  SetConsoleCursorPosition( hConsole, (COORD){0, 0} );
+  platform_console_clear();
 }
 
 
-uint8_t graphics_print_game( bool try_fix ){
-  WaitForSingleObject( h_graphics_mutex, INFINITE );
+uint8_t graphics_draw_frame( const FRAME_STRUCT_T *p_frame ){
+  if( p_frame->game_status != TETRIS_GAME_NOT_OVER ){
+    graphics_clear_screen();
+    graphics_screen.is_displayed = false;
 
-  graphics_clear_screen();
+    if( p_frame->game_status == TETRIS_GAME_OVER )
+      _graphics_print_game_over();
+    else
+      _graphics_print_you_win();
 
-  if( try_fix ){
-    if( fix_current_piece_on_board() != TETRIS_RET_OK ){
-      uint8_t new_piece_param = 0;
-      int8_t ret = 0;
-      
-      ret = check_complete_row();
-      if( ret == TETRIS_GAME_OVER ){
-        _graphics_print_game_over();
-        return -TETRIS_RET_ERR;
-      }
-      else if( ret == TETRIS_GAME_WON ){
-        _graphics_print_you_win();
-        return -TETRIS_RET_ERR;
-      }
-
-      LOG_INF( "fix piece\n" );
-
-      srand( time( NULL ) );
-      new_piece_param = rand() % PIECE_SHAPE_LAST_IDX;
-      
-      add_new_piece_to_board( new_piece_param );
-
-      new_piece_param = rand() % 4;
-      for( uint8_t i=0; i<new_piece_param; i++ ){
-        rotate_current_piece_through_board();
-      }
-    }
-
-    move_current_piece_through_board( BOARD_DIRECTION_DOWN );
+    return -TETRIS_RET_ERR;
   }
-  
-  board_print();
-  score_print();
 
-  ReleaseMutex( h_graphics_mutex );
+  _graphics_draw_cells( p_frame );
+
   return TETRIS_RET_OK;
 }
 
@@ -153,4 +196,122 @@ static void _graphics_print_you_win( void ){
     LOG_GAME( "%s\n", you_win_text[i] );
   }
   LOG_GAME( "\n\n" );
-}
\ No newline at end of file
+}
+
+static void _graphics_draw_cells( const FRAME_STRUCT_T *p_frame ){
+  GRAPHICS_SCREEN_T *p_screen = &graphics_screen;
+  size_t cell_idx             = 0;
+  bool is_cursor_in_place     = false;
+
+  if( !p_screen->is_displayed ){
+    GRAPHICS_APPEND_LITERAL( p_screen, GRAPHICS_CLEAR_SCREEN );
+  }
+
+  for( uint16_t i=0; i<p_screen->row_size; i++ ){
+    is_cursor_in_place = false;
+
+    for( uint16_t j=0; j<p_screen->col_size; j++ ){
+      cell_idx = (size_t) i * p_screen->col_size + j;
+
+      if( p_screen->is_displayed && p_frame->p_cells[cell_idx] == p_screen->p_displayed[cell_idx] ){
+        is_cursor_in_place = false;
+        continue;
+      }
+
+      /* Neighbouring changed cells are written one after the other, with a single cursor move */
+      if( !is_cursor_in_place ){
+        _graphics_append_cursor( p_screen, i + 1, ( GRAPHICS_CELL_WIDTH * j ) + 1 );
+        is_cursor_in_place = true;
+      }
+
+      _graphics_draw_cell( p_screen, p_frame->p_cells[cell_idx], i, j );
+    }
+  }
+
+  _graphics_append_color( p_screen, GRAPHICS_COLOR_DEFAULT );
+
+  if( !p_screen->is_displayed || p_frame->score != p_screen->displayed_score ){
+    _graphics_append_cursor( p_screen, p_screen->row_size + GRAPHICS_SCORE_LINE_OFFSET, 1 );
+    GRAPHICS_APPEND_LITERAL( p_screen, "Score: " );
+    _graphics_append_number( p_screen, p_frame->score );
+    GRAPHICS_APPEND_LITERAL( p_screen, GRAPHICS_CLEAR_LINE );
+    p_screen->displayed_score = p_frame->score;
+  }
+
+  _graphics_append_cursor( p_screen, p_screen->row_size + GRAPHICS_PARK_LINE_OFFSET, 1 );
+  _graphics_flush_output( p_screen );
+
+  /* The frame belongs to the frame buffer, so the displayed cells are kept in a copy */
+  memcpy( p_screen->p_displayed, p_frame->p_cells, (size_t) p_screen->row_size * p_screen->col_size );
+  p_screen->is_displayed = true;
+}
+
+static void _graphics_draw_cell( GRAPHICS_SCREEN_T *p_screen, board_region_t cell, uint16_t row, uint16_t col ){
+  if( cell == BOARD_CELL_BORDER ){
+    _graphics_append_color( p_screen, GRAPHICS_COLOR_DEFAULT );
+
+    if( row == ( p_screen->row_size - 1 ) )
+      GRAPHICS_APPEND_LITERAL( p_screen, "* " );
+    else if( col == 0 )
+      GRAPHICS_APPEND_LITERAL( p_screen, "*|" );
+    else
+      GRAPHICS_APPEND_LITERAL( p_screen, "*" );
+  }
+  else if( cell == BOARD_CELL_EMPTY ){
+    _graphics_append_color( p_screen, GRAPHICS_COLOR_DEFAULT );
+    GRAPHICS_APPEND_LITERAL( p_screen, "_|" );
+  }
+  else if( cell < GAME_PIECE_COLOR_COUNT ){
+    /* The whole cell takes the piece color, so a run of cells of the same piece needs a single color change */
+    _graphics_append_color( p_screen, cell );
+    GRAPHICS_APPEND_LITERAL( p_screen, "#|" );
+  }
+}
+
+static void _graphics_append( GRAPHICS_SCREEN_T *p_screen, const char *p_text, size_t length ){
+  /* The buffer fits a full redraw, this only happens if a frame is somehow larger than that */
+  if( ( p_screen->output_size + length ) > p_screen->output_capacity ){
+    _graphics_flush_output( p_screen );
+  }
+
+  memcpy( &p_screen->p_output[p_screen->output_size], p_text, length );
+  p_screen->output_size += length;
+}
+
+static void _graphics_append_number( GRAPHICS_SCREEN_T *p_screen, uint32_t number ){
+  char text[10];
+  uint8_t first_digit = sizeof( text );
+
+  do{
+    text[--first_digit] = '0' + ( number % 10 );
+    number /= 10;
+  } while( number != 0 );
+
+  _graphics_append( p_screen, &text[first_digit], sizeof( text ) - first_digit );
+}
+
+static void _graphics_append_cursor( GRAPHICS_SCREEN_T *p_screen, uint32_t row, uint32_t col ){
+  GRAPHICS_APPEND_LITERAL( p_screen, "\033[" );
+  _graphics_append_number( p_screen, row );
+  GRAPHICS_APPEND_LITERAL( p_screen, ";" );
+  _graphics_append_number( p_screen, col );
+  GRAPHICS_APPEND_LITERAL( p_screen, "H" );
+}
+
+static void _graphics_append_color( GRAPHICS_SCREEN_T *p_screen, uint8_t color ){
+  if( color == p_screen->output_color )
+    return;
+
+  _graphics_append( p_screen, graphics_color_text[color], strlen( graphics_color_text[color] ) );
+  p_screen->output_color = color;
+}
+
+static void _graphics_flush_output( GRAPHICS_SCREEN_T *p_screen ){
+  if( p_screen->output_size == 0 )
+    return;
+
+  /* Text printed through stdio (e.g. the end-of-game texts) reaches the console before the frame */
+  platform_console_write( p_screen->p_output, p_screen->output_size );
+
+  p_screen->output_size = 0;
+}
@@ -7,15 +7,19 @@
 
 #include <stdlib.h>
 #include <stdint.h>
+#include <stdbool.h>
+
+#include "main.h"
+#include "frame.h"
 
 
 #ifndef _GRAPHICS_H_
 #define _GRAPHICS_H_
 
 
-uint8_t graphics_init( void );
+uint8_t graphics_init( uint16_t row_size, uint16_t col_size );
 void graphics_deinit( void );
 void graphics_clear_screen( void );
-uint8_t graphics_print_game( bool try_fix );
+uint8_t graphics_draw_frame( const FRAME_STRUCT_T *p_frame );
 
 #endif /* _GRAPHICS_H_ */
\ No newline at end of file
@@ -0,0 +1,230 @@
+/*
+ *  input.c
+ *
+ *  Created on: 17-Oct-2026
+ *      Author: lucas-noce
+ */
+
+/* ==========================================================================================================
+ * Includes
+ */
+
+#ifndef _WIN32
+#define _POSIX_C_SOURCE 200809L   // poll
+#endif /* _WIN32 */
+
+#include <stdlib.h>
+#include <stdio.h>
+#include <stdint.h>
+#include <stdbool.h>
+
+#ifdef _WIN32
+#include <windows.h>
+#else
+#include <poll.h>
+#include <termios.h>
+#include <unistd.h>
+#endif /* _WIN32 */
+
+#include "main.h"
+#include "platform.h"
+#include "input.h"
+
+
+/* ==========================================================================================================
+ * Definitions
+ */
+
+#define INPUT_READ_CHUNK_SIZE  32
+
+
+/* ==========================================================================================================
+ * Static Typedefs
+ */
+
+/*!
+  @brief        Keys read from the terminal and not returned yet.
+
+  @param        events: ring of key events.
+  @param        head: index of the next event to be returned (wraps around INPUT_QUEUE_SIZE).
+  @param        tail: index where the next key read is stored (wraps around INPUT_QUEUE_SIZE).
+*/
+typedef struct INPUT_QUEUE_TAG{
+  INPUT_KEY_EVENT_T events[INPUT_QUEUE_SIZE];
+  uint32_t          head;
+  uint32_t          tail;
+} INPUT_QUEUE_T;
+
+
+/* ==========================================================================================================
+ * Static variables
+ */
+
+static INPUT_QUEUE_T input_queue;
+
+#ifdef _WIN32
+static HANDLE h_input;
+static DWORD input_saved_mode;
+#else
+static struct termios input_saved_mode;
+#endif /* _WIN32 */
+
+static bool input_is_raw = false;
+
+
+/* ==========================================================================================================
+ * Static Function Prototypes
+ */
+
+/*!
+  @brief        Adds a key to the queue. When the queue is full the key is dropped, since the player is pressing
+                keys faster than the game can take them.
+
+  @param[in]    key: the character of the key.
+  @param[in]    timestamp_ns: time at which the key was read.
+
+  @returns      void
+*/
+static void _input_queue_push( char key, uint64_t timestamp_ns );
+
+/*!
+  @brief        Blocks until the terminal has input, then moves every key available into the queue.
+
+  @param[in]    timeout_ms: maximum time to wait, or INPUT_WAIT_FOREVER.
+
+  @returns      One of the possible TETRIS_RET_x macro values (defined in main.h).
+*/
+static int8_t _input_read_keys( int32_t timeout_ms );
+
+
+/* ==========================================================================================================
+ * Global Functions Declaration
+ */
+
+int8_t input_init( void ){
+  input_queue.head = 0;
+  input_queue.tail = 0;
+
+#ifdef _WIN32
+  h_input = GetStdHandle( STD_INPUT_HANDLE );
+
+  if( !GetConsoleMode( h_input, &input_saved_mode ) ){
+    LOG_WRN( "Input is not a console\n" );
+    return TETRIS_RET_ERR;
+  }
+
+  SetConsoleMode( h_input, input_saved_mode & ~( ENABLE_LINE_INPUT | ENABLE_ECHO_INPUT ) );
+#else
+  struct termios raw_mode;
+
+  if( tcgetattr( STDIN_FILENO, &input_saved_mode ) != 0 ){
+    LOG_WRN( "Input is not a terminal\n" );
+    return TETRIS_RET_ERR;
+  }
+
+  /* No line buffering and no echo, read() returns as soon as a single byte is available */
+  raw_mode              = input_saved_mode;
+  raw_mode.c_lflag     &= ~( ICANON | ECHO );
+  raw_mode.c_cc[VMIN]   = 1;
+  raw_mode.c_cc[VTIME]  = 0;
+
+  tcsetattr( STDIN_FILENO, TCSANOW, &raw_mode );
+#endif /* _WIN32 */
+
+  input_is_raw = true;
+
+  return TETRIS_RET_OK;
+}
+
+
+void input_deinit( void ){
+  if( !input_is_raw )
+    return;
+
+#ifdef _WIN32
+  SetConsoleMode( h_input, input_saved_mode );
+#else
+  tcsetattr( STDIN_FILENO, TCSANOW, &input_saved_mode );
+#endif /* _WIN32 */
+
+  input_is_raw = false;
+}
+
+
+int8_t input_wait_key( INPUT_KEY_EVENT_T *p_event, int32_t timeout_ms ){
+  if( input_queue.head == input_queue.tail ){
+    if( _input_read_keys( timeout_ms ) != TETRIS_RET_OK || input_queue.head == input_queue.tail ){
+      return TETRIS_RET_ERR;
+    }
+  }
+
+  *p_event = input_queue.events[input_queue.head % INPUT_QUEUE_SIZE];
+  input_queue.head++;
+
+  return TETRIS_RET_OK;
+}
+
+
+/* ==========================================================================================================
+ * Static Functions Declaration
+ */
+
+static void _input_queue_push( char key, uint64_t timestamp_ns ){
+  if( ( input_queue.tail - input_queue.head ) >= INPUT_QUEUE_SIZE ){
+    LOG_DBG( "Input queue full, key %c dropped\n", key );
+    return;
+  }
+
+  input_queue.events[input_queue.tail % INPUT_QUEUE_SIZE].key          = key;
+  input_queue.events[input_queue.tail % INPUT_QUEUE_SIZE].timestamp_ns = timestamp_ns;
+  input_queue.tail++;
+}
+
+
+static int8_t _input_read_keys( int32_t timeout_ms ){
+  uint64_t timestamp_ns = 0;
+
+#ifdef _WIN32
+  INPUT_RECORD records[INPUT_READ_CHUNK_SIZE];
+  DWORD record_count = 0;
+  DWORD wait_ms      = ( timeout_ms == INPUT_WAIT_FOREVER ) ? INFINITE : (DWORD) timeout_ms;
+
+  /* The console input handle is signaled while it has unread events (keys, but also focus and mouse events) */
+  if( WaitForSingleObject( h_input, wait_ms ) != WAIT_OBJECT_0 )
+    return TETRIS_RET_ERR;
+
+  if( !ReadConsoleInputA( h_input, records, INPUT_READ_CHUNK_SIZE, &record_count ) )
+    return TETRIS_RET_ERR;
+
+  timestamp_ns = platform_get_time_ns();
+
+  for( DWORD i=0; i<record_count; i++ ){
+    if( records[i].EventType != KEY_EVENT || !records[i].Event.KeyEvent.bKeyDown ||
+        records[i].Event.KeyEvent.uChar.AsciiChar == 0 )
+      continue;
+
+    for( WORD j=0; j<records[i].Event.KeyEvent.wRepeatCount; j++ ){
+      _input_queue_push( records[i].Event.KeyEvent.uChar.AsciiChar, timestamp_ns );
+    }
+  }
+#else
+  struct pollfd input_fd = { .fd = STDIN_FILENO, .events = POLLIN };
+  char keys[INPUT_READ_CHUNK_SIZE];
+  ssize_t key_count = 0;
+
+  if( poll( &input_fd, 1, timeout_ms ) <= 0 )
+    return TETRIS_RET_ERR;
+
+  key_count = read( STDIN_FILENO, keys, sizeof( keys ) );
+  if( key_count <= 0 )
+    return TETRIS_RET_ERR;
+
+  timestamp_ns = platform_get_time_ns();
+
+  for( ssize_t i=0; i<key_count; i++ ){
+    _input_queue_push( keys[i], timestamp_ns );
+  }
+#endif /* _WIN32 */
+
+  return TETRIS_RET_OK;
+}
@@ -0,0 +1,75 @@
+/*
+ *  input.h
+ *
+ *  Created on: 17-Oct-2026
+ *      Author: lucas-noce
+ */
+
+#ifndef _INPUT_H_
+#define _INPUT_H_
+
+
+/* ==========================================================================================================
+ * Includes
+ */
+
+#include <stdint.h>
+
+#include "main.h"
+
+
+/* ==========================================================================================================
+ * Definitions
+ */
+
+#define INPUT_WAIT_FOREVER  -1
+
+#define INPUT_QUEUE_SIZE    64  // must be a power of 2
+
+
+/* ==========================================================================================================
+ * Typedefs
+ */
+
+/*!
+  @brief        A key pressed by the player.
+
+  @param        key: the character of the key.
+  @param        timestamp_ns: time at which the key was read from the terminal (platform_get_time_ns).
+*/
+typedef struct INPUT_KEY_EVENT_TAG{
+  char     key;
+  uint64_t timestamp_ns;
+} INPUT_KEY_EVENT_T;
+
+
+/* ==========================================================================================================
+ * Global Functions
+ */
+
+/*!
+  @brief        Puts the terminal in raw mode, so keys are delivered one by one and without echo.
+
+  @returns      One of the possible TETRIS_RET_x macro values (defined in main.h).
+*/
+int8_t input_init( void );
+
+/*!
+  @brief        Restores the terminal mode saved by input_init.
+
+  @returns      void
+*/
+void input_deinit( void );
+
+/*!
+  @brief        Blocks until a key is pressed, without polling. Keys pressed in a burst are queued and returned in
+                order by the next calls.
+
+  @param[out]   p_event: the oldest key pressed and not returned yet.
+  @param[in]    timeout_ms: maximum time to wait, or INPUT_WAIT_FOREVER.
+
+  @returns      TETRIS_RET_OK if a key was returned, TETRIS_RET_ERR on timeout or error.
+*/
+int8_t input_wait_key( INPUT_KEY_EVENT_T *p_event, int32_t timeout_ms );
+
+#endif /* _INPUT_H_ */
@@ -0,0 +1,203 @@
+/*
+ *  latency.c
+ *
+ *  Created on: 17-Oct-2026
+ *      Author: lucas-noce
+ */
+
+/* ==========================================================================================================
+ * Includes
+ */
+
+#include <stdlib.h>
+#include <stdio.h>
+#include <stdint.h>
+#include <stdbool.h>
+#include <string.h>
+#include <signal.h>
+
+#include "main.h"
+#include "frame.h"
+#include "latency.h"
+
+
+/* ==========================================================================================================
+ * Definitions
+ */
+
+#if defined( SIGUSR1 )
+#define LATENCY_DUMP_SIGNAL  SIGUSR1
+#elif defined( SIGBREAK )
+#define LATENCY_DUMP_SIGNAL  SIGBREAK
+#endif
+
+
+/* ==========================================================================================================
+ * Static variables
+ */
+
+static volatile sig_atomic_t latency_dump_requested = 0;
+
+
+/* ==========================================================================================================
+ * Static Function Prototypes
+ */
+
+/*!
+  @brief        Gets the bucket a value falls in.
+
+  @param[in]    value_ns: the value.
+
+  @returns      The bucket index, below LATENCY_BUCKET_COUNT.
+*/
+static uint32_t _get_bucket_index( uint64_t value_ns );
+
+/*!
+  @brief        Gets the highest value that falls in a bucket.
+
+  @param[in]    index: the bucket index.
+
+  @returns      The value.
+*/
+static uint64_t _get_bucket_highest_value( uint32_t index );
+
+/*!
+  @brief        Prints one histogram line.
+
+  @param[in]    p_name: name of the measured interval.
+  @param[in]    p_histogram: pointer to the histogram.
+
+  @returns      void
+*/
+static void _print_histogram( const char *p_name, const LATENCY_HISTOGRAM_T *p_histogram );
+
+static void _dump_signal_handler( int signal_number );
+
+
+/* ==========================================================================================================
+ * Global Functions Declaration
+ */
+
+void latency_stats_reset( LATENCY_STATS_T *p_stats ){
+  memset( p_stats, 0, sizeof( LATENCY_STATS_T ) );
+}
+
+
+void latency_record_frame( LATENCY_STATS_T *p_stats, const FRAME_STRUCT_T *p_frame, uint64_t flush_ns ){
+  const FRAME_INPUT_SAMPLE_T *p_sample = NULL;
+
+  for( uint8_t i=0; i<p_frame->input_sample_count; i++ ){
+    p_sample = &p_frame->input_samples[i];
+
+    latency_histogram_record( &p_stats->capture_to_apply, p_sample->apply_ns - p_sample->capture_ns );
+    latency_histogram_record( &p_stats->apply_to_flush, flush_ns - p_sample->apply_ns );
+    latency_histogram_record( &p_stats->capture_to_flush, flush_ns - p_sample->capture_ns );
+  }
+}
+
+
+void latency_stats_print( const LATENCY_STATS_T *p_stats ){
+  fprintf( stderr, "input latency (us)        count        p50        p99        max\n" );
+  _print_histogram( "key -> simulation", &p_stats->capture_to_apply );
+  _print_histogram( "simulation -> screen", &p_stats->apply_to_flush );
+  _print_histogram( "key -> screen", &p_stats->capture_to_flush );
+}
+
+
+void latency_histogram_record( LATENCY_HISTOGRAM_T *p_histogram, uint64_t value_ns ){
+  p_histogram->counts[_get_bucket_index( value_ns )]++;
+  p_histogram->total_count++;
+
+  if( value_ns > p_histogram->max_ns )
+    p_histogram->max_ns = value_ns;
+}
+
+
+uint64_t latency_histogram_percentile( const LATENCY_HISTOGRAM_T *p_histogram, double percentile ){
+  uint64_t target_count = 0;
+  uint64_t count        = 0;
+  uint64_t value        = 0;
+
+  if( p_histogram->total_count == 0 )
+    return 0;
+
+  target_count = (uint64_t) ( ( percentile / 100.0 ) * (double) p_histogram->total_count + 0.5 );
+  if( target_count == 0 )
+    target_count = 1;
+
+  for( uint32_t i=0; i<LATENCY_BUCKET_COUNT; i++ ){
+    count += p_histogram->counts[i];
+
+    if( count >= target_count ){
+      value = _get_bucket_highest_value( i );
+      return ( value < p_histogram->max_ns ) ? value : p_histogram->max_ns;
+    }
+  }
+
+  return p_histogram->max_ns;
+}
+
+
+void latency_install_dump_signal( void ){
+#ifdef LATENCY_DUMP_SIGNAL
+  signal( LATENCY_DUMP_SIGNAL, _dump_signal_handler );
+#endif /* LATENCY_DUMP_SIGNAL */
+}
+
+
+bool latency_take_dump_request( void ){
+  if( !latency_dump_requested )
+    return false;
+
+  latency_dump_requested = 0;
+  return true;
+}
+
+
+/* ==========================================================================================================
+ * Static Functions Declaration
+ */
+
+static uint32_t _get_bucket_index( uint64_t value_ns ){
+  uint32_t shift = 0;
+
+  /* Values with no bit above the sub-bucket bits are kept exactly */
+  if( value_ns < LATENCY_SUB_BUCKET_COUNT )
+    return (uint32_t) value_ns;
+
+  /* Otherwise the highest set bit picks the power of 2, and the LATENCY_SUB_BUCKET_BITS bits below it the bucket */
+  shift = (uint32_t) ( 63 - __builtin_clzll( value_ns ) ) - LATENCY_SUB_BUCKET_BITS;
+
+  return ( ( shift + 1 ) * LATENCY_SUB_BUCKET_COUNT ) + (uint32_t) ( ( value_ns >> shift ) & ( LATENCY_SUB_BUCKET_COUNT - 1 ) );
+}
+
+
+static uint64_t _get_bucket_highest_value( uint32_t index ){
+  uint32_t shift     = 0;
+  uint64_t sub_value = 0;
+
+  if( index < LATENCY_SUB_BUCKET_COUNT )
+    return index;
+
+  shift     = ( index / LATENCY_SUB_BUCKET_COUNT ) - 1;
+  sub_value = LATENCY_SUB_BUCKET_COUNT + ( index % LATENCY_SUB_BUCKET_COUNT );
+
+  return ( ( sub_value + 1 ) << shift ) - 1;
+}
+
+
+static void _print_histogram( const char *p_name, const LATENCY_HISTOGRAM_T *p_histogram ){
+  fprintf( stderr, "%-22s %10llu %10.1f %10.1f %10.1f\n", p_name,
+           (unsigned long long) p_histogram->total_count,
+           (double) latency_histogram_percentile( p_histogram, 50.0 ) / 1000.0,
+           (double) latency_histogram_percentile( p_histogram, 99.0 ) / 1000.0,
+           (double) p_histogram->max_ns / 1000.0 );
+}
+
+
+static void _dump_signal_handler( int signal_number ){
+  latency_dump_requested = 1;
+
+  /* Some platforms reset the handler once it runs */
+  signal( signal_number, _dump_signal_handler );
+}
@@ -0,0 +1,132 @@
+/*
+ *  latency.h
+ *
+ *  Created on: 17-Oct-2026
+ *      Author: lucas-noce
+ */
+
+#ifndef _LATENCY_H_
+#define _LATENCY_H_
+
+
+/* ==========================================================================================================
+ * Includes
+ */
+
+#include <stdint.h>
+#include <stdbool.h>
+
+#include "main.h"
+#include "frame.h"
+
+
+/* ==========================================================================================================
+ * Definitions
+ */
+
+/* Each power of 2 is split in 2^LATENCY_SUB_BUCKET_BITS linear buckets: values are kept within ~3% */
+#define LATENCY_SUB_BUCKET_BITS   5
+#define LATENCY_SUB_BUCKET_COUNT  ( 1u << LATENCY_SUB_BUCKET_BITS )
+#define LATENCY_BUCKET_COUNT      ( ( 64 - LATENCY_SUB_BUCKET_BITS + 1 ) * LATENCY_SUB_BUCKET_COUNT )
+
+
+/* ==========================================================================================================
+ * Typedefs
+ */
+
+/*!
+  @brief        Log-linear (HDR style) histogram of durations in nanoseconds, with a fixed relative precision from
+                1 ns up to hours.
+
+  @param        counts: number of values recorded in each bucket.
+  @param        total_count: number of values recorded.
+  @param        max_ns: largest value recorded (exact).
+*/
+typedef struct LATENCY_HISTOGRAM_TAG{
+  uint64_t counts[LATENCY_BUCKET_COUNT];
+  uint64_t total_count;
+  uint64_t max_ns;
+} LATENCY_HISTOGRAM_T;
+
+/*!
+  @brief        Input latency of one game session.
+
+  @param        capture_to_apply: from the key read to the command applied by the simulation.
+  @param        apply_to_flush: from the command applied to the frame showing it written to the terminal.
+  @param        capture_to_flush: from the key read to the frame written to the terminal.
+*/
+typedef struct LATENCY_STATS_TAG{
+  LATENCY_HISTOGRAM_T capture_to_apply;
+  LATENCY_HISTOGRAM_T apply_to_flush;
+  LATENCY_HISTOGRAM_T capture_to_flush;
+} LATENCY_STATS_T;
+
+
+/* ==========================================================================================================
+ * Global Functions
+ */
+
+/*!
+  @brief        Empties the histograms of a session.
+
+  @param[in]    p_stats: pointer to the session stats.
+
+  @returns      void
+*/
+void latency_stats_reset( LATENCY_STATS_T *p_stats );
+
+/*!
+  @brief        Records the input samples carried by a frame that was just written to the terminal.
+
+  @param[in]    p_stats: pointer to the session stats.
+  @param[in]    p_frame: the frame drawn.
+  @param[in]    flush_ns: when the frame write returned (platform_get_time_ns).
+
+  @returns      void
+*/
+void latency_record_frame( LATENCY_STATS_T *p_stats, const FRAME_STRUCT_T *p_frame, uint64_t flush_ns );
+
+/*!
+  @brief        Prints the count, p50, p99 and max of each histogram of a session to stderr.
+
+  @param[in]    p_stats: pointer to the session stats.
+
+  @returns      void
+*/
+void latency_stats_print( const LATENCY_STATS_T *p_stats );
+
+/*!
+  @brief        Adds a value to a histogram.
+
+  @param[in]    p_histogram: pointer to the histogram.
+  @param[in]    value_ns: the duration.
+
+  @returns      void
+*/
+void latency_histogram_record( LATENCY_HISTOGRAM_T *p_histogram, uint64_t value_ns );
+
+/*!
+  @brief        Gets the value below which a given percentage of the recorded values fall.
+
+  @param[in]    p_histogram: pointer to the histogram.
+  @param[in]    percentile: from 0 to 100.
+
+  @returns      The highest value of the bucket holding the percentile (never above the max), 0 if empty.
+*/
+uint64_t latency_histogram_percentile( const LATENCY_HISTOGRAM_T *p_histogram, double percentile );
+
+/*!
+  @brief        Makes a signal (SIGUSR1 on POSIX, SIGBREAK on Windows) request a dump of the latency stats.
+
+  @returns      void
+*/
+void latency_install_dump_signal( void );
+
+/*!
+  @brief        Checks and clears a dump request made by the signal.
+
+  @returns      true if the stats should be printed now.
+*/
+bool latency_take_dump_request( void );
+
+#endif /* _LATENCY_H_ */
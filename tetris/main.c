@@ -7,26 +7,119 @@
 
 #include <stdlib.h>
 #include <stdio.h>
-#include <windows.h>
+#include <stdint.h>
+#include <stdbool.h>
+#include <string.h>
 
 #include "main.h"
+#include "game_config.h"
 #include "pieces.h"
 #include "board.h"
+#include "score.h"
+#include "game.h"
+#include "platform.h"
+#include "autoplay.h"
 #include "main_loop.h"
+#include "event_loop.h"
 
 void test_function( void );
+static uint16_t _parse_number( const char *p_value, uint16_t default_value );
+static uint64_t _parse_seed( const char *p_value, uint64_t default_seed );
 
-int main( void ){
-  main_loop_init();
+int main( int argc, char *argv[] ){
+  uint16_t board_row_size   = GAME_CONFIG_BOARD_ROW_SIZE;
+  uint16_t board_col_size   = GAME_CONFIG_BOARD_COL_SIZE;
+  bool is_single_threaded   = false;
+  bool is_autoplay          = false;
+  AUTOPLAY_CONFIG_T autoplay_config = {
+    .max_workers = 0,
+    .depth       = AUTOPLAY_DEFAULT_DEPTH,
+    .beam_width  = AUTOPLAY_DEFAULT_BEAM_WIDTH
+  };
+  uint8_t difficulty        = GAME_DIFFICULTY_EASY;
+  uint64_t seed             = platform_get_time_ns();
+  const char *p_replay_path = NULL;
+
+  /* Board size options: --rows N --cols N (borders included), --single-thread runs the game in an event loop,
+     --seed N replays the pieces of a previous game, --record FILE records the game to a replay file,
+     --autoplay lets the automatic player move the pieces, looking ahead at N pieces of the preview with
+     --lookahead N and keeping the N best boards at each of them with --beam N, --difficulty N (from 0, easy,
+     to 3, expert) */
+  for( int i=1; i<argc; i++ ){
+    if( strcmp( argv[i], "--rows" ) == 0 && i < (argc - 1) ){
+      board_row_size = _parse_number( argv[++i], board_row_size );
+    }
+    else if( strcmp( argv[i], "--cols" ) == 0 && i < (argc - 1) ){
+      board_col_size = _parse_number( argv[++i], board_col_size );
+    }
+    else if( strcmp( argv[i], "--seed" ) == 0 && i < (argc - 1) ){
+      seed = _parse_seed( argv[++i], seed );
+    }
+    else if( strcmp( argv[i], "--record" ) == 0 && i < (argc - 1) ){
+      p_replay_path = argv[++i];
+    }
+    else if( strcmp( argv[i], "--difficulty" ) == 0 && i < (argc - 1) ){
+      uint16_t value = _parse_number( argv[++i], difficulty );
+      difficulty     = (uint8_t) ( ( value < GAME_DIFFICULTY_LAST_IDX ) ? value : difficulty );
+    }
+    else if( strcmp( argv[i], "--single-thread" ) == 0 ){
+      is_single_threaded = true;
+    }
+    else if( strcmp( argv[i], "--autoplay" ) == 0 ){
+      is_autoplay = true;
+    }
+    else if( strcmp( argv[i], "--lookahead" ) == 0 && i < (argc - 1) ){
+      uint16_t lookahead    = _parse_number( argv[++i], autoplay_config.depth - 1 );
+      autoplay_config.depth = (uint8_t) ( ( lookahead < AUTOPLAY_MAX_DEPTH ) ? lookahead + 1 : AUTOPLAY_MAX_DEPTH );
+    }
+    else if( strcmp( argv[i], "--beam" ) == 0 && i < (argc - 1) ){
+      autoplay_config.beam_width = _parse_number( argv[++i], autoplay_config.beam_width );
+    }
+  }
+
+  int ret = 0;
+
+  if( is_single_threaded ){
+    ret = event_loop_run( board_row_size, board_col_size, seed, difficulty, p_replay_path,
+                          is_autoplay ? &autoplay_config : NULL );
+  }
+  else{
+    ret = main_loop_init( board_row_size, board_col_size, seed, difficulty, p_replay_path,
+                          is_autoplay ? &autoplay_config : NULL );
+  }
+
+  fprintf( stderr, "Seed: %llu\n", (unsigned long long) seed );
   // test_function();
 
-  return 0;
+  return ret;
+}
+
+static uint16_t _parse_number( const char *p_value, uint16_t default_value ){
+  char *p_end = NULL;
+  unsigned long value = strtoul( p_value, &p_end, 10 );
+
+  if( p_end == p_value || *p_end != '\0' || value > UINT16_MAX )
+    return default_value;
+
+  return (uint16_t) value;
+}
+
+static uint64_t _parse_seed( const char *p_value, uint64_t default_seed ){
+  char *p_end = NULL;
+  unsigned long long value = strtoull( p_value, &p_end, 10 );
+
+  if( p_end == p_value || *p_end != '\0' )
+    return default_seed;
+
+  return (uint64_t) value;
 }
 
 void test_function( void ){
+  static tetris_game_t game;
+
   LOG_DBG( "board:\n" );
-  board_init();
-  // board_print();
+  board_init( &game, GAME_CONFIG_BOARD_ROW_SIZE, GAME_CONFIG_BOARD_COL_SIZE );
+  // board_print( &game );
 
   PIECE_STRUCT_T piece = { 0 };
   uint8_t piece_type = PIECE_SHAPE_L;
@@ -40,16 +133,16 @@ void test_function( void ){
   piece_rotate_90deg( &piece );
   piece_rotate_90deg( &piece );
 
-  add_new_piece_to_board( piece_type );
+  add_new_piece_to_board( &game, piece_type, 0 );
 
   LOG_DBG( "\n" );
-  board_print();
+  board_print( &game );
   LOG_DBG( "\n\n" );
 
   for( uint8_t i=0; i<5; i++ ){
-      // board_print();
-    if( move_current_piece_through_board( BOARD_DIRECTION_DOWN ) != TETRIS_RET_ERR ){
-      board_print();
+      // board_print( &game );
+    if( move_current_piece_through_board( &game, BOARD_DIRECTION_DOWN ) != TETRIS_RET_ERR ){
+      board_print( &game );
       LOG_DBG( "\n\n" );
     }
   }
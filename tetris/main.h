@@ -43,4 +43,9 @@
  * Typedefs
  */
 
+/*!
+  @brief        Holds the whole state of one game (defined in game.h).
+*/
+typedef struct TETRIS_GAME_TAG tetris_game_t;
+
 #endif /* _MAIN_H_ */
\ No newline at end of file
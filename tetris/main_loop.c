@@ -13,21 +13,31 @@
 #include <stdio.h>
 #include <stdint.h>
 #include <stdbool.h>
-#include <time.h>
-#include <conio.h>
-#include <windows.h>
+#include <stdatomic.h>
 
 #include "main.h"
 #include "game_config.h"
 #include "graphics.h"
 #include "board.h"
 #include "score.h"
+#include "game.h"
+#include "frame.h"
+#include "input.h"
+#include "command.h"
+#include "platform.h"
+#include "latency.h"
+#include "replay.h"
+#include "autoplay.h"
 
 
 /* ==========================================================================================================
  * Definitions
  */
 
+/* The first threads in the list end the game when they return (player quit or end of game displayed) */
+#define MAIN_LOOP_ENDING_THREAD_COUNT  2
+
+#define MAIN_LOOP_TICK_NS  ( (uint64_t) GAME_CONFIG_TICK_MS * 1000000u )
 
 
 /* ==========================================================================================================
@@ -38,92 +48,162 @@
  * Static variables
  */
 
-static HANDLE h_game_reposition_mutex;
-static HANDLE h_game_player_move_mutex;
-
-static volatile uint32_t game_reposition_time  = GAME_CONFIG_BOARD_REPOSITION_MS;
-static volatile uint32_t game_player_move_time = GAME_CONFIG_PLAYER_MOVE_DELAY_MS;
-
-static const float game_reposition_speed_rate[GAME_DIFFICULTY_LAST_IDX] = {
-  0.9, 0.75, 0.65, 0.5
-};
+/* `game` and `game_frames` (writer side) are owned by the tick thread, other threads reach it through
+   `game_commands` and read the frames it publishes */
+static tetris_game_t game;
+static FRAME_BUFFER_T game_frames;
+static COMMAND_RING_T game_commands;
+static LATENCY_STATS_T game_latency;   // written by the render thread only
+static REPLAY_WRITER_T game_replay;    // recorded by the tick thread, closed once it is joined
+
+static PLATFORM_EVENT_T frame_ready_event;
+
+/* With --autoplay the tick thread hands a copy of the game over when a piece spawns, and the autoplay thread pushes
+   the commands of its path to `game_commands` (the key input thread then only quits, the ring keeps one producer) */
+static bool autoplay_is_enabled;
+static AUTOPLAY_STRUCT_T game_autoplay;
+static tetris_game_t *p_autoplay_game;   // read by the autoplay thread only
+static uint8_t *p_autoplay_state;        // written by the tick thread while `autoplay_is_busy` is clear
+static size_t autoplay_state_size;
+static atomic_bool autoplay_is_busy;
+static PLATFORM_EVENT_T autoplay_event;
 
 /* ==========================================================================================================
  * Static Function Prototypes
  */
 
-DWORD WINAPI _key_input_thread( void *data );
-DWORD WINAPI _graphics_thread( void *data );
-DWORD WINAPI _game_speed_thread( void *data );
+static uint32_t _key_input_thread( void *data );
+static uint32_t _render_thread( void *data );
+static uint32_t _game_tick_thread( void *data );
+static uint32_t _autoplay_thread( void *data );
 
-static uint64_t _get_current_time_ms( void );
-static void _flush_keyboard_buffer( void );
+static void _publish_frame( tetris_game_t *p_game, uint8_t game_status );
+static void _release( void );
+static int8_t _autoplay_init( uint16_t board_row_size, uint16_t board_col_size, const AUTOPLAY_CONFIG_T *p_config );
+static void _autoplay_deinit( void );
+static void _autoplay_hand_over( tetris_game_t *p_game, uint32_t *p_piece_count );
 
 
 /* ==========================================================================================================
  * Global Functions Declaration
  */
 
-int main_loop_init( void ){
-  HANDLE threads[] = {
-    CreateThread( NULL, 0, _key_input_thread, NULL, 0, NULL ),
-    CreateThread( NULL, 0, _graphics_thread, NULL, 0, NULL ),
-    CreateThread( NULL, 0, _game_speed_thread, NULL, 0, NULL )
-  };
+int main_loop_init( uint16_t board_row_size, uint16_t board_col_size, uint64_t seed, uint8_t difficulty,
+                    const char *p_replay_path, const AUTOPLAY_CONFIG_T *p_autoplay_config ){
+  if( board_init( &game, board_row_size, board_col_size ) != TETRIS_RET_OK ){
+    printf( "Invalid board size: %u x %u\n", board_row_size, board_col_size );
+    return 1;
+  }
 
-  HANDLE mutexes[] = {
-    h_game_reposition_mutex,
-    h_game_player_move_mutex
-  };
+  score_reset_to_zero( &game );
+  score_set_difficulty( &game, difficulty );
+  game_clock_init( &game );
+  game_set_seed( &game, seed );
+
+  if( p_replay_path != NULL ){
+    REPLAY_HEADER_T replay_header = {
+      .seed       = seed,
+      .row_size   = board_row_size,
+      .col_size   = board_col_size,
+      .difficulty = score_get_difficulty( &game ),
+      .tick_ms    = GAME_CONFIG_TICK_MS
+    };
+
+    if( replay_writer_open( &game_replay, p_replay_path, &replay_header ) != TETRIS_RET_OK ){
+      printf( "Failed to record the replay to %s\n", p_replay_path );
+      _release();
+      return 1;
+    }
+  }
+
+  /* Set once the automatic player is initialized, `_release()` frees it */
+  autoplay_is_enabled = false;
 
-  uint8_t ret = graphics_init();
-  if( ret != 0 )
+  if( p_autoplay_config != NULL && _autoplay_init( board_row_size, board_col_size, p_autoplay_config ) != TETRIS_RET_OK ){
+    printf( "The automatic player does not support a %u x %u board\n", board_row_size, board_col_size );
+    _release();
     return 1;
+  }
 
-  LOG_INF("size: %lld\n", sizeof(threads)/8);
+  autoplay_is_enabled = ( p_autoplay_config != NULL );
 
-  uint8_t thread_count = sizeof(threads) / 8;
-  for( uint8_t i=0; i<thread_count; i++ ){
-    if( threads[i] == NULL ){
-      LOG_DBG( "Thread creation error: %u\n", i );
-      return 1;
-    }
+  if( graphics_init( board_row_size, board_col_size ) != 0 ){
+    _release();
+    return 1;
   }
 
-  uint8_t mutex_count = sizeof(mutexes) / 8;
-  for( uint8_t i=0; i<mutex_count; i++ ){
-    mutexes[i] = CreateMutex(NULL, FALSE, NULL);
-    if( mutexes[i] == NULL ){
-      LOG_DBG( "Failed to create h_game_reposition_mutex. Error: %lu\n", GetLastError() );
-      return 1;
-    }
+  if( frame_buffer_init( &game_frames, board_row_size, board_col_size ) != TETRIS_RET_OK ){
+    LOG_DBG( "Failed to allocate the frame buffer\n" );
+    _release();
+    return 1;
   }
 
-  DWORD finished_thread = WaitForMultipleObjects( thread_count, threads, FALSE, INFINITE );
-  uint8_t finished_idx  = finished_thread - WAIT_OBJECT_0;
+  if( input_init() != TETRIS_RET_OK ){
+    _release();
+    return 1;
+  }
 
-  if( finished_idx >= 0 && finished_idx < thread_count ){
-    DWORD exitCode;
-    GetExitCodeThread( threads[finished_idx], &exitCode );
+  if( platform_event_init( &frame_ready_event ) != TETRIS_RET_OK ){
+    LOG_DBG( "Failed to create frame_ready_event\n" );
+    _release();
+    return 1;
+  }
 
-    LOG_DBG( "Thread %d finished with return value: %lu\n", finished_idx, exitCode );
+  command_ring_init( &game_commands );
+  latency_stats_reset( &game_latency );
+  latency_install_dump_signal();
 
-    for( uint8_t i=0; i<thread_count; i++ ){
-      if( i == finished_idx ) continue;
+  /* The board is displayed right away, before the first gravity step */
+  _publish_frame( &game, TETRIS_GAME_NOT_OVER );
 
-      TerminateThread( threads[i], 0 );
+  PLATFORM_THREAD_T threads[4];
+  platform_thread_func_t thread_funcs[4] = { _key_input_thread, _render_thread, _game_tick_thread, _autoplay_thread };
+  void *thread_args[4]                   = { &game_commands, &game_frames, &game, &game_commands };
+  uint8_t thread_count                   = autoplay_is_enabled ? 4 : 3;
+  uint8_t started_count                  = 0;
+  int8_t finished_idx                    = -1;
 
-      LOG_DBG( "Thread %d terminated.\n", i );
-    }
+  while( started_count < thread_count &&
+         platform_thread_create( &threads[started_count], thread_funcs[started_count], thread_args[started_count] ) == TETRIS_RET_OK ){
+    started_count++;
   }
 
-  graphics_deinit();
-  for( uint8_t i=0; i<mutex_count; i++ ){
-    CloseHandle(mutexes[i]);
+  /* When a thread fails to start, the ones already started are stopped like at the end of a game */
+  bool is_started = ( started_count == thread_count );
+
+  if( is_started ){
+    finished_idx = platform_thread_wait_any( threads, MAIN_LOOP_ENDING_THREAD_COUNT );
+  }
+  else{
+    LOG_DBG( "Thread creation error\n" );
+  }
+
+  if( finished_idx >= 0 ){
+    LOG_DBG( "Thread %d finished with return value: %u\n", finished_idx, threads[finished_idx].exit_code );
   }
 
-  for( uint8_t i=0; i<thread_count; i++ ){
-    CloseHandle(threads[i]);
+  for( uint8_t i=0; i<started_count; i++ ){
+    if( i == finished_idx ) continue;
+
+    platform_thread_cancel( &threads[i] );
+
+    LOG_DBG( "Thread %d terminated.\n", i );
+  }
+
+  for( uint8_t i=0; i<started_count; i++ ){
+    platform_thread_join( &threads[i] );
+  }
+
+  _release();
+  platform_event_deinit( &frame_ready_event );
+
+  if( !is_started )
+    return 1;
+
+  latency_stats_print( &game_latency );
+
+  if( autoplay_is_enabled ){
+    autoplay_stats_print( &game_autoplay.stats, game_autoplay.config.depth );
   }
 
   return 0;
@@ -134,48 +214,32 @@ int main_loop_init( void ){
  * Static Functions Declaration
  */
 
-DWORD WINAPI _key_input_thread( void *data ){
-  char key;
+static uint32_t _key_input_thread( void *data ){
+  COMMAND_RING_T *p_commands = (COMMAND_RING_T *) data;
+  INPUT_KEY_EVENT_T key_event;
+  COMMAND_STRUCT_T command;
 
   while( 1 ){
-    if( _kbhit() ) {
-      key = _getch();
-      _flush_keyboard_buffer();
-      LOG_INF( "You pressed: %c\n", key );
-
-      switch( key ){
-        case GAME_MOVE_DOWN_CHAR:
-          move_current_piece_through_board( BOARD_DIRECTION_DOWN );
-          graphics_print_game( false );
-          break;
-
-        case GAME_MOVE_LEFT_CHAR:
-          move_current_piece_through_board( BOARD_DIRECTION_LEFT );
-          graphics_print_game( false );
-          break;
-
-        case GAME_MOVE_RIGHT_CHAR:
-          move_current_piece_through_board( BOARD_DIRECTION_RIGHT );
-          graphics_print_game( false );
-          break;
-
-        case GAME_ROTATE_CHAR:
-          rotate_current_piece_through_board();
-          graphics_print_game( false );
-          break;
-
-        case GAME_QUIT_CHAR:
-          LOG_INF( "Quit\n" );
-          return 1;
-
-        default:
-          Sleep( GAME_CONFIG_KEY_SAMPLE_RATE_MS );
-          break;
-      }
+    /* Blocks until the player presses a key, keys pressed meanwhile are queued by the input layer */
+    if( input_wait_key( &key_event, INPUT_WAIT_FOREVER ) != TETRIS_RET_OK )
+      continue;
+
+    LOG_INF( "You pressed: %c\n", key_event.key );
 
-      WaitForSingleObject( h_game_player_move_mutex, INFINITE );
-      Sleep( game_player_move_time );
-      ReleaseMutex( h_game_player_move_mutex );
+    if( key_event.key == GAME_QUIT_CHAR ){
+      LOG_INF( "Quit\n" );
+      return 1;
+    }
+
+    command.type         = command_from_key( key_event.key );
+    command.timestamp_ns = key_event.timestamp_ns;
+
+    if( command.type == GAME_COMMAND_LAST_IDX || autoplay_is_enabled )
+      continue;
+
+    /* The game is never touched here, the tick thread applies the command at the start of the next tick */
+    if( command_push( p_commands, &command ) != TETRIS_RET_OK ){
+      LOG_WRN( "Command queue full, key %c dropped\n", key_event.key );
     }
   }
 
@@ -183,56 +247,201 @@ DWORD WINAPI _key_input_thread( void *data ){
 }
 
 
-DWORD WINAPI _graphics_thread( void *data ){
-  uint64_t last_time_ms    = 0;
-  uint64_t current_time_ms = 0;
-  uint16_t i = 0;
-  
+static uint32_t _render_thread( void *data ){
+  FRAME_BUFFER_T *p_frames      = (FRAME_BUFFER_T *) data;
+  const FRAME_STRUCT_T *p_frame = NULL;
+  bool is_ended                 = false;
+
   while( 1 ){
-    last_time_ms = _get_current_time_ms();
-    
-    if( graphics_print_game( true ) != TETRIS_RET_OK ){
+    platform_event_wait( &frame_ready_event );
+
+    /* Only the latest frame is drawn, the ones published while the terminal was busy are dropped */
+    p_frame = frame_acquire( p_frames );
+    if( p_frame == NULL )
+      continue;
+
+    is_ended = ( graphics_draw_frame( p_frame ) != TETRIS_RET_OK );
+
+    /* The write to the terminal has returned, which is as close to the screen as the game can measure */
+    latency_record_frame( &game_latency, p_frame, platform_get_time_ns() );
+
+    if( latency_take_dump_request() ){
+      latency_stats_print( &game_latency );
+    }
+
+    if( is_ended ){
       return 1;
     }
+  }
+
+  return 0;
+}
 
-    LOG_DBG( "Graphics %u\n", i++ );
 
-    WaitForSingleObject( h_game_reposition_mutex, INFINITE );
+static uint32_t _game_tick_thread( void *data ){
+  tetris_game_t *p_game     = (tetris_game_t *) data;
+  COMMAND_STRUCT_T command;
+  uint64_t previous_time_ns = platform_get_time_ns();
+  uint64_t current_time_ns  = 0;
+  uint64_t accumulator_ns   = 0;
+  uint64_t step_count       = 0;
+  uint32_t piece_count      = 0;
+  uint8_t game_status       = TETRIS_GAME_NOT_OVER;
+  bool is_changed           = false;
+
+  while( 1 ){
+    current_time_ns   = platform_get_time_ns();
+    accumulator_ns   += current_time_ns - previous_time_ns;
+    previous_time_ns  = current_time_ns;
+
+    /* After a stall (e.g. the process was descheduled) only a few ticks are caught up, the game slows down
+       for a moment instead of jumping ahead */
+    if( accumulator_ns > MAIN_LOOP_TICK_NS * GAME_CONFIG_MAX_CATCH_UP_TICKS ){
+      LOG_DBG( "Tick thread stalled, %llu ms dropped\n",
+               (unsigned long long) ( ( accumulator_ns - MAIN_LOOP_TICK_NS * GAME_CONFIG_MAX_CATCH_UP_TICKS ) / 1000000 ) );
+      accumulator_ns = MAIN_LOOP_TICK_NS * GAME_CONFIG_MAX_CATCH_UP_TICKS;
+    }
 
-    current_time_ms = _get_current_time_ms();
-    Sleep( game_reposition_time - ( current_time_ms - last_time_ms ) );
+    is_changed = false;
+    step_count = p_game->clock.step_count;
+
+    while( accumulator_ns >= MAIN_LOOP_TICK_NS && game_status == TETRIS_GAME_NOT_OVER ){
+      /* Player commands are applied at the start of the tick, in the order the keys were pressed */
+      while( command_pop( &game_commands, &command ) == TETRIS_RET_OK ){
+        game_apply_command( p_game, command.type );
+        replay_record_command( &game_replay, p_game->clock.tick, command.type );
+        frame_add_input_sample( &game_frames, command.timestamp_ns, platform_get_time_ns() );
+        is_changed = true;
+      }
+
+      game_status     = game_tick( p_game );
+      accumulator_ns -= MAIN_LOOP_TICK_NS;
+
+      if( game_status == TETRIS_GAME_NOT_OVER ){
+        replay_record_state( &game_replay, p_game );
+      }
+    }
 
-    ReleaseMutex( h_game_reposition_mutex );
+    if( is_changed || p_game->clock.step_count != step_count ){
+      _publish_frame( p_game, game_status );
+    }
+
+    if( game_status != TETRIS_GAME_NOT_OVER ){
+      return 0;
+    }
+
+    if( autoplay_is_enabled ){
+      _autoplay_hand_over( p_game, &piece_count );
+    }
+
+    /* Sleeps until the next tick is due, to an absolute deadline so the ticks do not drift */
+    platform_sleep_until_ns( current_time_ns - accumulator_ns + MAIN_LOOP_TICK_NS );
   }
 
   return 0;
 }
 
 
-DWORD WINAPI _game_speed_thread( void *data ){
+static uint32_t _autoplay_thread( void *data ){
+  COMMAND_RING_T *p_commands = (COMMAND_RING_T *) data;
+  COMMAND_STRUCT_T command;
+  const uint8_t *p_path = NULL;
+  uint16_t path_count   = 0;
+
   while( 1 ){
-    Sleep( TETRIS_GAME_INCREMENT_SPEED_DELAY_MS );
-    
-    WaitForSingleObject( h_game_reposition_mutex, INFINITE );
-    game_reposition_time  = (uint32_t) ( (float) game_reposition_time * game_reposition_speed_rate[score_get_difficulty()] );
-    ReleaseMutex( h_game_reposition_mutex );
+    platform_event_wait( &autoplay_event );
+
+    if( game_load_state( p_autoplay_game, p_autoplay_state, autoplay_state_size ) == TETRIS_RET_OK &&
+        autoplay_choose( &game_autoplay, p_autoplay_game, autoplay_get_deadline_ns( p_autoplay_game ),
+                         AUTOPLAY_NO_NODE_BUDGET, &p_path, &path_count ) == TETRIS_RET_OK ){
+      command.timestamp_ns = platform_get_time_ns();
+
+      /* The path is applied on the next tick, as if its keys were pressed all at once. A path longer than the
+         queue waits for the tick thread to drain it */
+      for( uint16_t i=0; i<path_count; i++ ){
+        command.type = p_path[i];
+
+        while( command_push( p_commands, &command ) != TETRIS_RET_OK ){
+          platform_sleep_until_ns( platform_get_time_ns() + MAIN_LOOP_TICK_NS );
+        }
+      }
+    }
 
-    WaitForSingleObject( h_game_player_move_mutex, INFINITE );
-    game_player_move_time = (uint32_t) ( (float) game_player_move_time * ( 2.0 - game_reposition_speed_rate[score_get_difficulty()] ) );
-    ReleaseMutex( h_game_player_move_mutex );
+    atomic_store_explicit( &autoplay_is_busy, false, memory_order_release );
   }
+
+  return 0;
+}
+
+
+static void _publish_frame( tetris_game_t *p_game, uint8_t game_status ){
+  frame_publish( &game_frames, p_game, game_status );
+  platform_event_set( &frame_ready_event );
 }
 
 
-static uint64_t _get_current_time_ms( void ){
-  struct timespec ts;
-  clock_gettime( CLOCK_MONOTONIC, &ts ); // Use CLOCK_REALTIME if wall-clock time is needed
-  return (uint64_t) ( ( ts.tv_sec ) * 1000 ) + ( ts.tv_nsec / 1000000 );
+/* Whatever part of the game was initialized, the terminal is restored first so the messages after it are readable */
+static void _release( void ){
+  input_deinit();
+  replay_writer_close( &game_replay, &game );
+  graphics_deinit();
+  frame_buffer_deinit( &game_frames );
+  board_deinit( &game );
+
+  if( autoplay_is_enabled ){
+    _autoplay_deinit();
+  }
 }
 
 
-static void _flush_keyboard_buffer( void ){
-  while (_kbhit()) {
-    _getch();
+static int8_t _autoplay_init( uint16_t board_row_size, uint16_t board_col_size, const AUTOPLAY_CONFIG_T *p_config ){
+  AUTOPLAY_CONFIG_T config = *p_config;
+  uint32_t cpu_count       = platform_get_cpu_count();
+
+  /* The key input, render and tick threads mostly sleep, every other core may evaluate placements */
+  config.max_workers = ( cpu_count > AUTOPLAY_MAX_WORKERS ) ? AUTOPLAY_MAX_WORKERS :
+                       ( cpu_count > 1 ) ? (uint8_t) ( cpu_count - 1 ) : 0;
+
+  if( autoplay_init( &game_autoplay, board_row_size, board_col_size, &config ) != TETRIS_RET_OK )
+    return TETRIS_RET_ERR;
+
+  p_autoplay_game     = game_create( board_row_size, board_col_size );
+  autoplay_state_size = ( p_autoplay_game != NULL ) ? game_state_size( p_autoplay_game ) : 0;
+  p_autoplay_state    = ( p_autoplay_game != NULL ) ? malloc( autoplay_state_size ) : NULL;
+
+  if( p_autoplay_state == NULL || platform_event_init( &autoplay_event ) != TETRIS_RET_OK ){
+    LOG_DBG( "Failed to allocate the automatic player\n" );
+    autoplay_deinit( &game_autoplay );
+    game_destroy( p_autoplay_game );
+    free( p_autoplay_state );
+    return TETRIS_RET_ERR;
   }
-}
\ No newline at end of file
+
+  atomic_init( &autoplay_is_busy, false );
+
+  return TETRIS_RET_OK;
+}
+
+
+static void _autoplay_deinit( void ){
+  autoplay_deinit( &game_autoplay );
+  game_destroy( p_autoplay_game );
+  free( p_autoplay_state );
+  platform_event_deinit( &autoplay_event );
+}
+
+
+static void _autoplay_hand_over( tetris_game_t *p_game, uint32_t *p_piece_count ){
+  if( !p_game->board.has_current_piece || p_game->board.piece_count == *p_piece_count )
+    return;
+
+  /* The previous path is still being pushed, the piece is handed over on a later tick */
+  if( atomic_load_explicit( &autoplay_is_busy, memory_order_acquire ) )
+    return;
+
+  game_save_state( p_game, p_autoplay_state );
+  *p_piece_count = p_game->board.piece_count;
+
+  atomic_store_explicit( &autoplay_is_busy, true, memory_order_relaxed );
+  platform_event_set( &autoplay_event );
+}
@@ -8,6 +8,12 @@
 #ifndef _MAIN_LOOP_H_
 #define _MAIN_LOOP_H_
 
-int main_loop_init( void );
+#include <stdint.h>
+#include <stdbool.h>
+
+#include "autoplay.h"
+
+int main_loop_init( uint16_t board_row_size, uint16_t board_col_size, uint64_t seed, uint8_t difficulty,
+                    const char *p_replay_path, const AUTOPLAY_CONFIG_T *p_autoplay_config );
 
 #endif /* _MAIN_LOOP_H_ */
\ No newline at end of file
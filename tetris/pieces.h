@@ -29,13 +29,7 @@
 #define PIECE_L_MATRIX_ORDER          3
 #define PIECE_L_FLIPPED_MATRIX_ORDER  3
 
-#define PIECE_SQUARE_SIZE     ( PIECE_SQUARE_MATRIX_ORDER * PIECE_SQUARE_MATRIX_ORDER )
-#define PIECE_T_SIZE          ( PIECE_T_MATRIX_ORDER * PIECE_T_MATRIX_ORDER )
-#define PIECE_LINE_SIZE       ( PIECE_LINE_MATRIX_ORDER * PIECE_LINE_MATRIX_ORDER )
-#define PIECE_Z_SIZE          ( PIECE_Z_MATRIX_ORDER * PIECE_Z_MATRIX_ORDER )
-#define PIECE_Z_FLIPPED_SIZE  ( PIECE_Z_FLIPPED_MATRIX_ORDER * PIECE_Z_FLIPPED_MATRIX_ORDER )
-#define PIECE_L_SIZE          ( PIECE_L_MATRIX_ORDER * PIECE_L_MATRIX_ORDER )
-#define PIECE_L_FLIPPED_SIZE  ( PIECE_L_FLIPPED_MATRIX_ORDER * PIECE_L_FLIPPED_MATRIX_ORDER )
+#define PIECE_ROTATION_COUNT          4
 
 #define MAX(a, b) ( (a) > (b) ? (a) : (b) )
 
@@ -46,12 +40,10 @@
                                     MAX(PIECE_Z_FLIPPED_MATRIX_ORDER, \
                                     MAX(PIECE_L_MATRIX_ORDER, PIECE_L_FLIPPED_MATRIX_ORDER))))))
 
-#define PIECE_LARGEST_SIZE          MAX(PIECE_SQUARE_SIZE, \
-                                    MAX(PIECE_T_SIZE, \
-                                    MAX(PIECE_LINE_SIZE, \
-                                    MAX(PIECE_Z_SIZE, \
-                                    MAX(PIECE_Z_FLIPPED_SIZE, \
-                                    MAX(PIECE_L_SIZE, PIECE_L_FLIPPED_SIZE))))))
+/*!
+  @brief        Retrieves the precomputed orientation (PIECE_ORIENTATION_T) of a piece in its current rotation.
+*/
+#define PIECE_ORIENTATION( p_piece )  ( &piece_orientations[ (p_piece)->type ][ (p_piece)->rotation ] )
 
 
 /* ==========================================================================================================
@@ -73,43 +65,66 @@ typedef enum{
 } PIECE_SHAPES_E;
 
 /*!
-  @brief        Wrapper type used to indicate a piece vector.
+  @brief        Wrapper type used to indicate a piece row bitmask (bit j is set when column j of the row is filled).
 */
-typedef uint8_t piece_shape_t;
+typedef uint8_t piece_row_t;
+
+/*!
+  @brief        Describes one of the four orientations of a piece, precomputed at build time.
+
+  @param        row_mask: the piece's shape described as one bitmask per row of its square matrix.
+  @param        first_row: first non-empty row of the matrix (i.e. number of empty rows on top).
+  @param        last_row: last non-empty row of the matrix.
+  @param        first_col: first non-empty column of the matrix (i.e. number of empty columns on the left).
+  @param        last_col: last non-empty column of the matrix.
+*/
+typedef struct PIECE_ORIENTATION_TAG{
+  piece_row_t row_mask[PIECE_LARGEST_MATRIX_ORDER];
+  uint8_t first_row;
+  uint8_t last_row;
+  uint8_t first_col;
+  uint8_t last_col;
+} PIECE_ORIENTATION_T;
 
 /*!
   @brief        Indicates all the piece parameters.
 
+  @param        type: one of the piece shape types (from PIECE_SHAPES_E).
+  @param        rotation: index of the current orientation, from 0 to PIECE_ROTATION_COUNT - 1 (clockwise).
   @param        order: the order (n) of the square matrix (n x n) that describes the piece shape.
-  @param        size: the total number of elements in the square matrix (size = order^2).
-  @param        displayed_rows: number of piece rows displeyd in the board (starts with 0 and goes up to 'order').
-  @param        displayed_cols: number of piece cols displeyd in the board (starts with 0 and goes up to 'order').
   @param        position_row: the row number of the board at which the piece starts.
   @param        position_col: the column number of the board at which the piece starts.
   @param        is_colliding: flag to identify whether the piece is currently colliding at the downwards direction.
   @param        is_moving: flag to identify whether the piece is still allowed to move through the board.
-  @param        shape: pointer to the square matrix that describes the piece's shape.
 
   @warning      Beware of `position_row` and `position_col` being signed integers to account for pieces being
                 positioned all the way up or to the left with negative indexes.
 
-  @note         Despite being used as a matrix, a piece is actually described as a single dimension array.
+  @note         The shape itself is not stored in the piece, use PIECE_ORIENTATION() to get it.
 */
 typedef struct PIECE_STRUCT_TAG{
+  uint8_t type;
+  uint8_t rotation;
   uint8_t order;
-  uint8_t size;
-  uint8_t displayed_rows;
-  uint8_t displayed_cols;
-  int8_t  position_row;
-  int8_t  position_col;
+  int16_t position_row;
+  int16_t position_col;
   uint8_t print_color;
   char print_char;
   bool is_colliding;
   bool is_moving;
-  piece_shape_t shape[PIECE_LARGEST_SIZE];
 } PIECE_STRUCT_T;
 
 
+/* ==========================================================================================================
+ * Global Variables
+ */
+
+/*!
+  @brief        All the orientations of every piece, indexed by [type][rotation].
+*/
+extern const PIECE_ORIENTATION_T piece_orientations[PIECE_SHAPE_LAST_IDX][PIECE_ROTATION_COUNT];
+
+
 /* ==========================================================================================================
  * Global Functions
  */
@@ -125,7 +140,7 @@ typedef struct PIECE_STRUCT_TAG{
 int8_t piece_get( uint8_t type, PIECE_STRUCT_T *p_piece );
 
 /*!
-  @brief        Rotate a piece 90 degrees clockwise around its center.
+  @brief        Rotate a piece 90 degrees clockwise around its center, by selecting its next orientation.
 
   @param[in]    p_piece: pointer to the piece to be rotated.
 
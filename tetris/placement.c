@@ -0,0 +1,587 @@
+/*
+ *  placement.c
+ *
+ *  Created on: 17-Oct-2026
+ *      Author: lucas-noce
+ */
+
+/* ==========================================================================================================
+ * Includes
+ */
+
+#include <stdlib.h>
+#include <stdint.h>
+#include <stdbool.h>
+#include <string.h>
+
+#include "main.h"
+#include "game_config.h"
+#include "pieces.h"
+#include "board.h"
+#include "game.h"
+#include "command.h"
+#include "placement.h"
+
+
+/* ==========================================================================================================
+ * Definitions
+ */
+
+#define PLACEMENT_ROUND_UP( value, multiple )  ( ( ( (value) + (multiple) - 1 ) / (multiple) ) * (multiple) )
+
+#define PLACEMENT_PAIR_COUNT( p_search )       ( (uint32_t) PIECE_ROTATION_COUNT * (p_search)->col_size )
+#define PLACEMENT_STATE_COUNT( p_search )      ( PLACEMENT_PAIR_COUNT( p_search ) * PLACEMENT_MAX_ROW_SIZE )
+
+#define PLACEMENT_PAIR( p_search, rotation, col )         ( (uint32_t) (rotation) * (p_search)->col_size + (col) )
+#define PLACEMENT_STATE( p_search, rotation, col, row )   ( PLACEMENT_PAIR( p_search, rotation, col ) * PLACEMENT_MAX_ROW_SIZE + (row) )
+
+
+/* ==========================================================================================================
+ * Static Function Prototypes
+ */
+
+/*!
+  @brief        Trims the empty rows and columns of every orientation of every piece, and finds the rotations that
+                fill the same cells.
+
+  @param[in]    p_search: pointer to the workspace.
+
+  @returns      void
+*/
+static void _init_shapes( PLACEMENT_SEARCH_T *p_search );
+
+/*!
+  @brief        Computes, for every rotation and column of a piece, the rows where it fits in the board.
+
+  @param[in]    p_search: pointer to the workspace, with the columns of the board.
+  @param[in]    type: one of the piece shape types (from PIECE_SHAPES_E).
+
+  @returns      void
+*/
+static void _compute_fit( PLACEMENT_SEARCH_T *p_search, uint8_t type );
+
+/*!
+  @brief        Adds reachable states to a pair (r, x), and queues the pair if it gained any.
+
+  @param[in]    p_search: pointer to the workspace.
+  @param[in]    pair: index of the pair.
+  @param[in]    rows: the reachable rows, already tested against `fit`.
+
+  @returns      void
+*/
+static inline void _add_reachable( PLACEMENT_SEARCH_T *p_search, uint32_t pair, board_word_t rows );
+
+/*!
+  @brief        Hands the reachable states of a pair (r, x) to the pairs one move away (left, right and rotated).
+
+  @param[in]    p_search: pointer to the workspace.
+  @param[in]    p_shapes: the orientations of the piece searched.
+  @param[in]    pair: index of the pair.
+  @param[in]    rows: the reachable rows of the pair.
+
+  @returns      void
+*/
+static inline void _spread_reachable( PLACEMENT_SEARCH_T *p_search, const PLACEMENT_SHAPE_T *p_shapes, uint32_t pair,
+                                      board_word_t rows );
+
+/*!
+  @brief        Extends every reachable row down through the fitting rows below it, in a single addition: the carry
+                of a reachable row runs through the run of fitting rows it belongs to.
+
+  @param[in]    reachable: the reachable rows (a subset of `fitting`).
+  @param[in]    fitting: the rows where the piece fits.
+
+  @returns      The reachable rows, once the piece is moved down as far as it goes.
+*/
+static inline board_word_t _fill_down( board_word_t reachable, board_word_t fitting );
+
+/*!
+  @brief        Shifts a word of rows by a signed number of rows (towards the bottom if positive).
+
+  @param[in]    rows: the rows.
+  @param[in]    shift: number of rows (from -PIECE_LARGEST_MATRIX_ORDER to PIECE_LARGEST_MATRIX_ORDER).
+
+  @returns      The shifted rows.
+*/
+static inline board_word_t _shift_rows( board_word_t rows, int8_t shift );
+
+/*!
+  @brief        Checks if a piece state fits in the board, as computed by _compute_fit.
+
+  @param[in]    p_search: pointer to the workspace.
+  @param[in]    rotation, row, col: the state (may be out of the board).
+
+  @returns      true if the piece fits, false otherwise.
+*/
+static inline bool _is_fitting( PLACEMENT_SEARCH_T *p_search, uint8_t rotation, int16_t row, int16_t col );
+
+
+/* ==========================================================================================================
+ * Global Functions Declaration
+ */
+
+int8_t placement_search_init( PLACEMENT_SEARCH_T *p_search, uint16_t row_size, uint16_t col_size ){
+  memset( p_search, 0, sizeof( PLACEMENT_SEARCH_T ) );
+
+  if( row_size < BOARD_MIN_ROW_SIZE || row_size > PLACEMENT_MAX_ROW_SIZE ||
+      col_size < BOARD_MIN_COL_SIZE || col_size > BOARD_MAX_COL_SIZE ){
+    LOG_WRN( "Placement search does not support a %u x %u board\n", row_size, col_size );
+    return TETRIS_RET_ERR;
+  }
+
+  p_search->row_size = row_size;
+  p_search->col_size = col_size;
+
+  size_t pairs  = PLACEMENT_PAIR_COUNT( p_search );
+  size_t states = PLACEMENT_STATE_COUNT( p_search );
+
+  size_t columns_size    = PLACEMENT_ROUND_UP( col_size * sizeof( board_word_t ), GAME_CONFIG_CACHE_LINE_SIZE );
+  size_t fit_size        = PLACEMENT_ROUND_UP( pairs * sizeof( board_word_t ), GAME_CONFIG_CACHE_LINE_SIZE );
+  size_t pending_size    = PLACEMENT_ROUND_UP( pairs * sizeof( uint16_t ), GAME_CONFIG_CACHE_LINE_SIZE );
+  size_t is_pending_size = PLACEMENT_ROUND_UP( pairs, GAME_CONFIG_CACHE_LINE_SIZE );
+  size_t path_from_size  = PLACEMENT_ROUND_UP( states, GAME_CONFIG_CACHE_LINE_SIZE );
+  size_t queue_size      = PLACEMENT_ROUND_UP( states * sizeof( uint32_t ), GAME_CONFIG_CACHE_LINE_SIZE );
+  size_t placements_size = states * sizeof( PLACEMENT_T );
+  size_t total_size      = columns_size + 2 * fit_size + pending_size + is_pending_size + path_from_size +
+                           queue_size + placements_size;
+
+  p_search->p_storage = game_aligned_alloc( total_size );
+  if( p_search->p_storage == NULL ){
+    LOG_WRN( "Failed to allocate %zu bytes for the placement search\n", total_size );
+    return TETRIS_RET_ERR;
+  }
+
+  memset( p_search->p_storage, 0, total_size );
+  p_search->storage_size = total_size;
+
+  /* Every plane starts at a cache line boundary */
+  uint8_t *p_plane = (uint8_t *) p_search->p_storage;
+
+  p_search->columns    = (board_word_t *) p_plane;  p_plane += columns_size;
+  p_search->fit        = (board_word_t *) p_plane;  p_plane += fit_size;
+  p_search->reach      = (board_word_t *) p_plane;  p_plane += fit_size;
+  p_search->pending    = (uint16_t *) p_plane;      p_plane += pending_size;
+  p_search->is_pending = p_plane;                   p_plane += is_pending_size;
+  p_search->path_from  = p_plane;                   p_plane += path_from_size;
+  p_search->queue      = (uint32_t *) p_plane;      p_plane += queue_size;
+  p_search->placements = (PLACEMENT_T *) p_plane;
+
+  _init_shapes( p_search );
+
+  return TETRIS_RET_OK;
+}
+
+
+void placement_search_deinit( PLACEMENT_SEARCH_T *p_search ){
+  game_aligned_free( p_search->p_storage );
+  p_search->p_storage    = NULL;
+  p_search->storage_size = 0;
+}
+
+
+int8_t placement_find_all( PLACEMENT_SEARCH_T *p_search, tetris_game_t *p_game, const PIECE_STRUCT_T *p_piece ){
+  p_search->placement_count = 0;
+
+  if( p_game->board.row_size != p_search->row_size || p_game->board.col_size != p_search->col_size ){
+    LOG_WRN( "Placement search does not match the board size\n" );
+    return TETRIS_RET_ERR;
+  }
+
+  board_get_column_cells( p_game, p_search->columns );
+
+  return placement_find_all_in_columns( p_search, p_search->columns, p_piece );
+}
+
+
+int8_t placement_find_all_in_columns( PLACEMENT_SEARCH_T *p_search, const board_word_t *p_columns,
+                                      const PIECE_STRUCT_T *p_piece ){
+  const PLACEMENT_SHAPE_T *p_shapes = p_search->shapes[p_piece->type];
+  const PLACEMENT_SHAPE_T *p_shape  = NULL;
+  uint32_t pairs       = PLACEMENT_PAIR_COUNT( p_search );
+  uint32_t pair        = 0;
+  uint32_t canonical   = 0;
+  uint16_t col         = 0;
+  uint8_t rotation     = 0;
+  board_word_t rows    = 0;
+  board_word_t landing = 0;
+
+  p_search->placement_count = 0;
+
+  if( p_columns != p_search->columns ){
+    memcpy( p_search->columns, p_columns, p_search->col_size * sizeof( board_word_t ) );
+  }
+
+  _compute_fit( p_search, p_piece->type );
+
+  p_search->type           = p_piece->type;
+  p_search->start_rotation = p_piece->rotation;
+  p_search->start_row      = p_piece->position_row + p_shapes[p_piece->rotation].first_row;
+  p_search->start_col      = p_piece->position_col + p_shapes[p_piece->rotation].first_col;
+
+  if( p_search->start_row < 0 || p_search->start_row >= PLACEMENT_MAX_ROW_SIZE ||
+      p_search->start_col < 0 || p_search->start_col >= p_search->col_size )
+    return TETRIS_RET_OK;
+
+  memset( p_search->reach, 0, pairs * sizeof( board_word_t ) );
+  p_search->pending_head  = 0;
+  p_search->pending_count = 0;
+
+  pair = PLACEMENT_PAIR( p_search, p_search->start_rotation, p_search->start_col );
+  rows = (board_word_t) 1u << p_search->start_row;
+
+  /*
+    A piece spawned over fixed cells may still move out of them, as in the game, but no move leads back to its
+    start. When it cannot move down from there, the start is a placement of its own.
+  */
+  if( !_is_fitting( p_search, p_search->start_rotation, p_search->start_row, p_search->start_col ) ){
+    if( !_is_fitting( p_search, p_search->start_rotation, p_search->start_row + 1, p_search->start_col ) ){
+      p_search->placements[0].rotation     = p_piece->rotation;
+      p_search->placements[0].position_row = p_piece->position_row;
+      p_search->placements[0].position_col = p_piece->position_col;
+      p_search->placement_count            = 1;
+    }
+
+    _add_reachable( p_search, pair, ( rows << 1 ) & p_search->fit[pair] );
+    _spread_reachable( p_search, p_shapes, pair, rows );
+  }
+  else{
+    _add_reachable( p_search, pair, rows );
+  }
+
+  /*
+    Breadth-first search over whole columns of states: a pair (r, x) first moves its reachable rows down, then
+    hands them to the pairs one move away (left, right and rotated). A pair is queued again whenever it gains rows,
+    and the search ends when no pair gains any.
+  */
+  while( p_search->pending_count != 0 ){
+    pair                       = p_search->pending[p_search->pending_head];
+    p_search->pending_head     = ( p_search->pending_head + 1 == pairs ) ? 0 : p_search->pending_head + 1;
+    p_search->pending_count   -= 1;
+    p_search->is_pending[pair] = false;
+
+    rows                  = _fill_down( p_search->reach[pair], p_search->fit[pair] );
+    p_search->reach[pair] = rows;
+
+    _spread_reachable( p_search, p_shapes, pair, rows );
+  }
+
+  /* A placement is a reachable state that cannot move down. Rotations filling the same cells share the state
+     plane of their canonical rotation, which comes first, so a placement already found there is skipped */
+  for( pair=0; pair<pairs; pair++ ){
+    p_search->reach[pair] &= ~( p_search->fit[pair] >> 1 );
+  }
+
+  for( rotation=0; rotation<PIECE_ROTATION_COUNT; rotation++ ){
+    p_shape = &p_shapes[rotation];
+
+    for( col=0; col<p_search->col_size; col++ ){
+      pair    = PLACEMENT_PAIR( p_search, rotation, col );
+      landing = p_search->reach[pair];
+
+      if( p_shape->canonical_rotation != rotation ){
+        canonical                   = PLACEMENT_PAIR( p_search, p_shape->canonical_rotation, col );
+        landing                    &= ~p_search->reach[canonical];
+        p_search->reach[canonical] |= landing;
+      }
+
+      while( landing != 0 ){
+        PLACEMENT_T *p_placement = &p_search->placements[p_search->placement_count++];
+
+        p_placement->rotation     = rotation;
+        p_placement->position_row = (int16_t) __builtin_ctzll( landing ) - p_shape->first_row;
+        p_placement->position_col = (int16_t) col - p_shape->first_col;
+
+        landing &= landing - 1;
+      }
+    }
+  }
+
+  return TETRIS_RET_OK;
+}
+
+
+int8_t placement_get_path( PLACEMENT_SEARCH_T *p_search, const PLACEMENT_T *p_placement, uint8_t *p_commands,
+                           uint16_t max_count, uint16_t *p_count ){
+  const PLACEMENT_SHAPE_T *p_shapes = p_search->shapes[p_search->type];
+  uint8_t target_rotation = p_placement->rotation % PIECE_ROTATION_COUNT;
+  int16_t target_row      = p_placement->position_row + p_shapes[target_rotation].first_row;
+  int16_t target_col      = p_placement->position_col + p_shapes[target_rotation].first_col;
+  uint32_t target         = 0;
+  uint32_t queue_head     = 0;
+  uint32_t queue_tail     = 0;
+  uint32_t state          = 0;
+  uint16_t count          = 0;
+  uint8_t rotation        = 0;
+  int16_t row             = 0;
+  int16_t col             = 0;
+  uint8_t next_rotation   = 0;
+  int16_t next_row        = 0;
+  int16_t next_col        = 0;
+  uint8_t command         = 0;
+  bool is_found           = false;
+
+  *p_count = 0;
+
+  if( p_search->start_row < 0 || p_search->start_row >= PLACEMENT_MAX_ROW_SIZE ||
+      p_search->start_col < 0 || p_search->start_col >= p_search->col_size )
+    return TETRIS_RET_ERR;
+
+  if( target_rotation == p_search->start_rotation && target_row == p_search->start_row &&
+      target_col == p_search->start_col )
+    return TETRIS_RET_OK;
+
+  if( !_is_fitting( p_search, target_rotation, target_row, target_col ) )
+    return TETRIS_RET_ERR;
+
+  target = PLACEMENT_STATE( p_search, target_rotation, target_col, target_row );
+
+  memset( p_search->path_from, 0, PLACEMENT_STATE_COUNT( p_search ) );
+
+  state                      = PLACEMENT_STATE( p_search, p_search->start_rotation, p_search->start_col, p_search->start_row );
+  p_search->path_from[state] = GAME_COMMAND_LAST_IDX + 1;  // start, reached by no command
+  p_search->queue[queue_tail++] = state;
+
+  /* Plain breadth-first search over single states, the fit planes of the last search are the collision test */
+  while( queue_head < queue_tail && !is_found ){
+    state    = p_search->queue[queue_head++];
+    row      = state % PLACEMENT_MAX_ROW_SIZE;
+    col      = ( state / PLACEMENT_MAX_ROW_SIZE ) % p_search->col_size;
+    rotation = state / PLACEMENT_MAX_ROW_SIZE / p_search->col_size;
+
+    for( command=0; command<GAME_COMMAND_LAST_IDX && !is_found; command++ ){
+      next_rotation = rotation;
+      next_row      = row;
+      next_col      = col;
+
+      switch( command ){
+        case GAME_COMMAND_MOVE_DOWN:
+          next_row++;
+          break;
+
+        case GAME_COMMAND_MOVE_LEFT:
+          next_col--;
+          break;
+
+        case GAME_COMMAND_MOVE_RIGHT:
+          next_col++;
+          break;
+
+        case GAME_COMMAND_ROTATE:
+          next_rotation = ( rotation + 1 ) % PIECE_ROTATION_COUNT;
+          next_row      = row + p_shapes[next_rotation].first_row - p_shapes[rotation].first_row;
+          next_col      = col + p_shapes[next_rotation].first_col - p_shapes[rotation].first_col;
+          break;
+      }
+
+      if( !_is_fitting( p_search, next_rotation, next_row, next_col ) )
+        continue;
+
+      uint32_t next_state = PLACEMENT_STATE( p_search, next_rotation, next_col, next_row );
+
+      if( p_search->path_from[next_state] != 0 )
+        continue;
+
+      p_search->path_from[next_state]  = command + 1;
+      p_search->queue[queue_tail++]    = next_state;
+      is_found                         = ( next_state == target );
+    }
+  }
+
+  if( p_search->path_from[target] == 0 )
+    return TETRIS_RET_ERR;
+
+  /* Walks back from the placement to the start, undoing each command */
+  state = target;
+
+  while( p_search->path_from[state] != GAME_COMMAND_LAST_IDX + 1 ){
+    command  = p_search->path_from[state] - 1;
+    row      = state % PLACEMENT_MAX_ROW_SIZE;
+    col      = ( state / PLACEMENT_MAX_ROW_SIZE ) % p_search->col_size;
+    rotation = state / PLACEMENT_MAX_ROW_SIZE / p_search->col_size;
+
+    switch( command ){
+      case GAME_COMMAND_MOVE_DOWN:
+        row--;
+        break;
+
+      case GAME_COMMAND_MOVE_LEFT:
+        col++;
+        break;
+
+      case GAME_COMMAND_MOVE_RIGHT:
+        col--;
+        break;
+
+      case GAME_COMMAND_ROTATE:
+        next_rotation = ( rotation + PIECE_ROTATION_COUNT - 1 ) % PIECE_ROTATION_COUNT;
+        row           = row - p_shapes[rotation].first_row + p_shapes[next_rotation].first_row;
+        col           = col - p_shapes[rotation].first_col + p_shapes[next_rotation].first_col;
+        rotation      = next_rotation;
+        break;
+    }
+
+    if( count >= max_count )
+      return TETRIS_RET_ERR;
+
+    p_commands[count++] = command;
+    state               = PLACEMENT_STATE( p_search, rotation, col, row );
+  }
+
+  /* The commands were collected from the end */
+  for( uint16_t i=0; i<count/2; i++ ){
+    command                   = p_commands[i];
+    p_commands[i]             = p_commands[count - 1 - i];
+    p_commands[count - 1 - i] = command;
+  }
+
+  *p_count = count;
+
+  return TETRIS_RET_OK;
+}
+
+
+/* ==========================================================================================================
+ * Static Functions Declaration
+ */
+
+static void _init_shapes( PLACEMENT_SEARCH_T *p_search ){
+  const PIECE_ORIENTATION_T *p_orientation = NULL;
+  PLACEMENT_SHAPE_T *p_shape               = NULL;
+  PLACEMENT_SHAPE_T *p_other               = NULL;
+
+  for( uint8_t type=0; type<PIECE_SHAPE_LAST_IDX; type++ ){
+    for( uint8_t rotation=0; rotation<PIECE_ROTATION_COUNT; rotation++ ){
+      p_orientation = &piece_orientations[type][rotation];
+      p_shape       = &p_search->shapes[type][rotation];
+
+      memset( p_shape, 0, sizeof( PLACEMENT_SHAPE_T ) );
+
+      p_shape->height    = p_orientation->last_row - p_orientation->first_row + 1;
+      p_shape->width     = p_orientation->last_col - p_orientation->first_col + 1;
+      p_shape->first_row = p_orientation->first_row;
+      p_shape->first_col = p_orientation->first_col;
+
+      for( uint8_t k=0; k<p_shape->height; k++ ){
+        p_shape->row_mask[k] = p_orientation->row_mask[p_orientation->first_row + k] >> p_orientation->first_col;
+
+        for( uint8_t j=0; j<p_shape->width; j++ ){
+          if( ( p_shape->row_mask[k] >> j ) & 1u ){
+            p_shape->cell_row[p_shape->cell_count] = k;
+            p_shape->cell_col[p_shape->cell_count] = j;
+            p_shape->cell_count++;
+          }
+        }
+      }
+
+      /* Trimmed shapes that are equal fill the same cells from the same first filled cell */
+      p_shape->canonical_rotation = rotation;
+
+      for( uint8_t other=0; other<rotation; other++ ){
+        p_other = &p_search->shapes[type][other];
+
+        if( memcmp( p_other->row_mask, p_shape->row_mask, sizeof( p_shape->row_mask ) ) == 0 ){
+          p_shape->canonical_rotation = p_other->canonical_rotation;
+          break;
+        }
+      }
+    }
+  }
+}
+
+
+static void _compute_fit( PLACEMENT_SEARCH_T *p_search, uint8_t type ){
+  const PLACEMENT_SHAPE_T *p_shape  = NULL;
+  const board_word_t *p_columns     = NULL;
+  board_word_t *p_fit = NULL;
+  uint16_t fit_count  = 0;
+  uint8_t shift       = 0;
+
+  for( uint8_t rotation=0; rotation<PIECE_ROTATION_COUNT; rotation++ ){
+    p_shape   = &p_search->shapes[type][rotation];
+    p_fit     = &p_search->fit[PLACEMENT_PAIR( p_search, rotation, 0 )];
+    fit_count = p_search->col_size - p_shape->width + 1;
+
+    /*
+      A filled cell at row k of the piece blocks row y when the board cell at row y + k is set. Rows below the board
+      read as set, so pieces never leave it. The top k rows shifted in are left clear, but the bottom border blocks
+      them first. Each cell sweeps every column at once, which the compiler turns into vector operations.
+    */
+    memset( p_fit, 0, p_search->col_size * sizeof( board_word_t ) );
+
+    for( uint8_t c=0; c<p_shape->cell_count; c++ ){
+      p_columns = &p_search->columns[p_shape->cell_col[c]];
+      shift     = p_shape->cell_row[c];
+
+      for( uint16_t col=0; col<fit_count; col++ ){
+        p_fit[col] |= p_columns[col] >> shift;
+      }
+    }
+
+    for( uint16_t col=0; col<fit_count; col++ ){
+      p_fit[col] = ~p_fit[col];
+    }
+  }
+}
+
+
+static inline void _add_reachable( PLACEMENT_SEARCH_T *p_search, uint32_t pair, board_word_t rows ){
+  rows &= ~p_search->reach[pair];
+
+  if( rows == 0 )
+    return;
+
+  p_search->reach[pair] |= rows;
+
+  uint32_t tail = p_search->pending_head + p_search->pending_count;
+
+  /* A pair is queued at most once, so the ring never holds more than every pair */
+  if( !p_search->is_pending[pair] ){
+    p_search->is_pending[pair] = true;
+    p_search->pending[( tail >= PLACEMENT_PAIR_COUNT( p_search ) ) ? tail - PLACEMENT_PAIR_COUNT( p_search ) : tail] = pair;
+    p_search->pending_count++;
+  }
+}
+
+
+static inline void _spread_reachable( PLACEMENT_SEARCH_T *p_search, const PLACEMENT_SHAPE_T *p_shapes, uint32_t pair,
+                                      board_word_t rows ){
+  uint16_t col_size     = p_search->col_size;
+  uint8_t rotation      = ( pair >= col_size ) + ( pair >= 2u * col_size ) + ( pair >= 3u * col_size );
+  uint16_t col          = pair - rotation * col_size;
+  uint8_t next_rotation = ( rotation + 1 ) % PIECE_ROTATION_COUNT;
+  uint16_t next_col     = col + p_shapes[next_rotation].first_col - p_shapes[rotation].first_col;
+  uint32_t next_pair    = 0;
+
+  if( col > 0 )
+    _add_reachable( p_search, pair - 1, rows & p_search->fit[pair - 1] );
+
+  if( col + 1 < p_search->col_size )
+    _add_reachable( p_search, pair + 1, rows & p_search->fit[pair + 1] );
+
+  /* Rotation keeps the position of the piece matrix, so the first filled cell may move */
+  if( next_col < p_search->col_size ){
+    next_pair = PLACEMENT_PAIR( p_search, next_rotation, next_col );
+
+    _add_reachable( p_search, next_pair,
+                    _shift_rows( rows, p_shapes[next_rotation].first_row - p_shapes[rotation].first_row ) &
+                    p_search->fit[next_pair] );
+  }
+}
+
+
+static inline board_word_t _fill_down( board_word_t reachable, board_word_t fitting ){
+  return ( ( ( fitting + reachable ) ^ fitting ) | reachable ) & fitting;
+}
+
+
+static inline board_word_t _shift_rows( board_word_t rows, int8_t shift ){
+  return ( shift >= 0 ) ? ( rows << shift ) : ( rows >> -shift );
+}
+
+
+static inline bool _is_fitting( PLACEMENT_SEARCH_T *p_search, uint8_t rotation, int16_t row, int16_t col ){
+  if( row < 0 || row >= PLACEMENT_MAX_ROW_SIZE || col < 0 || col >= p_search->col_size )
+    return false;
+
+  return ( p_search->fit[PLACEMENT_PAIR( p_search, rotation, col )] >> row ) & 1u;
+}
@@ -0,0 +1,187 @@
+/*
+ *  placement.h
+ *
+ *  Created on: 17-Oct-2026
+ *      Author: lucas-noce
+ */
+
+#ifndef _PLACEMENT_H_
+#define _PLACEMENT_H_
+
+
+/* ==========================================================================================================
+ * Includes
+ */
+
+#include <stdint.h>
+#include <stddef.h>
+
+#include "main.h"
+#include "pieces.h"
+#include "board.h"
+
+
+/* ==========================================================================================================
+ * Definitions
+ */
+
+/* Each column of piece positions is searched as one word of rows, so taller boards are not supported */
+#define PLACEMENT_MAX_ROW_SIZE    BOARD_WORD_BITS
+
+#define PLACEMENT_MAX_PIECE_CELLS  ( PIECE_LARGEST_MATRIX_ORDER * PIECE_LARGEST_MATRIX_ORDER )
+
+
+/* ==========================================================================================================
+ * Typedefs
+ */
+
+/*!
+  @brief        A final position of a piece: it is reachable from where the piece starts, and cannot move down.
+
+  @param        rotation: orientation of the piece (from 0 to PIECE_ROTATION_COUNT - 1).
+  @param        position_row, position_col: position of the piece, as in PIECE_STRUCT_T.
+*/
+typedef struct PLACEMENT_TAG{
+  uint8_t rotation;
+  int16_t position_row;
+  int16_t position_col;
+} PLACEMENT_T;
+
+/*!
+  @brief        An orientation of a piece, with its empty rows and columns cut off.
+
+  @param        row_mask: one bitmask per filled row, starting at the first filled row and column.
+  @param        cell_row, cell_col: row and column of each filled cell, in `row_mask`.
+  @param        cell_count: number of filled cells.
+  @param        height, width: number of filled rows and columns.
+  @param        first_row, first_col: empty rows above and empty columns on the left of the piece matrix.
+  @param        canonical_rotation: the first rotation of the piece that fills the same cells (itself if none).
+*/
+typedef struct PLACEMENT_SHAPE_TAG{
+  piece_row_t row_mask[PIECE_LARGEST_MATRIX_ORDER];
+  uint8_t     cell_row[PLACEMENT_MAX_PIECE_CELLS];
+  uint8_t     cell_col[PLACEMENT_MAX_PIECE_CELLS];
+  uint8_t     cell_count;
+  uint8_t     height;
+  uint8_t     width;
+  uint8_t     first_row;
+  uint8_t     first_col;
+  uint8_t     canonical_rotation;
+} PLACEMENT_SHAPE_T;
+
+/*!
+  @brief        Workspace of the placement search, sized for one board size.
+
+  A piece state is a rotation r, a column x and a row y, where (y, x) is the board cell of the first filled row and
+  column of the piece. The states of each (r, x) pair are a word of rows (bit y), so the search moves whole columns
+  of states at once. State planes are indexed by r * col_size + x.
+
+  @param        row_size, col_size: size of the boards searched.
+  @param        shapes: the trimmed orientations of every piece.
+  @param        columns: col_size words, the fixed cells of the board by column (see board_get_column_cells).
+  @param        fit: bit y is set when the piece fits at state (r, x, y).
+  @param        reach: bit y is set when state (r, x, y) is reachable, then when it is a placement.
+  @param        pending: ring of the pairs (r, x) whose reachable states were not spread to their neighbours yet.
+  @param        is_pending: whether each pair is in `pending`.
+  @param        pending_head, pending_count: first entry and number of entries of `pending`.
+  @param        path_from: command (plus one) that first reached each state in placement_get_path, 0 if none.
+  @param        queue: states to visit in placement_get_path.
+  @param        placements: the placements found by the last placement_find_all.
+  @param        placement_count: number of entries in `placements`.
+  @param        type: piece searched by the last placement_find_all.
+  @param        start_rotation, start_row, start_col: state (r, y, x) where that piece started.
+  @param        p_storage: single cache-aligned allocation that backs all the planes above.
+  @param        storage_size: size in bytes of `p_storage`.
+*/
+typedef struct PLACEMENT_SEARCH_TAG{
+  uint16_t          row_size;
+  uint16_t          col_size;
+  PLACEMENT_SHAPE_T shapes[PIECE_SHAPE_LAST_IDX][PIECE_ROTATION_COUNT];
+  board_word_t      *columns;
+  board_word_t      *fit;
+  board_word_t      *reach;
+  uint16_t          *pending;
+  uint8_t           *is_pending;
+  uint32_t          pending_head;
+  uint32_t          pending_count;
+  uint8_t           *path_from;
+  uint32_t          *queue;
+  PLACEMENT_T       *placements;
+  uint32_t          placement_count;
+  uint8_t           type;
+  uint8_t           start_rotation;
+  int16_t           start_row;
+  int16_t           start_col;
+  void              *p_storage;
+  size_t            storage_size;
+} PLACEMENT_SEARCH_T;
+
+
+/* ==========================================================================================================
+ * Global Functions
+ */
+
+/*!
+  @brief        Allocates the workspace of the placement search for boards of a given size.
+
+  @param[out]   p_search: pointer to the workspace.
+  @param[in]    row_size: number of rows of the boards, bottom border included (up to PLACEMENT_MAX_ROW_SIZE).
+  @param[in]    col_size: number of columns of the boards, borders included.
+
+  @returns      One of the possible TETRIS_RET_x macro values (defined in main.h).
+*/
+int8_t placement_search_init( PLACEMENT_SEARCH_T *p_search, uint16_t row_size, uint16_t col_size );
+
+/*!
+  @brief        Releases the workspace of the placement search.
+
+  @param[in]    p_search: pointer to the workspace.
+
+  @returns      void
+*/
+void placement_search_deinit( PLACEMENT_SEARCH_T *p_search );
+
+/*!
+  @brief        Finds every placement a piece can reach from its current position with the game commands (moves
+                down, left and right, and clockwise rotations), with a breadth-first search over the piece states.
+                Rotations that fill the same cells (square, line, Z) give a single placement.
+
+  @param[in]    p_search: pointer to the workspace, initialized with the size of the board.
+  @param[in]    p_game: pointer to the game that owns the board.
+  @param[in]    p_piece: the piece, at its starting position (e.g. the current piece, or one from
+                board_get_spawn_piece).
+
+  @returns      TETRIS_RET_OK, or TETRIS_RET_ERR if the workspace does not match the size of the board. The
+                placements are left in `placements` (none if the piece does not fit where it starts).
+*/
+int8_t placement_find_all( PLACEMENT_SEARCH_T *p_search, tetris_game_t *p_game, const PIECE_STRUCT_T *p_piece );
+
+/*!
+  @brief        Same as placement_find_all, on a board given by its columns instead of a game (e.g. a board that
+                only exists in a lookahead search).
+
+  @param[in]    p_search: pointer to the workspace, initialized with the size of the board.
+  @param[in]    p_columns: col_size words, the fixed cells of the board by column (see board_get_column_cells).
+  @param[in]    p_piece: the piece, at its starting position.
+
+  @returns      TETRIS_RET_OK. The placements are left in `placements`.
+*/
+int8_t placement_find_all_in_columns( PLACEMENT_SEARCH_T *p_search, const board_word_t *p_columns,
+                                      const PIECE_STRUCT_T *p_piece );
+
+/*!
+  @brief        Finds one of the shortest command sequences that brings the piece of the last placement_find_all
+                from its starting position to a placement.
+
+  @param[in]    p_search: pointer to the workspace, used by placement_find_all on the same board.
+  @param[in]    p_placement: the placement, one of those found.
+  @param[out]   p_commands: the commands, from GAME_COMMANDS_E.
+  @param[in]    max_count: number of commands `p_commands` holds.
+  @param[out]   p_count: number of commands written.
+
+  @returns      TETRIS_RET_OK, or TETRIS_RET_ERR if the placement is not reachable or the path does not fit.
+*/
+int8_t placement_get_path( PLACEMENT_SEARCH_T *p_search, const PLACEMENT_T *p_placement, uint8_t *p_commands,
+                           uint16_t max_count, uint16_t *p_count );
+
+#endif /* _PLACEMENT_H_ */
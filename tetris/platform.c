@@ -0,0 +1,446 @@
+/*
+ *  platform.c
+ *
+ *  Created on: 17-Oct-2026
+ *      Author: lucas-noce
+ */
+
+/* ==========================================================================================================
+ * Includes
+ */
+
+#ifndef _WIN32
+#define _POSIX_C_SOURCE 200809L   // clock_nanosleep, clock_gettime
+#endif /* _WIN32 */
+
+#include <stdlib.h>
+#include <stdio.h>
+#include <stdint.h>
+#include <stdbool.h>
+#include <time.h>
+
+#ifdef _WIN32
+#include <windows.h>
+#else
+#include <errno.h>
+#include <fcntl.h>
+#include <pthread.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#endif /* _WIN32 */
+
+#include "main.h"
+#include "platform.h"
+
+
+/* ==========================================================================================================
+ * Definitions
+ */
+
+#define PLATFORM_NS_PER_SEC  1000000000u
+#define PLATFORM_NS_PER_MS   1000000u
+
+
+/* ==========================================================================================================
+ * Static variables
+ */
+
+#ifndef _WIN32
+/* Signaled every time a thread function returns, for platform_thread_wait_any */
+static pthread_mutex_t platform_finished_mutex = PTHREAD_MUTEX_INITIALIZER;
+static pthread_cond_t platform_finished_cond   = PTHREAD_COND_INITIALIZER;
+#endif /* _WIN32 */
+
+
+/* ==========================================================================================================
+ * Static Function Prototypes
+ */
+
+#ifdef _WIN32
+static DWORD WINAPI _platform_thread_entry( void *p_arg );
+#else
+static void *_platform_thread_entry( void *p_arg );
+static void _platform_unlock_mutex( void *p_arg );
+#endif /* _WIN32 */
+
+
+/* ==========================================================================================================
+ * Global Functions Declaration
+ */
+
+int8_t platform_thread_create( PLATFORM_THREAD_T *p_thread, platform_thread_func_t func, void *p_arg ){
+  p_thread->func      = func;
+  p_thread->p_arg     = p_arg;
+  p_thread->exit_code = 0;
+
+#ifdef _WIN32
+  p_thread->h_thread = CreateThread( NULL, 0, _platform_thread_entry, p_thread, 0, NULL );
+  if( p_thread->h_thread == NULL )
+    return TETRIS_RET_ERR;
+#else
+  atomic_init( &p_thread->is_finished, false );
+
+  if( pthread_create( &p_thread->thread, NULL, _platform_thread_entry, p_thread ) != 0 )
+    return TETRIS_RET_ERR;
+#endif /* _WIN32 */
+
+  return TETRIS_RET_OK;
+}
+
+
+int8_t platform_thread_wait_any( PLATFORM_THREAD_T *p_threads, uint8_t count ){
+  if( count == 0 || count > PLATFORM_THREAD_MAX_WAIT )
+    return TETRIS_RET_ERR;
+
+#ifdef _WIN32
+  HANDLE handles[PLATFORM_THREAD_MAX_WAIT];
+  DWORD finished = 0;
+
+  for( uint8_t i=0; i<count; i++ ){
+    handles[i] = p_threads[i].h_thread;
+  }
+
+  finished = WaitForMultipleObjects( count, handles, FALSE, INFINITE );
+  if( finished >= ( WAIT_OBJECT_0 + count ) )
+    return TETRIS_RET_ERR;
+
+  return (int8_t) ( finished - WAIT_OBJECT_0 );
+#else
+  int8_t finished = TETRIS_RET_ERR;
+
+  pthread_mutex_lock( &platform_finished_mutex );
+
+  while( finished == TETRIS_RET_ERR ){
+    for( uint8_t i=0; i<count; i++ ){
+      if( atomic_load( &p_threads[i].is_finished ) ){
+        finished = (int8_t) i;
+        break;
+      }
+    }
+
+    if( finished == TETRIS_RET_ERR ){
+      pthread_cond_wait( &platform_finished_cond, &platform_finished_mutex );
+    }
+  }
+
+  pthread_mutex_unlock( &platform_finished_mutex );
+
+  return finished;
+#endif /* _WIN32 */
+}
+
+
+void platform_thread_cancel( PLATFORM_THREAD_T *p_thread ){
+#ifdef _WIN32
+  TerminateThread( p_thread->h_thread, 0 );
+#else
+  if( !atomic_load( &p_thread->is_finished ) ){
+    pthread_cancel( p_thread->thread );
+  }
+#endif /* _WIN32 */
+}
+
+
+void platform_thread_join( PLATFORM_THREAD_T *p_thread ){
+#ifdef _WIN32
+  WaitForSingleObject( p_thread->h_thread, INFINITE );
+  CloseHandle( p_thread->h_thread );
+#else
+  pthread_join( p_thread->thread, NULL );
+#endif /* _WIN32 */
+}
+
+
+int8_t platform_event_init( PLATFORM_EVENT_T *p_event ){
+#ifdef _WIN32
+  p_event->h_event = CreateEventA( NULL, FALSE, FALSE, NULL );
+  if( p_event->h_event == NULL )
+    return TETRIS_RET_ERR;
+#else
+  p_event->is_set = false;
+
+  if( pthread_mutex_init( &p_event->mutex, NULL ) != 0 )
+    return TETRIS_RET_ERR;
+
+  if( pthread_cond_init( &p_event->cond, NULL ) != 0 ){
+    pthread_mutex_destroy( &p_event->mutex );
+    return TETRIS_RET_ERR;
+  }
+#endif /* _WIN32 */
+
+  return TETRIS_RET_OK;
+}
+
+
+void platform_event_deinit( PLATFORM_EVENT_T *p_event ){
+#ifdef _WIN32
+  CloseHandle( p_event->h_event );
+#else
+  pthread_cond_destroy( &p_event->cond );
+  pthread_mutex_destroy( &p_event->mutex );
+#endif /* _WIN32 */
+}
+
+
+void platform_event_set( PLATFORM_EVENT_T *p_event ){
+#ifdef _WIN32
+  SetEvent( p_event->h_event );
+#else
+  pthread_mutex_lock( &p_event->mutex );
+  p_event->is_set = true;
+  pthread_cond_signal( &p_event->cond );
+  pthread_mutex_unlock( &p_event->mutex );
+#endif /* _WIN32 */
+}
+
+
+void platform_event_wait( PLATFORM_EVENT_T *p_event ){
+#ifdef _WIN32
+  WaitForSingleObject( p_event->h_event, INFINITE );
+#else
+  pthread_mutex_lock( &p_event->mutex );
+
+  /* pthread_cond_wait is a cancellation point, the mutex is released if the waiter is cancelled there */
+  pthread_cleanup_push( _platform_unlock_mutex, &p_event->mutex );
+
+  while( !p_event->is_set ){
+    pthread_cond_wait( &p_event->cond, &p_event->mutex );
+  }
+
+  p_event->is_set = false;
+
+  pthread_cleanup_pop( 1 );
+#endif /* _WIN32 */
+}
+
+
+uint64_t platform_get_time_ns( void ){
+  struct timespec ts;
+  clock_gettime( CLOCK_MONOTONIC, &ts );
+  return ( (uint64_t) ts.tv_sec * PLATFORM_NS_PER_SEC ) + (uint64_t) ts.tv_nsec;
+}
+
+
+void platform_sleep_until_ns( uint64_t deadline_ns ){
+#ifdef _WIN32
+  uint64_t current_time_ns = platform_get_time_ns();
+
+  /* Sleep only takes a relative delay in milliseconds, rounded up so the deadline is never missed early */
+  if( deadline_ns > current_time_ns ){
+    Sleep( (DWORD) ( ( deadline_ns - current_time_ns + PLATFORM_NS_PER_MS - 1 ) / PLATFORM_NS_PER_MS ) );
+  }
+#else
+  struct timespec deadline = {
+    .tv_sec  = (time_t) ( deadline_ns / PLATFORM_NS_PER_SEC ),
+    .tv_nsec = (long) ( deadline_ns % PLATFORM_NS_PER_SEC )
+  };
+
+  /* An interrupted sleep is resumed to the same deadline */
+  while( clock_nanosleep( CLOCK_MONOTONIC, TIMER_ABSTIME, &deadline, NULL ) == EINTR );
+#endif /* _WIN32 */
+}
+
+
+uint32_t platform_get_cpu_count( void ){
+#ifdef _WIN32
+  SYSTEM_INFO system_info;
+
+  GetSystemInfo( &system_info );
+  return ( system_info.dwNumberOfProcessors > 0 ) ? (uint32_t) system_info.dwNumberOfProcessors : 1;
+#else
+  long cpu_count = sysconf( _SC_NPROCESSORS_ONLN );
+
+  return ( cpu_count > 0 ) ? (uint32_t) cpu_count : 1;
+#endif /* _WIN32 */
+}
+
+
+void platform_console_init( void ){
+#ifdef _WIN32
+  HANDLE hConsole = GetStdHandle( STD_OUTPUT_HANDLE );
+  DWORD console_mode = 0;
+
+  /* Cursor positioning escapes are only interpreted with virtual terminal processing */
+  if( GetConsoleMode( hConsole, &console_mode ) ){
+    SetConsoleMode( hConsole, console_mode | ENABLE_VIRTUAL_TERMINAL_PROCESSING );
+  }
+#endif /* _WIN32 */
+}
+
+
+void platform_console_clear( void ){
+#ifdef _WIN32
+  HANDLE hConsole = GetStdHandle( STD_OUTPUT_HANDLE );
+
+  CONSOLE_SCREEN_BUFFER_INFO csbi;
+  DWORD written;
+  DWORD consoleSize;
+
+  GetConsoleScreenBufferInfo( hConsole, &csbi );
+  consoleSize = csbi.dwSize.X * csbi.dwSize.Y;
+
+  FillConsoleOutputCharacter( hConsole, ' ', consoleSize, (COORD){0, 0}, &written );
+
+  SetConsoleCursorPosition( hConsole, (COORD){0, 0} );
+#else
+  static const char clear_text[] = "\033[2J\033[H";
+
+  platform_console_write( clear_text, sizeof( clear_text ) - 1 );
+#endif /* _WIN32 */
+}
+
+
+void platform_console_write( const char *p_text, size_t size ){
+  /* Text printed through stdio must reach the console first */
+  fflush( stdout );
+
+#ifdef _WIN32
+  HANDLE hConsole = GetStdHandle( STD_OUTPUT_HANDLE );
+  DWORD written   = 0;
+
+  /* WriteConsole fails when the output is redirected to a file or a pipe */
+  if( !WriteConsoleA( hConsole, p_text, (DWORD) size, &written, NULL ) ){
+    WriteFile( hConsole, p_text, (DWORD) size, &written, NULL );
+  }
+#else
+  ssize_t written = 0;
+
+  /* A terminal normally takes the whole buffer at once, a pipe may take it in parts */
+  while( size > 0 ){
+    written = write( STDOUT_FILENO, p_text, size );
+
+    if( written < 0 ){
+      if( errno == EINTR )
+        continue;
+
+      return;
+    }
+
+    p_text += written;
+    size   -= (size_t) written;
+  }
+#endif /* _WIN32 */
+}
+
+
+/* ==========================================================================================================
+ * Static Functions Declaration
+ */
+
+#ifdef _WIN32
+static DWORD WINAPI _platform_thread_entry( void *p_arg ){
+  PLATFORM_THREAD_T *p_thread = (PLATFORM_THREAD_T *) p_arg;
+
+  p_thread->exit_code = p_thread->func( p_thread->p_arg );
+
+  return p_thread->exit_code;
+}
+#else
+static void *_platform_thread_entry( void *p_arg ){
+  PLATFORM_THREAD_T *p_thread = (PLATFORM_THREAD_T *) p_arg;
+
+  p_thread->exit_code = p_thread->func( p_thread->p_arg );
+
+  pthread_mutex_lock( &platform_finished_mutex );
+  atomic_store( &p_thread->is_finished, true );
+  pthread_cond_broadcast( &platform_finished_cond );
+  pthread_mutex_unlock( &platform_finished_mutex );
+
+  return NULL;
+}
+
+
+static void _platform_unlock_mutex( void *p_arg ){
+  pthread_mutex_unlock( (pthread_mutex_t *) p_arg );
+}
+#endif /* _WIN32 */
+
+
+int8_t platform_file_map( PLATFORM_FILE_MAP_T *p_map, const char *p_path ){
+  p_map->p_data = NULL;
+  p_map->size   = 0;
+
+#ifdef _WIN32
+  LARGE_INTEGER file_size;
+
+  p_map->h_mapping = NULL;
+  p_map->h_file    = CreateFileA( p_path, GENERIC_READ, FILE_SHARE_READ, NULL, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, NULL );
+  if( p_map->h_file == INVALID_HANDLE_VALUE )
+    return TETRIS_RET_ERR;
+
+  if( !GetFileSizeEx( p_map->h_file, &file_size ) ){
+    platform_file_unmap( p_map );
+    return TETRIS_RET_ERR;
+  }
+
+  p_map->size = (size_t) file_size.QuadPart;
+
+  /* An empty file cannot be mapped, it is returned with no data */
+  if( p_map->size == 0 )
+    return TETRIS_RET_OK;
+
+  p_map->h_mapping = CreateFileMappingA( p_map->h_file, NULL, PAGE_READONLY, 0, 0, NULL );
+  if( p_map->h_mapping != NULL ){
+    p_map->p_data = (const uint8_t *) MapViewOfFile( p_map->h_mapping, FILE_MAP_READ, 0, 0, 0 );
+  }
+#else
+  struct stat file_stat;
+  void *p_data = NULL;
+  int fd       = open( p_path, O_RDONLY );
+
+  if( fd < 0 )
+    return TETRIS_RET_ERR;
+
+  if( fstat( fd, &file_stat ) != 0 ){
+    close( fd );
+    return TETRIS_RET_ERR;
+  }
+
+  p_map->size = (size_t) file_stat.st_size;
+
+  /* An empty file cannot be mapped, it is returned with no data */
+  if( p_map->size == 0 ){
+    close( fd );
+    return TETRIS_RET_OK;
+  }
+
+  /* The mapping keeps its own reference to the file, the descriptor is not needed anymore */
+  p_data = mmap( NULL, p_map->size, PROT_READ, MAP_PRIVATE, fd, 0 );
+  close( fd );
+
+  if( p_data != MAP_FAILED ){
+    p_map->p_data = (const uint8_t *) p_data;
+  }
+#endif /* _WIN32 */
+
+  if( p_map->p_data == NULL ){
+    platform_file_unmap( p_map );
+    return TETRIS_RET_ERR;
+  }
+
+  return TETRIS_RET_OK;
+}
+
+
+void platform_file_unmap( PLATFORM_FILE_MAP_T *p_map ){
+#ifdef _WIN32
+  if( p_map->p_data != NULL )
+    UnmapViewOfFile( p_map->p_data );
+
+  if( p_map->h_mapping != NULL )
+    CloseHandle( p_map->h_mapping );
+
+  if( p_map->h_file != INVALID_HANDLE_VALUE )
+    CloseHandle( p_map->h_file );
+
+  p_map->h_mapping = NULL;
+  p_map->h_file    = INVALID_HANDLE_VALUE;
+#else
+  if( p_map->p_data != NULL )
+    munmap( (void *) p_map->p_data, p_map->size );
+#endif /* _WIN32 */
+
+  p_map->p_data = NULL;
+  p_map->size   = 0;
+}
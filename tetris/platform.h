@@ -0,0 +1,242 @@
+/*
+ *  platform.h
+ *
+ *  Created on: 17-Oct-2026
+ *      Author: lucas-noce
+ */
+
+#ifndef _PLATFORM_H_
+#define _PLATFORM_H_
+
+
+/* ==========================================================================================================
+ * Includes
+ */
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <stddef.h>
+
+#ifdef _WIN32
+#include <windows.h>
+#else
+#include <pthread.h>
+#include <stdatomic.h>
+#endif /* _WIN32 */
+
+#include "main.h"
+
+
+/* ==========================================================================================================
+ * Definitions
+ */
+
+#define PLATFORM_THREAD_MAX_WAIT  8   // threads platform_thread_wait_any can wait on
+
+
+/* ==========================================================================================================
+ * Typedefs
+ */
+
+typedef uint32_t (*platform_thread_func_t)( void *p_arg );
+
+/*!
+  @brief        A thread, which must stay at the same address until it is joined.
+
+  @param        h_thread / thread: the OS thread.
+  @param        is_finished: set when the thread function returns (POSIX only, Windows waits on the handle).
+  @param        func: function run by the thread.
+  @param        p_arg: argument passed to the function.
+  @param        exit_code: value returned by the function.
+*/
+typedef struct PLATFORM_THREAD_TAG{
+#ifdef _WIN32
+  HANDLE                 h_thread;
+#else
+  pthread_t              thread;
+  atomic_bool            is_finished;
+#endif /* _WIN32 */
+  platform_thread_func_t func;
+  void                   *p_arg;
+  uint32_t               exit_code;
+} PLATFORM_THREAD_T;
+
+/*!
+  @brief        Auto-reset event: a wait returns once per set, a set without a waiter is kept for the next wait.
+
+  @param        h_event / mutex, cond, is_set: the OS objects.
+*/
+typedef struct PLATFORM_EVENT_TAG{
+#ifdef _WIN32
+  HANDLE          h_event;
+#else
+  pthread_mutex_t mutex;
+  pthread_cond_t  cond;
+  bool            is_set;
+#endif /* _WIN32 */
+} PLATFORM_EVENT_T;
+
+/*!
+  @brief        A file mapped read-only into memory, its pages are only read from the disk when they are touched.
+
+  @param        p_data: the contents of the file (NULL if the file is empty).
+  @param        size: number of bytes of the file.
+  @param        h_file, h_mapping: the OS objects (Windows only).
+*/
+typedef struct PLATFORM_FILE_MAP_TAG{
+  const uint8_t *p_data;
+  size_t        size;
+#ifdef _WIN32
+  HANDLE        h_file;
+  HANDLE        h_mapping;
+#endif /* _WIN32 */
+} PLATFORM_FILE_MAP_T;
+
+
+/* ==========================================================================================================
+ * Global Functions
+ */
+
+/*!
+  @brief        Starts a thread.
+
+  @param[out]   p_thread: pointer to the thread.
+  @param[in]    func: function run by the thread.
+  @param[in]    p_arg: argument passed to the function.
+
+  @returns      One of the possible TETRIS_RET_x macro values (defined in main.h).
+*/
+int8_t platform_thread_create( PLATFORM_THREAD_T *p_thread, platform_thread_func_t func, void *p_arg );
+
+/*!
+  @brief        Blocks until one of the threads returns.
+
+  @param[in]    p_threads: array of threads.
+  @param[in]    count: number of threads in the array (up to PLATFORM_THREAD_MAX_WAIT).
+
+  @returns      Index of the thread that returned, or TETRIS_RET_ERR.
+*/
+int8_t platform_thread_wait_any( PLATFORM_THREAD_T *p_threads, uint8_t count );
+
+/*!
+  @brief        Stops a thread that has not returned. On POSIX the thread stops at its next blocking call.
+
+  @param[in]    p_thread: pointer to the thread.
+
+  @returns      void
+*/
+void platform_thread_cancel( PLATFORM_THREAD_T *p_thread );
+
+/*!
+  @brief        Waits for a thread to end (returned or cancelled) and releases it.
+
+  @param[in]    p_thread: pointer to the thread.
+
+  @returns      void
+*/
+void platform_thread_join( PLATFORM_THREAD_T *p_thread );
+
+/*!
+  @brief        Creates an event, not set.
+
+  @param[out]   p_event: pointer to the event.
+
+  @returns      One of the possible TETRIS_RET_x macro values (defined in main.h).
+*/
+int8_t platform_event_init( PLATFORM_EVENT_T *p_event );
+
+/*!
+  @brief        Releases an event.
+
+  @param[in]    p_event: pointer to the event.
+
+  @returns      void
+*/
+void platform_event_deinit( PLATFORM_EVENT_T *p_event );
+
+/*!
+  @brief        Sets an event, waking up its waiter.
+
+  @param[in]    p_event: pointer to the event.
+
+  @returns      void
+*/
+void platform_event_set( PLATFORM_EVENT_T *p_event );
+
+/*!
+  @brief        Blocks until an event is set, then resets it.
+
+  @param[in]    p_event: pointer to the event.
+
+  @returns      void
+*/
+void platform_event_wait( PLATFORM_EVENT_T *p_event );
+
+/*!
+  @brief        Gets the time from the monotonic clock.
+
+  @returns      The time in nanoseconds.
+*/
+uint64_t platform_get_time_ns( void );
+
+/*!
+  @brief        Sleeps until the monotonic clock reaches a deadline. Sleeping to absolute deadlines keeps periodic
+                wakeups from drifting.
+
+  @param[in]    deadline_ns: the deadline, from platform_get_time_ns.
+
+  @returns      void
+*/
+void platform_sleep_until_ns( uint64_t deadline_ns );
+
+/*!
+  @brief        Gets the number of processors available to the process.
+
+  @returns      The number of processors (at least 1).
+*/
+uint32_t platform_get_cpu_count( void );
+
+/*!
+  @brief        Enables the processing of terminal escape sequences on the console output.
+
+  @returns      void
+*/
+void platform_console_init( void );
+
+/*!
+  @brief        Clears the console and moves the cursor to its top left corner.
+
+  @returns      void
+*/
+void platform_console_clear( void );
+
+/*!
+  @brief        Writes a buffer to the console output, with a single call when possible.
+
+  @param[in]    p_text: the buffer.
+  @param[in]    size: number of bytes to write.
+
+  @returns      void
+*/
+void platform_console_write( const char *p_text, size_t size );
+
+/*!
+  @brief        Maps a whole file read-only into memory.
+
+  @param[out]   p_map: pointer to the mapping.
+  @param[in]    p_path: path of the file.
+
+  @returns      One of the possible TETRIS_RET_x macro values (defined in main.h).
+*/
+int8_t platform_file_map( PLATFORM_FILE_MAP_T *p_map, const char *p_path );
+
+/*!
+  @brief        Releases a mapping made with platform_file_map.
+
+  @param[in]    p_map: pointer to the mapping.
+
+  @returns      void
+*/
+void platform_file_unmap( PLATFORM_FILE_MAP_T *p_map );
+
+#endif /* _PLATFORM_H_ */
@@ -0,0 +1,170 @@
+/*
+ *  randomizer.c
+ *
+ *  Created on: 17-Oct-2026
+ *      Author: lucas-noce
+ */
+
+/* ==========================================================================================================
+ * Includes
+ */
+
+#include <stdlib.h>
+#include <stdint.h>
+
+#include "main.h"
+#include "pieces.h"
+#include "randomizer.h"
+
+
+/* ==========================================================================================================
+ * Static Function Prototypes
+ */
+
+/*!
+  @brief        Rotates the bits of a word to the left.
+
+  @param[in]    x: the word.
+  @param[in]    k: number of bits (from 1 to 63).
+
+  @returns      The rotated word.
+*/
+static inline uint64_t _rng_rotl( uint64_t x, uint8_t k );
+
+/*!
+  @brief        Advances a splitmix64 generator, used to spread a seed over the generator state.
+
+  @param[in]    p_state: state of the generator.
+
+  @returns      The next random value.
+*/
+static uint64_t _splitmix64_next( uint64_t *p_state );
+
+/*!
+  @brief        Deals the next piece: the next shape of the bag (shuffling a new bag when it is empty), with a
+                random spawn rotation.
+
+  @param[in]    p_randomizer: pointer to the randomizer.
+
+  @returns      The piece.
+*/
+static RANDOMIZER_PIECE_T _randomizer_deal_piece( RANDOMIZER_STRUCT_T *p_randomizer );
+
+
+/* ==========================================================================================================
+ * Global Functions Declaration
+ */
+
+void rng_seed( RNG_STRUCT_T *p_rng, uint64_t seed ){
+  /* splitmix64 never outputs four zeros in a row, so the state is valid for any seed */
+  for( uint8_t i=0; i<4; i++ ){
+    p_rng->state[i] = _splitmix64_next( &seed );
+  }
+}
+
+
+uint64_t rng_next( RNG_STRUCT_T *p_rng ){
+  uint64_t *s     = p_rng->state;
+  uint64_t result = _rng_rotl( s[1] * 5, 7 ) * 9;
+  uint64_t t      = s[1] << 17;
+
+  s[2] ^= s[0];
+  s[3] ^= s[1];
+  s[1] ^= s[2];
+  s[0] ^= s[3];
+  s[2] ^= t;
+  s[3]  = _rng_rotl( s[3], 45 );
+
+  return result;
+}
+
+
+uint32_t rng_next_below( RNG_STRUCT_T *p_rng, uint32_t bound ){
+  uint64_t product   = (uint64_t) (uint32_t) ( rng_next( p_rng ) >> 32 ) * bound;
+  uint32_t threshold = 0;
+
+  /* Multiply and shift instead of a modulo, redrawing the few values that would make the result biased */
+  if( (uint32_t) product < bound ){
+    threshold = (uint32_t) -bound % bound;
+
+    while( (uint32_t) product < threshold ){
+      product = (uint64_t) (uint32_t) ( rng_next( p_rng ) >> 32 ) * bound;
+    }
+  }
+
+  return (uint32_t) ( product >> 32 );
+}
+
+
+void randomizer_init( RANDOMIZER_STRUCT_T *p_randomizer, uint64_t seed ){
+  rng_seed( &p_randomizer->rng, seed );
+
+  p_randomizer->bag_idx      = PIECE_SHAPE_LAST_IDX;
+  p_randomizer->preview_head = 0;
+
+  for( uint8_t i=0; i<RANDOMIZER_PREVIEW_SIZE; i++ ){
+    p_randomizer->preview[i] = _randomizer_deal_piece( p_randomizer );
+  }
+}
+
+
+RANDOMIZER_PIECE_T randomizer_next_piece( RANDOMIZER_STRUCT_T *p_randomizer ){
+  RANDOMIZER_PIECE_T piece = p_randomizer->preview[p_randomizer->preview_head];
+
+  p_randomizer->preview[p_randomizer->preview_head] = _randomizer_deal_piece( p_randomizer );
+  p_randomizer->preview_head = ( p_randomizer->preview_head + 1 ) % RANDOMIZER_PREVIEW_SIZE;
+
+  return piece;
+}
+
+
+RANDOMIZER_PIECE_T randomizer_peek_piece( const RANDOMIZER_STRUCT_T *p_randomizer, uint8_t idx ){
+  return p_randomizer->preview[( p_randomizer->preview_head + idx ) % RANDOMIZER_PREVIEW_SIZE];
+}
+
+
+/* ==========================================================================================================
+ * Static Functions Declaration
+ */
+
+static inline uint64_t _rng_rotl( uint64_t x, uint8_t k ){
+  return ( x << k ) | ( x >> ( 64 - k ) );
+}
+
+
+static uint64_t _splitmix64_next( uint64_t *p_state ){
+  uint64_t z = ( *p_state += 0x9E3779B97F4A7C15ull );
+
+  z = ( z ^ ( z >> 30 ) ) * 0xBF58476D1CE4E5B9ull;
+  z = ( z ^ ( z >> 27 ) ) * 0x94D049BB133111EBull;
+
+  return z ^ ( z >> 31 );
+}
+
+
+static RANDOMIZER_PIECE_T _randomizer_deal_piece( RANDOMIZER_STRUCT_T *p_randomizer ){
+  RANDOMIZER_PIECE_T piece;
+  uint8_t swap_idx = 0;
+  uint8_t shape    = 0;
+
+  if( p_randomizer->bag_idx >= PIECE_SHAPE_LAST_IDX ){
+    /* Fisher-Yates shuffle of a new bag with one piece of each shape */
+    for( uint8_t i=0; i<PIECE_SHAPE_LAST_IDX; i++ ){
+      p_randomizer->bag[i] = i;
+    }
+
+    for( uint8_t i=PIECE_SHAPE_LAST_IDX-1; i>0; i-- ){
+      swap_idx                    = (uint8_t) rng_next_below( &p_randomizer->rng, i + 1 );
+      shape                       = p_randomizer->bag[i];
+      p_randomizer->bag[i]        = p_randomizer->bag[swap_idx];
+      p_randomizer->bag[swap_idx] = shape;
+    }
+
+    p_randomizer->bag_idx = 0;
+  }
+
+  piece.type     = p_randomizer->bag[p_randomizer->bag_idx++];
+  piece.rotation = (uint8_t) rng_next_below( &p_randomizer->rng, PIECE_ROTATION_COUNT );
+
+  return piece;
+}
@@ -0,0 +1,137 @@
+/*
+ *  randomizer.h
+ *
+ *  Created on: 17-Oct-2026
+ *      Author: lucas-noce
+ */
+
+#ifndef _RANDOMIZER_H_
+#define _RANDOMIZER_H_
+
+
+/* ==========================================================================================================
+ * Includes
+ */
+
+#include <stdint.h>
+
+#include "main.h"
+#include "game_config.h"
+#include "pieces.h"
+
+
+/* ==========================================================================================================
+ * Definitions
+ */
+
+#define RANDOMIZER_PREVIEW_SIZE  GAME_CONFIG_PREVIEW_SIZE
+
+
+/* ==========================================================================================================
+ * Typedefs
+ */
+
+/*!
+  @brief        State of a xoshiro256** pseudo random generator. The same seed always gives the same sequence, on
+                every platform.
+
+  @param        state: the 256 bits of state (never all zero).
+*/
+typedef struct RNG_STRUCT_TAG{
+  uint64_t state[4];
+} RNG_STRUCT_T;
+
+/*!
+  @brief        A piece waiting to be spawned.
+
+  @param        type: the piece shape (from PIECE_SHAPES_E).
+  @param        rotation: number of 90 degree rotations it spawns with (less than PIECE_ROTATION_COUNT).
+*/
+typedef struct RANDOMIZER_PIECE_TAG{
+  uint8_t type;
+  uint8_t rotation;
+} RANDOMIZER_PIECE_T;
+
+/*!
+  @brief        Deals the pieces of a game: every shape comes once in each bag of PIECE_SHAPE_LAST_IDX pieces, in a
+                shuffled order, and the next pieces are known ahead in a preview queue.
+
+  @param        rng: the generator, only used by the randomizer.
+  @param        bag: the shapes of the current bag, in the order they are dealt.
+  @param        bag_idx: index of the next shape to deal from `bag` (PIECE_SHAPE_LAST_IDX when a new bag is due).
+  @param        preview: ring of the next pieces to spawn.
+  @param        preview_head: index in `preview` of the next piece to spawn.
+*/
+typedef struct RANDOMIZER_STRUCT_TAG{
+  RNG_STRUCT_T       rng;
+  uint8_t            bag[PIECE_SHAPE_LAST_IDX];
+  uint8_t            bag_idx;
+  RANDOMIZER_PIECE_T preview[RANDOMIZER_PREVIEW_SIZE];
+  uint8_t            preview_head;
+} RANDOMIZER_STRUCT_T;
+
+
+/* ==========================================================================================================
+ * Global Functions
+ */
+
+/*!
+  @brief        Seeds a generator. Every seed (0 included) gives a valid and different state.
+
+  @param[out]   p_rng: pointer to the generator.
+  @param[in]    seed: the seed.
+
+  @returns      void
+*/
+void rng_seed( RNG_STRUCT_T *p_rng, uint64_t seed );
+
+/*!
+  @brief        Advances a generator.
+
+  @param[in]    p_rng: pointer to the generator.
+
+  @returns      The next 64 random bits.
+*/
+uint64_t rng_next( RNG_STRUCT_T *p_rng );
+
+/*!
+  @brief        Draws an unbiased random number in a range.
+
+  @param[in]    p_rng: pointer to the generator.
+  @param[in]    bound: upper limit of the range (excluded, greater than 0).
+
+  @returns      A random number from 0 to bound - 1.
+*/
+uint32_t rng_next_below( RNG_STRUCT_T *p_rng, uint32_t bound );
+
+/*!
+  @brief        Seeds the randomizer and fills its preview queue.
+
+  @param[out]   p_randomizer: pointer to the randomizer.
+  @param[in]    seed: the seed, the whole sequence of pieces only depends on it.
+
+  @returns      void
+*/
+void randomizer_init( RANDOMIZER_STRUCT_T *p_randomizer, uint64_t seed );
+
+/*!
+  @brief        Takes the next piece out of the preview queue, and deals a new one at its end.
+
+  @param[in]    p_randomizer: pointer to the randomizer.
+
+  @returns      The piece to spawn.
+*/
+RANDOMIZER_PIECE_T randomizer_next_piece( RANDOMIZER_STRUCT_T *p_randomizer );
+
+/*!
+  @brief        Gets a piece of the preview queue, without taking it.
+
+  @param[in]    p_randomizer: pointer to the randomizer.
+  @param[in]    idx: position in the queue, 0 is the piece returned by the next randomizer_next_piece call (less
+                than RANDOMIZER_PREVIEW_SIZE).
+
+  @returns      The piece.
+*/
+RANDOMIZER_PIECE_T randomizer_peek_piece( const RANDOMIZER_STRUCT_T *p_randomizer, uint8_t idx );
+
+#endif /* _RANDOMIZER_H_ */
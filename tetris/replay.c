@@ -0,0 +1,780 @@
+/*
+ *  replay.c
+ *
+ *  Created on: 17-Oct-2026
+ *      Author: lucas-noce
+ */
+
+/* ==========================================================================================================
+ * Includes
+ */
+
+#include <stdlib.h>
+#include <stdio.h>
+#include <stdint.h>
+#include <stdbool.h>
+#include <string.h>
+#include <stdatomic.h>
+
+#include "main.h"
+#include "game_config.h"
+#include "board.h"
+#include "score.h"
+#include "game.h"
+#include "command.h"
+#include "platform.h"
+#include "replay.h"
+
+
+/* ==========================================================================================================
+ * Definitions
+ */
+
+#define REPLAY_VARINT_MAX_SIZE  10   // bytes of a 64-bit varint
+
+#define REPLAY_INDEX_INITIAL_CAPACITY  64
+
+
+/* ==========================================================================================================
+ * Static Function Prototypes
+ */
+
+/*!
+  @brief        Writes the chunks handed over by the game loop to the replay file, until the writer is closed.
+
+  @param[in]    data: pointer to the REPLAY_WRITER_T.
+
+  @returns      0
+*/
+static uint32_t _replay_flush_thread( void *data );
+
+/*!
+  @brief        Gets the chunk the game loop is filling, handing it to the flush thread first if the next record
+                may not fit in it.
+
+  @param[in]    p_writer: pointer to the writer.
+  @param[in]    record_size: largest size of the next record (at most REPLAY_CHUNK_SIZE).
+
+  @returns      Pointer to the chunk, or NULL if every chunk is waiting to be flushed.
+*/
+static REPLAY_CHUNK_T *_replay_get_chunk( REPLAY_WRITER_T *p_writer, size_t record_size );
+
+/*!
+  @brief        Hands the chunk the game loop is filling to the flush thread.
+
+  @param[in]    p_writer: pointer to the writer.
+
+  @returns      void
+*/
+static void _replay_hand_over_chunk( REPLAY_WRITER_T *p_writer );
+
+/*!
+  @brief        Encodes the tick delta and the type of a record at the end of a chunk.
+
+  @param[in]    p_writer: pointer to the writer.
+  @param[in]    p_chunk: the chunk.
+  @param[in]    tick: tick of the record.
+  @param[in]    type: a GAME_COMMANDS_E or REPLAY_EVENTS_E value.
+
+  @returns      void
+*/
+static void _replay_put_event( REPLAY_WRITER_T *p_writer, REPLAY_CHUNK_T *p_chunk, uint64_t tick, uint8_t type );
+
+/*!
+  @brief        Encodes a varint at the end of a chunk.
+
+  @param[in]    p_chunk: the chunk (with at least REPLAY_VARINT_MAX_SIZE free bytes).
+  @param[in]    value: the value.
+
+  @returns      void
+*/
+static void _replay_put_varint( REPLAY_CHUNK_T *p_chunk, uint64_t value );
+
+/*!
+  @brief        Encodes a little endian fixed size field at the end of a chunk.
+
+  @param[in]    p_chunk: the chunk.
+  @param[in]    value: the value.
+  @param[in]    size: number of bytes of the field.
+
+  @returns      void
+*/
+static void _replay_put_fixed( REPLAY_CHUNK_T *p_chunk, uint64_t value, uint8_t size );
+
+/*!
+  @brief        Resets a game created with replay_create_game to the tick 0 of the replay, and the reader to its
+                first record.
+
+  @param[in]    p_reader: pointer to the reader.
+  @param[in]    p_game: the game.
+
+  @returns      void
+*/
+static void _replay_restart( REPLAY_READER_T *p_reader, tetris_game_t *p_game );
+
+/*!
+  @brief        Reads an entry of the keyframe index.
+
+  @param[in]    p_reader: pointer to the reader (with an index).
+  @param[in]    idx: index of the entry (less than index_count).
+  @param[out]   p_entry: the entry.
+
+  @returns      void
+*/
+static void _replay_get_index_entry( const REPLAY_READER_T *p_reader, uint32_t idx, REPLAY_INDEX_ENTRY_T *p_entry );
+
+/*!
+  @brief        Decodes a little endian fixed size field from memory.
+
+  @param[in]    p_data: the field.
+  @param[in]    size: number of bytes of the field.
+
+  @returns      The value.
+*/
+static uint64_t _replay_decode_fixed( const uint8_t *p_data, uint8_t size );
+
+/*!
+  @brief        Decodes a varint.
+
+  @param[in]    p_reader: pointer to the reader.
+  @param[out]   p_value: the value.
+
+  @returns      TETRIS_RET_OK, or TETRIS_RET_ERR if the replay ends in the middle of the varint or it is too long.
+*/
+static int8_t _replay_get_varint( REPLAY_READER_T *p_reader, uint64_t *p_value );
+
+/*!
+  @brief        Decodes a little endian fixed size field.
+
+  @param[in]    p_reader: pointer to the reader.
+  @param[in]    size: number of bytes of the field.
+  @param[out]   p_value: the value.
+
+  @returns      TETRIS_RET_OK, or TETRIS_RET_ERR if the replay ends in the middle of the field.
+*/
+static int8_t _replay_get_fixed( REPLAY_READER_T *p_reader, uint8_t size, uint64_t *p_value );
+
+
+/* ==========================================================================================================
+ * Global Functions Declaration
+ */
+
+int8_t replay_writer_open( REPLAY_WRITER_T *p_writer, const char *p_path, const REPLAY_HEADER_T *p_header ){
+  REPLAY_CHUNK_T *p_chunk = NULL;
+
+  memset( p_writer, 0, sizeof( REPLAY_WRITER_T ) );
+
+  p_writer->p_chunks = game_aligned_alloc( REPLAY_CHUNK_COUNT * sizeof( REPLAY_CHUNK_T ) );
+  if( p_writer->p_chunks == NULL )
+    return TETRIS_RET_ERR;
+
+  if( platform_event_init( &p_writer->flush_event ) != TETRIS_RET_OK ){
+    game_aligned_free( p_writer->p_chunks );
+    return TETRIS_RET_ERR;
+  }
+
+  /* Binary mode, so no newline translation on Windows */
+  p_writer->p_file = fopen( p_path, "wb" );
+  if( p_writer->p_file == NULL ){
+    LOG_WRN( "Failed to create the replay file %s\n", p_path );
+    platform_event_deinit( &p_writer->flush_event );
+    game_aligned_free( p_writer->p_chunks );
+    return TETRIS_RET_ERR;
+  }
+
+  atomic_init( &p_writer->ready_count, 0 );
+  atomic_init( &p_writer->flushed_count, 0 );
+  atomic_init( &p_writer->is_closing, false );
+
+  /* Tick 0 needs no keyframe, the game is rebuilt from the header */
+  p_writer->next_keyframe_piece = REPLAY_KEYFRAME_INTERVAL;
+
+  p_chunk       = &p_writer->p_chunks[0];
+  p_chunk->size = 0;
+
+  memcpy( p_chunk->data, REPLAY_MAGIC, REPLAY_MAGIC_SIZE );
+  p_chunk->size += REPLAY_MAGIC_SIZE;
+
+  _replay_put_fixed( p_chunk, REPLAY_VERSION, 1 );
+  _replay_put_fixed( p_chunk, p_header->seed, 8 );
+  _replay_put_fixed( p_chunk, p_header->row_size, 2 );
+  _replay_put_fixed( p_chunk, p_header->col_size, 2 );
+  _replay_put_fixed( p_chunk, p_header->difficulty, 1 );
+  _replay_put_fixed( p_chunk, p_header->tick_ms, 1 );
+
+  if( platform_thread_create( &p_writer->flush_thread, _replay_flush_thread, p_writer ) != TETRIS_RET_OK ){
+    fclose( p_writer->p_file );
+    p_writer->p_file = NULL;
+    platform_event_deinit( &p_writer->flush_event );
+    game_aligned_free( p_writer->p_chunks );
+    return TETRIS_RET_ERR;
+  }
+
+  return TETRIS_RET_OK;
+}
+
+
+void replay_record_command( REPLAY_WRITER_T *p_writer, uint64_t tick, uint8_t command_type ){
+  REPLAY_CHUNK_T *p_chunk = NULL;
+
+  if( p_writer->p_file == NULL || p_writer->is_overflowed )
+    return;
+
+  p_chunk = _replay_get_chunk( p_writer, REPLAY_MAX_RECORD_SIZE );
+  if( p_chunk == NULL )
+    return;
+
+  _replay_put_event( p_writer, p_chunk, tick, command_type );
+}
+
+
+void replay_record_state( REPLAY_WRITER_T *p_writer, tetris_game_t *p_game ){
+  REPLAY_INDEX_ENTRY_T *p_index = NULL;
+  REPLAY_CHUNK_T *p_chunk       = NULL;
+  size_t state_size             = 0;
+
+  if( p_writer->p_file == NULL || p_writer->is_overflowed || p_game->board.piece_count < p_writer->next_keyframe_piece )
+    return;
+
+  p_writer->next_keyframe_piece = p_game->board.piece_count + REPLAY_KEYFRAME_INTERVAL;
+  state_size                    = game_state_size( p_game );
+
+  /* A keyframe must fit in a single chunk, the boards too large for that are only replayed from the start */
+  if( state_size + REPLAY_MAX_RECORD_SIZE > REPLAY_CHUNK_SIZE )
+    return;
+
+  if( p_writer->index_count == p_writer->index_capacity ){
+    uint32_t capacity = ( p_writer->index_capacity == 0 ) ? REPLAY_INDEX_INITIAL_CAPACITY : p_writer->index_capacity * 2;
+
+    p_index = realloc( p_writer->p_index, capacity * sizeof( REPLAY_INDEX_ENTRY_T ) );
+    if( p_index == NULL )
+      return;
+
+    p_writer->p_index        = p_index;
+    p_writer->index_capacity = capacity;
+  }
+
+  p_chunk = _replay_get_chunk( p_writer, state_size + REPLAY_MAX_RECORD_SIZE );
+  if( p_chunk == NULL )
+    return;
+
+  _replay_put_event( p_writer, p_chunk, p_game->clock.tick, REPLAY_EVENT_KEYFRAME );
+  _replay_put_varint( p_chunk, state_size );
+
+  p_index               = &p_writer->p_index[p_writer->index_count++];
+  p_index->tick         = p_game->clock.tick;
+  p_index->state_offset = p_writer->chunk_offset + p_chunk->size;
+  p_index->state_size   = (uint32_t) state_size;
+
+  game_save_state( p_game, &p_chunk->data[p_chunk->size] );
+  p_chunk->size += (uint32_t) state_size;
+}
+
+
+void replay_writer_close( REPLAY_WRITER_T *p_writer, tetris_game_t *p_game ){
+  REPLAY_CHUNK_T *p_chunk = NULL;
+  uint64_t index_offset   = 0;
+
+  if( p_writer->p_file == NULL )
+    return;
+
+  /* A replay that lost records has no end record, so it never verifies */
+  p_chunk = p_writer->is_overflowed ? NULL : _replay_get_chunk( p_writer, REPLAY_MAX_RECORD_SIZE );
+
+  if( p_chunk != NULL ){
+    _replay_put_event( p_writer, p_chunk, p_game->clock.tick, REPLAY_EVENT_END );
+    _replay_put_varint( p_chunk, score_get_game_score( p_game ) );
+    _replay_put_varint( p_chunk, p_game->board.piece_count );
+    _replay_put_fixed( p_chunk, board_hash( p_game ), 8 );
+    _replay_put_fixed( p_chunk, board_get_zobrist_hash( p_game ), 8 );
+
+    /* The index goes after the end record, the trailer at the very end of the file points back to it */
+    index_offset = p_writer->chunk_offset + p_chunk->size;
+
+    for( uint32_t i=0; i<p_writer->index_count && p_chunk != NULL; i++ ){
+      p_chunk = _replay_get_chunk( p_writer, REPLAY_MAX_RECORD_SIZE );
+
+      if( p_chunk != NULL ){
+        _replay_put_fixed( p_chunk, p_writer->p_index[i].tick, 8 );
+        _replay_put_fixed( p_chunk, p_writer->p_index[i].state_offset, 8 );
+        _replay_put_fixed( p_chunk, p_writer->p_index[i].state_size, 4 );
+      }
+    }
+
+    p_chunk = ( p_chunk != NULL ) ? _replay_get_chunk( p_writer, REPLAY_MAX_RECORD_SIZE ) : NULL;
+
+    if( p_chunk != NULL ){
+      _replay_put_fixed( p_chunk, index_offset, 8 );
+      _replay_put_fixed( p_chunk, p_writer->index_count, 4 );
+      memcpy( &p_chunk->data[p_chunk->size], REPLAY_INDEX_MAGIC, REPLAY_MAGIC_SIZE );
+      p_chunk->size += REPLAY_MAGIC_SIZE;
+    }
+
+    _replay_hand_over_chunk( p_writer );
+  }
+
+  atomic_store_explicit( &p_writer->is_closing, true, memory_order_release );
+  platform_event_set( &p_writer->flush_event );
+  platform_thread_join( &p_writer->flush_thread );
+
+  fclose( p_writer->p_file );
+  p_writer->p_file = NULL;
+
+  platform_event_deinit( &p_writer->flush_event );
+  game_aligned_free( p_writer->p_chunks );
+  p_writer->p_chunks = NULL;
+
+  free( p_writer->p_index );
+  p_writer->p_index        = NULL;
+  p_writer->index_count    = 0;
+  p_writer->index_capacity = 0;
+}
+
+
+int8_t replay_reader_open( REPLAY_READER_T *p_reader, const uint8_t *p_data, size_t size ){
+  uint64_t value = 0;
+
+  uint64_t index_offset = 0;
+  uint64_t index_count  = 0;
+
+  p_reader->p_data      = p_data;
+  p_reader->size        = size;
+  p_reader->offset      = 0;
+  p_reader->tick        = 0;
+  p_reader->p_index     = NULL;
+  p_reader->index_count = 0;
+
+  if( size < REPLAY_HEADER_SIZE || memcmp( p_data, REPLAY_MAGIC, REPLAY_MAGIC_SIZE ) != 0 ){
+    LOG_WRN( "Not a replay file\n" );
+    return TETRIS_RET_ERR;
+  }
+
+  p_reader->offset = REPLAY_MAGIC_SIZE;
+
+  _replay_get_fixed( p_reader, 1, &value );
+  if( value == 0 || value > REPLAY_VERSION ){
+    LOG_WRN( "Unsupported replay version %u\n", (unsigned) value );
+    return TETRIS_RET_ERR;
+  }
+
+  p_reader->version = (uint8_t) value;
+
+  _replay_get_fixed( p_reader, 8, &value );
+  p_reader->header.seed = value;
+  _replay_get_fixed( p_reader, 2, &value );
+  p_reader->header.row_size = (uint16_t) value;
+  _replay_get_fixed( p_reader, 2, &value );
+  p_reader->header.col_size = (uint16_t) value;
+  _replay_get_fixed( p_reader, 1, &value );
+  p_reader->header.difficulty = (uint8_t) value;
+  _replay_get_fixed( p_reader, 1, &value );
+  p_reader->header.tick_ms = (uint8_t) value;
+
+  /* The records stop where the index starts. Without a trailer (old or cut short replay) there is no index */
+  if( size >= REPLAY_HEADER_SIZE + REPLAY_TRAILER_SIZE &&
+      memcmp( &p_data[size - REPLAY_MAGIC_SIZE], REPLAY_INDEX_MAGIC, REPLAY_MAGIC_SIZE ) == 0 ){
+    index_offset = _replay_decode_fixed( &p_data[size - REPLAY_TRAILER_SIZE], 8 );
+    index_count  = _replay_decode_fixed( &p_data[size - REPLAY_TRAILER_SIZE + 8], 4 );
+
+    if( index_offset < REPLAY_HEADER_SIZE || index_offset > size ||
+        ( size - index_offset ) != index_count * REPLAY_INDEX_ENTRY_SIZE + REPLAY_TRAILER_SIZE ){
+      LOG_WRN( "Corrupted replay index\n" );
+      return TETRIS_RET_ERR;
+    }
+
+    p_reader->size        = (size_t) index_offset;
+    p_reader->p_index     = &p_data[index_offset];
+    p_reader->index_count = (uint32_t) index_count;
+  }
+
+  return TETRIS_RET_OK;
+}
+
+
+int8_t replay_reader_next( REPLAY_READER_T *p_reader, REPLAY_EVENT_T *p_event ){
+  uint64_t value = 0;
+
+  if( p_reader->offset >= p_reader->size || _replay_get_varint( p_reader, &value ) != TETRIS_RET_OK )
+    return TETRIS_RET_ERR;
+
+  p_reader->tick += value >> REPLAY_EVENT_BITS;
+
+  p_event->type         = (uint8_t) ( value & REPLAY_EVENT_MASK );
+  p_event->tick         = p_reader->tick;
+  p_event->score        = 0;
+  p_event->piece_count  = 0;
+  p_event->board_hash   = 0;
+  p_event->zobrist_hash = 0;
+  p_event->p_state      = NULL;
+  p_event->state_size   = 0;
+
+  if( p_event->type >= REPLAY_EVENT_LAST_IDX ){
+    LOG_WRN( "Unknown replay event %u\n", p_event->type );
+    return TETRIS_RET_ERR;
+  }
+
+  if( p_event->type == REPLAY_EVENT_END ){
+    if( _replay_get_varint( p_reader, &value ) != TETRIS_RET_OK )
+      return TETRIS_RET_ERR;
+    p_event->score = (uint32_t) value;
+
+    if( _replay_get_varint( p_reader, &value ) != TETRIS_RET_OK )
+      return TETRIS_RET_ERR;
+    p_event->piece_count = (uint32_t) value;
+
+    if( _replay_get_fixed( p_reader, 8, &p_event->board_hash ) != TETRIS_RET_OK )
+      return TETRIS_RET_ERR;
+
+    if( p_reader->version >= 3 && _replay_get_fixed( p_reader, 8, &p_event->zobrist_hash ) != TETRIS_RET_OK )
+      return TETRIS_RET_ERR;
+  }
+  else if( p_event->type == REPLAY_EVENT_KEYFRAME ){
+    if( _replay_get_varint( p_reader, &value ) != TETRIS_RET_OK || value > p_reader->size - p_reader->offset )
+      return TETRIS_RET_ERR;
+
+    /* The state is not copied, it points into the replay data */
+    p_event->p_state    = &p_reader->p_data[p_reader->offset];
+    p_event->state_size = (uint32_t) value;
+    p_reader->offset   += (size_t) value;
+  }
+
+  return TETRIS_RET_OK;
+}
+
+
+tetris_game_t *replay_create_game( const REPLAY_READER_T *p_reader ){
+  tetris_game_t *p_game = NULL;
+
+  if( p_reader->header.tick_ms != GAME_CONFIG_TICK_MS ){
+    LOG_WRN( "Replay recorded with %u ms ticks, this build uses %u ms\n", p_reader->header.tick_ms, GAME_CONFIG_TICK_MS );
+    return NULL;
+  }
+
+  p_game = game_create( p_reader->header.row_size, p_reader->header.col_size );
+  if( p_game == NULL )
+    return NULL;
+
+  game_set_seed( p_game, p_reader->header.seed );
+  score_set_difficulty( p_game, p_reader->header.difficulty );
+
+  return p_game;
+}
+
+
+int8_t replay_seek( REPLAY_READER_T *p_reader, tetris_game_t *p_game, uint64_t tick, uint8_t *p_game_status ){
+  REPLAY_INDEX_ENTRY_T entry;
+  REPLAY_EVENT_T event;
+  size_t offset      = 0;
+  uint64_t last_tick = 0;
+  uint32_t low       = 0;
+  uint32_t high      = p_reader->index_count;
+  bool is_ended      = false;
+
+  *p_game_status = TETRIS_GAME_NOT_OVER;
+
+  /* Binary search of the last keyframe at or before the tick */
+  while( low < high ){
+    uint32_t mid = low + ( high - low ) / 2;
+
+    _replay_get_index_entry( p_reader, mid, &entry );
+
+    if( entry.tick <= tick ){
+      low = mid + 1;
+    }
+    else{
+      high = mid;
+    }
+  }
+
+  _replay_restart( p_reader, p_game );
+
+  if( low > 0 ){
+    _replay_get_index_entry( p_reader, low - 1, &entry );
+
+    if( entry.state_offset + entry.state_size > p_reader->size ||
+        game_load_state( p_game, &p_reader->p_data[entry.state_offset], entry.state_size ) != TETRIS_RET_OK ){
+      LOG_WRN( "Corrupted keyframe at tick %llu\n", (unsigned long long) entry.tick );
+      return TETRIS_RET_ERR;
+    }
+
+    p_reader->offset = (size_t) ( entry.state_offset + entry.state_size );
+    p_reader->tick   = entry.tick;
+  }
+
+  while( !is_ended && *p_game_status == TETRIS_GAME_NOT_OVER ){
+    offset    = p_reader->offset;
+    last_tick = p_reader->tick;
+
+    if( replay_reader_next( p_reader, &event ) != TETRIS_RET_OK )
+      break;
+
+    /* The record is past the tick, it is left for the next read */
+    if( event.tick > tick ){
+      p_reader->offset = offset;
+      p_reader->tick   = last_tick;
+      break;
+    }
+
+    while( p_game->clock.tick < event.tick && *p_game_status == TETRIS_GAME_NOT_OVER ){
+      *p_game_status = game_tick( p_game );
+    }
+
+    if( event.type == REPLAY_EVENT_END ){
+      is_ended = true;
+    }
+    else if( event.type == REPLAY_EVENT_KEYFRAME ){
+      /* Without an index the keyframes are met on the way, loading one is cheaper than trusting the simulation */
+      if( game_load_state( p_game, event.p_state, event.state_size ) != TETRIS_RET_OK )
+        return TETRIS_RET_ERR;
+    }
+    else{
+      game_apply_command( p_game, event.type );
+    }
+  }
+
+  /* The ticks after the last record only ran the clock, unless the game ended */
+  while( !is_ended && p_game->clock.tick < tick && *p_game_status == TETRIS_GAME_NOT_OVER ){
+    *p_game_status = game_tick( p_game );
+  }
+
+  return TETRIS_RET_OK;
+}
+
+
+int8_t replay_verify( const uint8_t *p_data, size_t size, REPLAY_RESULT_T *p_result ){
+  REPLAY_READER_T reader;
+  REPLAY_EVENT_T event;
+  tetris_game_t *p_game     = NULL;
+  tetris_game_t *p_keyframe = NULL;
+  bool is_ended             = false;
+  bool is_matching          = true;
+
+  memset( p_result, 0, sizeof( REPLAY_RESULT_T ) );
+  p_result->game_status = TETRIS_GAME_NOT_OVER;
+
+  if( replay_reader_open( &reader, p_data, size ) != TETRIS_RET_OK )
+    return TETRIS_RET_ERR;
+
+  p_game     = replay_create_game( &reader );
+  p_keyframe = replay_create_game( &reader );
+
+  if( p_game == NULL || p_keyframe == NULL ){
+    game_destroy( p_game );
+    game_destroy( p_keyframe );
+    return TETRIS_RET_ERR;
+  }
+
+  while( !is_ended && replay_reader_next( &reader, &event ) == TETRIS_RET_OK ){
+    /* The ticks between two records only ran the clock, the game sees them exactly as when it was recorded */
+    while( p_game->clock.tick < event.tick && p_result->game_status == TETRIS_GAME_NOT_OVER ){
+      p_result->game_status = game_tick( p_game );
+    }
+
+    if( event.type == REPLAY_EVENT_END ){
+      p_result->expected = event;
+      is_ended           = true;
+    }
+    else if( event.type == REPLAY_EVENT_KEYFRAME ){
+      /* A keyframe is only useful to seek if it holds the same game as the one played from the start. The Zobrist
+         hashes compare the boards without going through their cells again */
+      if( game_load_state( p_keyframe, event.p_state, event.state_size ) != TETRIS_RET_OK ||
+          p_keyframe->clock.tick != p_game->clock.tick ||
+          board_get_zobrist_hash( p_keyframe ) != board_get_zobrist_hash( p_game ) ||
+          score_get_game_score( p_keyframe ) != score_get_game_score( p_game ) ||
+          p_keyframe->board.piece_count != p_game->board.piece_count ){
+        LOG_WRN( "Keyframe at tick %llu does not match the game\n", (unsigned long long) event.tick );
+        is_matching = false;
+      }
+
+      p_result->keyframe_count++;
+    }
+    else{
+      game_apply_command( p_game, event.type );
+      p_result->command_count++;
+    }
+  }
+
+  p_result->tick        = p_game->clock.tick;
+  p_result->score       = score_get_game_score( p_game );
+  p_result->piece_count = p_game->board.piece_count;
+  p_result->board_hash  = board_hash( p_game );
+
+  /* The hash kept along the game only matches its cells if every fix and clear updated it */
+  p_result->zobrist_hash       = board_get_zobrist_hash( p_game );
+  p_result->is_hash_consistent = ( board_compute_zobrist_hash( p_game ) == p_game->board.zobrist_hash );
+
+  game_destroy( p_game );
+  game_destroy( p_keyframe );
+
+  if( !is_ended ){
+    LOG_WRN( "Replay has no end record\n" );
+    return TETRIS_RET_ERR;
+  }
+
+  if( !is_matching || p_result->tick != p_result->expected.tick || p_result->score != p_result->expected.score ||
+      p_result->piece_count != p_result->expected.piece_count || p_result->board_hash != p_result->expected.board_hash ||
+      !p_result->is_hash_consistent )
+    return TETRIS_RET_ERR;
+
+  if( reader.version >= 3 && p_result->zobrist_hash != p_result->expected.zobrist_hash )
+    return TETRIS_RET_ERR;
+
+  return TETRIS_RET_OK;
+}
+
+
+/* ==========================================================================================================
+ * Static Functions Declaration
+ */
+
+static uint32_t _replay_flush_thread( void *data ){
+  REPLAY_WRITER_T *p_writer = (REPLAY_WRITER_T *) data;
+  REPLAY_CHUNK_T *p_chunk   = NULL;
+  unsigned int flushed      = 0;
+  bool is_closing           = false;
+
+  while( 1 ){
+    platform_event_wait( &p_writer->flush_event );
+
+    /* Read before the chunk count, so the last chunk handed over is never missed */
+    is_closing = atomic_load_explicit( &p_writer->is_closing, memory_order_acquire );
+
+    while( flushed != atomic_load_explicit( &p_writer->ready_count, memory_order_acquire ) ){
+      p_chunk = &p_writer->p_chunks[flushed % REPLAY_CHUNK_COUNT];
+
+      if( fwrite( p_chunk->data, 1, p_chunk->size, p_writer->p_file ) != p_chunk->size ){
+        LOG_WRN( "Failed to write the replay file\n" );
+      }
+
+      flushed++;
+      atomic_store_explicit( &p_writer->flushed_count, flushed, memory_order_release );
+    }
+
+    fflush( p_writer->p_file );
+
+    if( is_closing )
+      return 0;
+  }
+
+  return 0;
+}
+
+
+static REPLAY_CHUNK_T *_replay_get_chunk( REPLAY_WRITER_T *p_writer, size_t record_size ){
+  unsigned int ready      = atomic_load_explicit( &p_writer->ready_count, memory_order_relaxed );
+  REPLAY_CHUNK_T *p_chunk = &p_writer->p_chunks[ready % REPLAY_CHUNK_COUNT];
+
+  if( p_chunk->size + record_size <= REPLAY_CHUNK_SIZE )
+    return p_chunk;
+
+  _replay_hand_over_chunk( p_writer );
+  ready++;
+
+  /* The game never waits for the disk: if the flush thread is that far behind, the rest of the game is lost */
+  if( ( ready - atomic_load_explicit( &p_writer->flushed_count, memory_order_acquire ) ) >= REPLAY_CHUNK_COUNT ){
+    LOG_WRN( "Replay flush is too slow, recording stopped\n" );
+    p_writer->is_overflowed = true;
+    return NULL;
+  }
+
+  p_chunk       = &p_writer->p_chunks[ready % REPLAY_CHUNK_COUNT];
+  p_chunk->size = 0;
+
+  return p_chunk;
+}
+
+
+static void _replay_hand_over_chunk( REPLAY_WRITER_T *p_writer ){
+  unsigned int ready = atomic_load_explicit( &p_writer->ready_count, memory_order_relaxed );
+
+  p_writer->chunk_offset += p_writer->p_chunks[ready % REPLAY_CHUNK_COUNT].size;
+
+  atomic_fetch_add_explicit( &p_writer->ready_count, 1, memory_order_release );
+  platform_event_set( &p_writer->flush_event );
+}
+
+
+static void _replay_put_event( REPLAY_WRITER_T *p_writer, REPLAY_CHUNK_T *p_chunk, uint64_t tick, uint8_t type ){
+  _replay_put_varint( p_chunk, ( ( tick - p_writer->last_tick ) << REPLAY_EVENT_BITS ) | type );
+  p_writer->last_tick = tick;
+}
+
+
+static void _replay_put_varint( REPLAY_CHUNK_T *p_chunk, uint64_t value ){
+  while( value >= 0x80 ){
+    p_chunk->data[p_chunk->size++] = (uint8_t) ( value | 0x80 );
+    value >>= 7;
+  }
+
+  p_chunk->data[p_chunk->size++] = (uint8_t) value;
+}
+
+
+static void _replay_put_fixed( REPLAY_CHUNK_T *p_chunk, uint64_t value, uint8_t size ){
+  for( uint8_t i=0; i<size; i++ ){
+    p_chunk->data[p_chunk->size++] = (uint8_t) ( value >> ( 8 * i ) );
+  }
+}
+
+
+static void _replay_restart( REPLAY_READER_T *p_reader, tetris_game_t *p_game ){
+  board_init( p_game, p_reader->header.row_size, p_reader->header.col_size );
+  game_clock_init( p_game );
+  game_set_seed( p_game, p_reader->header.seed );
+  score_set_difficulty( p_game, p_reader->header.difficulty );
+
+  p_reader->offset = REPLAY_HEADER_SIZE;
+  p_reader->tick   = 0;
+}
+
+
+static void _replay_get_index_entry( const REPLAY_READER_T *p_reader, uint32_t idx, REPLAY_INDEX_ENTRY_T *p_entry ){
+  const uint8_t *p_data = &p_reader->p_index[(size_t) idx * REPLAY_INDEX_ENTRY_SIZE];
+
+  p_entry->tick         = _replay_decode_fixed( p_data, 8 );
+  p_entry->state_offset = _replay_decode_fixed( p_data + 8, 8 );
+  p_entry->state_size   = (uint32_t) _replay_decode_fixed( p_data + 16, 4 );
+}
+
+
+static uint64_t _replay_decode_fixed( const uint8_t *p_data, uint8_t size ){
+  uint64_t value = 0;
+
+  for( uint8_t i=0; i<size; i++ ){
+    value |= (uint64_t) p_data[i] << ( 8 * i );
+  }
+
+  return value;
+}
+
+
+static int8_t _replay_get_varint( REPLAY_READER_T *p_reader, uint64_t *p_value ){
+  uint64_t value = 0;
+  uint8_t byte   = 0;
+
+  for( uint8_t i=0; i<REPLAY_VARINT_MAX_SIZE; i++ ){
+    if( p_reader->offset >= p_reader->size )
+      return TETRIS_RET_ERR;
+
+    byte   = p_reader->p_data[p_reader->offset++];
+    value |= (uint64_t) ( byte & 0x7F ) << ( 7 * i );
+
+    if( ( byte & 0x80 ) == 0 ){
+      *p_value = value;
+      return TETRIS_RET_OK;
+    }
+  }
+
+  return TETRIS_RET_ERR;
+}
+
+
+static int8_t _replay_get_fixed( REPLAY_READER_T *p_reader, uint8_t size, uint64_t *p_value ){
+  if( p_reader->offset + size > p_reader->size )
+    return TETRIS_RET_ERR;
+
+  *p_value          = _replay_decode_fixed( &p_reader->p_data[p_reader->offset], size );
+  p_reader->offset += size;
+
+  return TETRIS_RET_OK;
+}
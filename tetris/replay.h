@@ -0,0 +1,345 @@
+/*
+ *  replay.h
+ *
+ *  Created on: 17-Oct-2026
+ *      Author: lucas-noce
+ */
+
+#ifndef _REPLAY_H_
+#define _REPLAY_H_
+
+
+/* ==========================================================================================================
+ * Includes
+ */
+
+#include <stdio.h>
+#include <stdint.h>
+#include <stddef.h>
+#include <stdbool.h>
+#include <stdatomic.h>
+
+#include "main.h"
+#include "game_config.h"
+#include "command.h"
+#include "platform.h"
+
+
+/* ==========================================================================================================
+ * Definitions
+ */
+
+/*
+  Replay file layout (all multi-byte fixed fields little endian):
+
+    header:   "TRPL", version (1 byte), seed (8 bytes), row_size (2 bytes), col_size (2 bytes), difficulty (1 byte),
+              tick_ms (1 byte)
+    events:   varint( ( ticks since the previous event << REPLAY_EVENT_BITS ) | event type ), so a command is a
+              single byte up to 15 ticks after the previous event and two bytes up to 2047 ticks
+    keyframe: every REPLAY_KEYFRAME_INTERVAL pieces, the REPLAY_EVENT_KEYFRAME event, then varint( size ) and the
+              game state (game_save_state, in the byte order of the recording machine)
+    end:      the REPLAY_EVENT_END event, then varint( score ), varint( piece_count ), board_hash (8 bytes) and,
+              from version 3 on, board_get_zobrist_hash (8 bytes)
+    index:    one entry per keyframe: tick (8 bytes), offset of the state in the file (8 bytes), size (4 bytes)
+    trailer:  offset of the index (8 bytes), number of entries (4 bytes), "TRPX"
+
+  A varint holds 7 bits per byte, least significant first, with the top bit set on every byte but the last. A
+  replay cut short (e.g. the game crashed) has no end record, index or trailer, its keyframes are still read in
+  sequence.
+*/
+#define REPLAY_MAGIC              "TRPL"
+#define REPLAY_MAGIC_SIZE         4
+#define REPLAY_VERSION            3     // version 1 had no keyframes nor index, version 2 no Zobrist hash, both are still read
+#define REPLAY_HEADER_SIZE        ( REPLAY_MAGIC_SIZE + 1 + 8 + 2 + 2 + 1 + 1 )
+
+#define REPLAY_INDEX_MAGIC        "TRPX"
+#define REPLAY_INDEX_ENTRY_SIZE   ( 8 + 8 + 4 )
+#define REPLAY_TRAILER_SIZE       ( 8 + 4 + REPLAY_MAGIC_SIZE )
+
+#define REPLAY_KEYFRAME_INTERVAL  32    // pieces between keyframes, a seek simulates at most this many pieces
+
+#define REPLAY_EVENT_BITS         3
+#define REPLAY_EVENT_MASK         ( ( 1u << REPLAY_EVENT_BITS ) - 1 )
+
+#define REPLAY_CHUNK_SIZE         ( 64 * 1024 )
+#define REPLAY_CHUNK_COUNT        4     // must be a power of 2
+#define REPLAY_MAX_RECORD_SIZE    40    // largest record but keyframes, a chunk is handed over before it can overflow
+
+
+/* ==========================================================================================================
+ * Typedefs
+ */
+
+/*!
+  @brief        Indicates the records of a replay. The player commands keep their GAME_COMMANDS_E value.
+*/
+typedef enum{
+  REPLAY_EVENT_END = GAME_COMMAND_LAST_IDX,
+  REPLAY_EVENT_KEYFRAME,
+  REPLAY_EVENT_LAST_IDX,
+} REPLAY_EVENTS_E;
+
+_Static_assert( REPLAY_EVENT_LAST_IDX <= ( 1u << REPLAY_EVENT_BITS ), "replay events must fit in REPLAY_EVENT_BITS" );
+
+/*!
+  @brief        Settings a replay needs to play a game again.
+
+  @param        seed: seed of the sequence of pieces (see game_set_seed).
+  @param        row_size: number of board rows, bottom border included.
+  @param        col_size: number of board columns, borders included.
+  @param        difficulty: difficulty of the game (from GAME_DIFFICULTIES_E).
+  @param        tick_ms: length of a tick when the game was recorded (GAME_CONFIG_TICK_MS).
+*/
+typedef struct REPLAY_HEADER_TAG{
+  uint64_t seed;
+  uint16_t row_size;
+  uint16_t col_size;
+  uint8_t  difficulty;
+  uint8_t  tick_ms;
+} REPLAY_HEADER_T;
+
+/*!
+  @brief        A record of a replay.
+
+  @param        type: a GAME_COMMANDS_E or REPLAY_EVENTS_E value.
+  @param        tick: game tick at which the command was applied (before the tick ran), of the keyframe, or the last
+                tick of the game.
+  @param        score: final score (REPLAY_EVENT_END only).
+  @param        piece_count: number of pieces spawned in the game (REPLAY_EVENT_END only).
+  @param        board_hash: board_hash of the final board (REPLAY_EVENT_END only).
+  @param        zobrist_hash: board_get_zobrist_hash of the final board (REPLAY_EVENT_END only, 0 before version 3).
+  @param        p_state: the game state at the start of the tick, before its commands (REPLAY_EVENT_KEYFRAME only).
+  @param        state_size: number of bytes in `p_state` (REPLAY_EVENT_KEYFRAME only).
+*/
+typedef struct REPLAY_EVENT_TAG{
+  uint8_t       type;
+  uint64_t      tick;
+  uint32_t      score;
+  uint32_t      piece_count;
+  uint64_t      board_hash;
+  uint64_t      zobrist_hash;
+  const uint8_t *p_state;
+  uint32_t      state_size;
+} REPLAY_EVENT_T;
+
+/*!
+  @brief        Locates a keyframe in the replay file.
+
+  @param        tick: tick of the keyframe.
+  @param        state_offset: offset of the game state in the file.
+  @param        state_size: number of bytes of the game state.
+*/
+typedef struct REPLAY_INDEX_ENTRY_TAG{
+  uint64_t tick;
+  uint64_t state_offset;
+  uint32_t state_size;
+} REPLAY_INDEX_ENTRY_T;
+
+/*!
+  @brief        A buffer of encoded records, written to the file in one go.
+
+  @param        data: the records.
+  @param        size: number of bytes used in `data`.
+*/
+typedef struct REPLAY_CHUNK_TAG{
+  uint8_t  data[REPLAY_CHUNK_SIZE];
+  uint32_t size;
+} REPLAY_CHUNK_T;
+
+/*!
+  @brief        Records a game to a file. The game loop only encodes records in memory, full chunks are written by a
+                background thread so disk I/O never blocks the game.
+
+  @param        p_file: the replay file (NULL when not recording).
+  @param        p_chunks: ring of REPLAY_CHUNK_COUNT chunks.
+  @param        last_tick: tick of the last record, the next one is encoded relative to it (game loop only).
+  @param        chunk_offset: offset in the file of the chunk being filled (game loop only).
+  @param        next_keyframe_piece: piece count at which the next keyframe is recorded (game loop only).
+  @param        p_index: the keyframes recorded so far, written after the end record (game loop only).
+  @param        index_count: number of entries in `p_index`.
+  @param        index_capacity: number of entries allocated in `p_index`.
+  @param        is_overflowed: set when the flush fell REPLAY_CHUNK_COUNT chunks behind, the records after that are
+                dropped (game loop only).
+  @param        ready_count: number of chunks handed to the flush thread, written only by the game loop.
+  @param        flushed_count: number of chunks written to the file, written only by the flush thread.
+  @param        is_closing: set when the last chunk was handed over, the flush thread ends once it is written.
+  @param        flush_event: wakes the flush thread up when a chunk is handed over.
+  @param        flush_thread: the flush thread.
+*/
+typedef struct REPLAY_WRITER_TAG{
+  FILE                 *p_file;
+  REPLAY_CHUNK_T       *p_chunks;
+  uint64_t             last_tick;
+  uint64_t             chunk_offset;
+  uint32_t             next_keyframe_piece;
+  REPLAY_INDEX_ENTRY_T *p_index;
+  uint32_t             index_count;
+  uint32_t             index_capacity;
+  bool                 is_overflowed;
+  _Alignas( GAME_CONFIG_CACHE_LINE_SIZE ) atomic_uint ready_count;
+  _Alignas( GAME_CONFIG_CACHE_LINE_SIZE ) atomic_uint flushed_count;
+  atomic_bool          is_closing;
+  PLATFORM_EVENT_T     flush_event;
+  PLATFORM_THREAD_T    flush_thread;
+} REPLAY_WRITER_T;
+
+/*!
+  @brief        Reads the records of a replay held in memory.
+
+  @param        p_data: the whole replay.
+  @param        size: number of bytes of records in `p_data` (the index and trailer excluded).
+  @param        offset: position of the next record in `p_data`.
+  @param        tick: tick of the last record read.
+  @param        header: the header of the replay.
+  @param        version: format version of the replay (up to REPLAY_VERSION).
+  @param        p_index: the index of the keyframes in `p_data` (NULL if the replay has none).
+  @param        index_count: number of entries in `p_index`.
+*/
+typedef struct REPLAY_READER_TAG{
+  const uint8_t   *p_data;
+  size_t          size;
+  size_t          offset;
+  uint64_t        tick;
+  REPLAY_HEADER_T header;
+  uint8_t         version;
+  const uint8_t   *p_index;
+  uint32_t        index_count;
+} REPLAY_READER_T;
+
+/*!
+  @brief        Outcome of playing a replay again.
+
+  @param        game_status: TETRIS_GAME_OVER, TETRIS_GAME_NOT_OVER (player quit) or TETRIS_GAME_WON.
+  @param        tick: last tick of the game played again.
+  @param        command_count: number of commands applied.
+  @param        keyframe_count: number of keyframes checked against the game played again.
+  @param        expected: the end record of the replay.
+  @param        score: final score of the game played again.
+  @param        piece_count: number of pieces spawned in the game played again.
+  @param        board_hash: board_hash of the final board of the game played again.
+  @param        zobrist_hash: board_get_zobrist_hash of the final board of the game played again.
+  @param        is_hash_consistent: whether the Zobrist hash kept by the game played again matches its cells.
+*/
+typedef struct REPLAY_RESULT_TAG{
+  uint8_t        game_status;
+  uint64_t       tick;
+  uint64_t       command_count;
+  uint32_t       keyframe_count;
+  REPLAY_EVENT_T expected;
+  uint32_t       score;
+  uint32_t       piece_count;
+  uint64_t       board_hash;
+  uint64_t       zobrist_hash;
+  bool           is_hash_consistent;
+} REPLAY_RESULT_T;
+
+
+/* ==========================================================================================================
+ * Global Functions
+ */
+
+/*!
+  @brief        Creates a replay file, writes its header and starts the flush thread.
+
+  @param[out]   p_writer: pointer to the writer.
+  @param[in]    p_path: path of the replay file.
+  @param[in]    p_header: settings of the recorded game.
+
+  @returns      One of the possible TETRIS_RET_x macro values (defined in main.h).
+*/
+int8_t replay_writer_open( REPLAY_WRITER_T *p_writer, const char *p_path, const REPLAY_HEADER_T *p_header );
+
+/*!
+  @brief        Records a command applied to the game. Does nothing when the writer is not open.
+
+  @param[in]    p_writer: pointer to the writer.
+  @param[in]    tick: game tick at which the command is applied (clock.tick before game_tick runs).
+  @param[in]    command_type: one of the GAME_COMMANDS_E values.
+
+  @returns      void
+*/
+void replay_record_command( REPLAY_WRITER_T *p_writer, uint64_t tick, uint8_t command_type );
+
+/*!
+  @brief        Records a keyframe when REPLAY_KEYFRAME_INTERVAL pieces were spawned since the previous one. Does
+                nothing when the writer is not open.
+
+  @param[in]    p_writer: pointer to the writer.
+  @param[in]    p_game: the recorded game, right after a game_tick that did not end the game.
+
+  @returns      void
+*/
+void replay_record_state( REPLAY_WRITER_T *p_writer, tetris_game_t *p_game );
+
+/*!
+  @brief        Records the end of the game and the keyframe index, writes the remaining records and closes the file.
+                Does nothing when the writer is not open.
+
+  @param[in]    p_writer: pointer to the writer.
+  @param[in]    p_game: the recorded game, in its final state.
+
+  @returns      void
+
+  @note         Must be called from the thread that recorded the commands, or after that thread was joined.
+*/
+void replay_writer_close( REPLAY_WRITER_T *p_writer, tetris_game_t *p_game );
+
+/*!
+  @brief        Checks the header of a replay and prepares to read its records.
+
+  @param[out]   p_reader: pointer to the reader.
+  @param[in]    p_data: the whole replay.
+  @param[in]    size: number of bytes in `p_data`.
+
+  @returns      One of the possible TETRIS_RET_x macro values (defined in main.h).
+*/
+int8_t replay_reader_open( REPLAY_READER_T *p_reader, const uint8_t *p_data, size_t size );
+
+/*!
+  @brief        Reads the next record of a replay.
+
+  @param[in]    p_reader: pointer to the reader.
+  @param[out]   p_event: the record.
+
+  @returns      TETRIS_RET_OK if a record was read, TETRIS_RET_ERR at the end of the replay or if it is corrupted.
+*/
+int8_t replay_reader_next( REPLAY_READER_T *p_reader, REPLAY_EVENT_T *p_event );
+
+/*!
+  @brief        Creates a game with the settings of a replay, at its tick 0.
+
+  @param[in]    p_reader: pointer to the reader.
+
+  @returns      Pointer to the game (to be released with game_destroy), or NULL on error.
+*/
+tetris_game_t *replay_create_game( const REPLAY_READER_T *p_reader );
+
+/*!
+  @brief        Brings a game to a tick of a replay: the state is restored from the last keyframe at or before the
+                tick (found in the index), then the game is simulated forward. Only the keyframe and the records
+                after it are read, so a mapped replay file is never read in whole.
+
+  @param[in]    p_reader: pointer to the reader.
+  @param[in]    p_game: game created with replay_create_game.
+  @param[in]    tick: the tick, the game stops at the start of it with its commands applied (or at the end of the
+                game if it ended before).
+  @param[out]   p_game_status: TETRIS_GAME_OVER, TETRIS_GAME_NOT_OVER or TETRIS_GAME_WON.
+
+  @returns      One of the possible TETRIS_RET_x macro values (defined in main.h).
+*/
+int8_t replay_seek( REPLAY_READER_T *p_reader, tetris_game_t *p_game, uint64_t tick, uint8_t *p_game_status );
+
+/*!
+  @brief        Plays a replay again on the rule engine, with no rendering and no waiting, and compares the final
+                state with the end record.
+
+  @param[in]    p_data: the whole replay.
+  @param[in]    size: number of bytes in `p_data`.
+  @param[out]   p_result: the game played again and the expected end record.
+
+  @returns      TETRIS_RET_OK if every keyframe and the final score, piece count and board hash match the game played
+                again, TETRIS_RET_ERR otherwise (or if the replay is corrupted or has no end record).
+*/
+int8_t replay_verify( const uint8_t *p_data, size_t size, REPLAY_RESULT_T *p_result );
+
+#endif /* _REPLAY_H_ */
@@ -15,16 +15,13 @@
 
 #include "main.h"
 #include "score.h"
+#include "game.h"
 
 
 /* ==========================================================================================================
  * Static variables
  */
 
-static uint32_t game_score     = 0;
-static uint8_t game_speed      = 0;
-static uint8_t game_difficulty = 0;
-
 static const uint32_t score_table[GAME_SPEED_LAST_IDX][GAME_DIFFICULTY_LAST_IDX] = {
   { 10,  15,  20,  30 },
   { 20,  25,  35,  40 },
@@ -48,58 +45,73 @@ static const uint8_t score_table_fix_piece[GAME_SPEED_LAST_IDX] = {
  * Global Functions Declaration
  */
 
-void score_init( void ){
-  game_score = 0;
-  game_speed = GAME_SPEED_SLOWEST;
-  game_difficulty = GAME_DIFFICULTY_EASY;
+void score_init( tetris_game_t *p_game ){
+  p_game->score.game_score      = 0;
+  p_game->score.game_speed      = GAME_SPEED_SLOWEST;
+  p_game->score.game_difficulty = GAME_DIFFICULTY_EASY;
+  p_game->score.complete_row_count = 0;
 }
 
 
-void score_reset_to_zero( void ){
-  game_score = 0;
-  game_speed = GAME_SPEED_SLOWEST;
+void score_reset_to_zero( tetris_game_t *p_game ){
+  p_game->score.game_score = 0;
+  p_game->score.game_speed = GAME_SPEED_SLOWEST;
+  p_game->score.complete_row_count = 0;
 }
 
 
-void score_increment_speed( void ){
-  game_speed += ( game_speed < ( GAME_SPEED_LAST_IDX - 1) ? 1 : 0 );
+void score_increment_speed( tetris_game_t *p_game ){
+  p_game->score.game_speed += ( p_game->score.game_speed < ( GAME_SPEED_LAST_IDX - 1) ? 1 : 0 );
 }
 
 
-int8_t score_set_difficulty( uint8_t difficulty ){
-  if( game_difficulty >= GAME_DIFFICULTY_LAST_IDX ){
+int8_t score_set_difficulty( tetris_game_t *p_game, uint8_t difficulty ){
+  if( difficulty >= GAME_DIFFICULTY_LAST_IDX ){
     return TETRIS_RET_ERR;
   }
 
-  game_difficulty = difficulty;
+  p_game->score.game_difficulty = difficulty;
   return TETRIS_RET_OK;
 }
 
-uint8_t score_get_difficulty( void ){
-  return game_difficulty;
+uint8_t score_get_difficulty( tetris_game_t *p_game ){
+  return p_game->score.game_difficulty;
+}
+
+uint32_t score_get_game_score( tetris_game_t *p_game ){
+  return p_game->score.game_score;
 }
 
+uint32_t score_get_complete_row_count( tetris_game_t *p_game ){
+  return p_game->score.complete_row_count;
+}
 
-int8_t score_increment_complete_row( void ){
-  if( game_speed >= GAME_SPEED_LAST_IDX || game_difficulty >= GAME_DIFFICULTY_LAST_IDX ){
+
+int8_t score_increment_complete_row( tetris_game_t *p_game ){
+  SCORE_STRUCT_T *p_score = &p_game->score;
+
+  if( p_score->game_speed >= GAME_SPEED_LAST_IDX || p_score->game_difficulty >= GAME_DIFFICULTY_LAST_IDX ){
     return TETRIS_RET_ERR;
   }
 
-  game_score += score_table[game_speed][game_difficulty];
+  p_score->game_score += score_table[p_score->game_speed][p_score->game_difficulty];
+  p_score->complete_row_count++;
   return TETRIS_RET_OK;
 }
 
 
-int8_t score_increment_fix_piece( void ){
-  if( game_speed >= GAME_SPEED_LAST_IDX ){
+int8_t score_increment_fix_piece( tetris_game_t *p_game ){
+  SCORE_STRUCT_T *p_score = &p_game->score;
+
+  if( p_score->game_speed >= GAME_SPEED_LAST_IDX ){
     return TETRIS_RET_ERR;
   }
 
-  game_score += score_table_fix_piece[game_speed];
+  p_score->game_score += score_table_fix_piece[p_score->game_speed];
   return TETRIS_RET_OK;
 }
 
 
-void score_print( void ){
-  LOG_GAME( "\nScore: %u\n\n", game_score );
+void score_print( tetris_game_t *p_game ){
+  LOG_GAME( "\nScore: %u\n\n", p_game->score.game_score );
 }
@@ -15,6 +15,8 @@
 
 #include <stdint.h>
 
+#include "main.h"
+
 
 /* ==========================================================================================================
  * Typedefs
@@ -44,20 +46,36 @@ typedef enum{
   GAME_DIFFICULTY_LAST_IDX,
 } GAME_DIFFICULTIES_E;
 
+/*!
+  @brief        Holds the score state of a game.
+
+  @param        game_score: points accumulated so far.
+  @param        game_speed: current speed level (from GAME_SPEEDS_E).
+  @param        game_difficulty: difficulty chosen for the game (from GAME_DIFFICULTIES_E).
+  @param        complete_row_count: number of rows cleared so far.
+*/
+typedef struct SCORE_STRUCT_TAG{
+  uint32_t game_score;
+  uint8_t  game_speed;
+  uint8_t  game_difficulty;
+  uint32_t complete_row_count;
+} SCORE_STRUCT_T;
 
 
 /* ==========================================================================================================
  * Global Functions
  */
 
-void score_init( void );
-void score_reset_to_zero( void );
-void score_increment_speed( void );
-int8_t score_set_difficulty( uint8_t game_difficulty );
-uint8_t score_get_difficulty( void );
-int8_t score_increment_complete_row( void );
-int8_t score_increment_fix_piece( void );
-void score_print( void );
+void score_init( tetris_game_t *p_game );
+void score_reset_to_zero( tetris_game_t *p_game );
+void score_increment_speed( tetris_game_t *p_game );
+int8_t score_set_difficulty( tetris_game_t *p_game, uint8_t game_difficulty );
+uint8_t score_get_difficulty( tetris_game_t *p_game );
+uint32_t score_get_game_score( tetris_game_t *p_game );
+uint32_t score_get_complete_row_count( tetris_game_t *p_game );
+int8_t score_increment_complete_row( tetris_game_t *p_game );
+int8_t score_increment_fix_piece( tetris_game_t *p_game );
+void score_print( tetris_game_t *p_game );
 
 
 #endif /* _SCORE_H_ */
\ No newline at end of file
@@ -0,0 +1,578 @@
+/*
+ *  tetris_placement_check.c
+ *
+ *  Created on: 17-Oct-2026
+ *      Author: lucas-noce
+ */
+
+/* ==========================================================================================================
+ * Includes
+ */
+
+#include <stdlib.h>
+#include <stdio.h>
+#include <stdint.h>
+#include <stdbool.h>
+#include <string.h>
+
+#include "main.h"
+#include "pieces.h"
+#include "board.h"
+#include "game.h"
+#include "command.h"
+#include "placement.h"
+
+
+/* ==========================================================================================================
+ * Definitions
+ */
+
+#define CHECK_DEFAULT_BOARD_COUNT  16
+#define CHECK_DEFAULT_MAX_STEPS    200
+#define CHECK_DEFAULT_MAX_COLS     64      // the wider boards only make the brute force slower
+#define CHECK_DEFAULT_SEED         1
+
+#define CHECK_MAX_REPORTS          10      // mismatches printed in full, the others are only counted
+
+/* A piece may stand up to its matrix order above or to the left of the board */
+#define CHECK_MARGIN               PIECE_LARGEST_MATRIX_ORDER
+
+
+/* ==========================================================================================================
+ * Static Typedefs
+ */
+
+/*!
+  @brief        Settings of the run.
+
+  @param        board_count: number of boards checked, each of its own size.
+  @param        max_steps: gravity steps played on each board, every new piece is checked.
+  @param        max_col_size: widest board checked, borders included.
+  @param        seed: seed of the run, board N is seeded with seed + N (size, pieces and moves).
+*/
+typedef struct CHECK_CONFIG_TAG{
+  uint32_t board_count;
+  uint32_t max_steps;
+  uint16_t max_col_size;
+  uint64_t seed;
+} CHECK_CONFIG_T;
+
+/*!
+  @brief        The cells filled by a piece at a final position, so two positions of the same cells (e.g. the two
+                orientations of an S) compare equal.
+
+  @param        cells: index of each cell in the board with its margins, from the lowest.
+  @param        count: number of entries in `cells`, the others are 0.
+*/
+typedef struct CHECK_CELLS_TAG{
+  uint32_t cells[PLACEMENT_MAX_PIECE_CELLS];
+  uint32_t count;
+} CHECK_CELLS_T;
+
+/*!
+  @brief        The planes of the brute force on one board size.
+
+  @param        row_size, col_size: size of the board.
+  @param        state_count: number of states (rotation, row, column) a piece may take, margins included.
+  @param        p_seen: whether each state was reached.
+  @param        p_queue: states to visit.
+  @param        p_expected: the final positions found by the brute force.
+  @param        p_found: the final positions found by the placement search.
+  @param        p_path: commands of a path.
+  @param        path_size: number of commands `p_path` holds.
+  @param        search_count, placement_count, path_count, mismatch_count: totals of the run.
+*/
+typedef struct CHECK_STATE_TAG{
+  uint16_t      row_size;
+  uint16_t      col_size;
+  uint32_t      state_count;
+  uint8_t       *p_seen;
+  uint32_t      *p_queue;
+  CHECK_CELLS_T *p_expected;
+  CHECK_CELLS_T *p_found;
+  uint8_t       *p_path;
+  uint16_t      path_size;
+  uint64_t      search_count;
+  uint64_t      placement_count;
+  uint64_t      path_count;
+  uint64_t      mismatch_count;
+} CHECK_STATE_T;
+
+
+/* ==========================================================================================================
+ * Static variables
+ */
+
+static CHECK_CONFIG_T check_config;
+static CHECK_STATE_T check_state;
+
+
+/* ==========================================================================================================
+ * Static Function Prototypes
+ */
+
+/*!
+  @brief        Plays random moves on a board of the given size and checks the placement search on every new piece.
+
+  @param[in]    p_search: the placement search, initialized with the size of the board.
+  @param[in]    row_size, col_size: size of the board.
+  @param[in]    seed: seed of the pieces and of the moves.
+
+  @returns      One of the possible TETRIS_RET_x macro values (defined in main.h), TETRIS_RET_ERR if the board could
+                not be allocated. Mismatches are counted in check_state.
+*/
+static int8_t _check_board( PLACEMENT_SEARCH_T *p_search, uint16_t row_size, uint16_t col_size, uint64_t seed );
+
+/*!
+  @brief        Checks the placements of a piece, and a path to each of them, against a breadth-first search of the
+                positions the piece reaches through game_apply_command.
+
+  @param[in]    p_search: the placement search.
+  @param[in]    p_game: the game, with the piece to check as its current piece.
+  @param[in]    p_probe: a copy of the game, moved through the states of the piece.
+
+  @returns      true if the search matches the brute force.
+*/
+static bool _check_search( PLACEMENT_SEARCH_T *p_search, tetris_game_t *p_game, tetris_game_t *p_probe );
+
+/*!
+  @brief        Finds every final position of the current piece of a game by trying every command from every state.
+
+  @param[in]    p_probe: the game, its current piece is moved and left at its start.
+
+  @returns      Number of distinct final positions written to p_expected, or UINT32_MAX if the piece left the board.
+*/
+static uint32_t _check_brute_force( tetris_game_t *p_probe );
+
+/*!
+  @brief        Gets the index of the state of a piece.
+
+  @param[in]    p_piece: the piece.
+  @param[out]   p_index: the index, below state_count.
+
+  @returns      false if the piece is out of the board and its margins.
+*/
+static bool _check_state_index( const PIECE_STRUCT_T *p_piece, uint32_t *p_index );
+
+/*!
+  @brief        Gets the cells filled by a piece.
+
+  @param[in]    p_piece: the piece.
+  @param[out]   p_cells: the cells.
+
+  @returns      void
+*/
+static void _check_get_cells( const PIECE_STRUCT_T *p_piece, CHECK_CELLS_T *p_cells );
+
+/*!
+  @brief        Orders two cell sets for qsort.
+
+  @param[in]    p_a, p_b: pointers to the cell sets.
+
+  @returns      <0, 0 or >0 as memcmp.
+*/
+static int _check_compare_cells( const void *p_a, const void *p_b );
+
+/*!
+  @brief        Allocates the planes of the brute force for a board size.
+
+  @param[in]    row_size, col_size: size of the board.
+
+  @returns      One of the possible TETRIS_RET_x macro values (defined in main.h).
+*/
+static int8_t _check_state_alloc( uint16_t row_size, uint16_t col_size );
+
+/*!
+  @brief        Frees the planes of the brute force.
+
+  @returns      void
+*/
+static void _check_state_free( void );
+
+/*!
+  @brief        Advances a xorshift64* generator.
+
+  @param[in]    p_state: state of the generator (not 0), updated.
+
+  @returns      The next random number.
+*/
+static uint64_t _check_rng_next( uint64_t *p_state );
+
+/*!
+  @brief        Parses an unsigned decimal option value.
+
+  @param[in]    p_value: the text of the value.
+  @param[in]    max_value: largest value accepted.
+  @param[in]    default_value: value returned if the text is not a number up to max_value.
+
+  @returns      The value.
+*/
+static uint64_t _check_parse_number( const char *p_value, uint64_t max_value, uint64_t default_value );
+
+
+/* ==========================================================================================================
+ * Global Functions Declaration
+ */
+
+int main( int argc, char *argv[] ){
+  PLACEMENT_SEARCH_T search;
+  uint64_t rng_state = 0;
+  uint16_t row_size  = 0;
+  uint16_t col_size  = 0;
+
+  check_config.board_count  = CHECK_DEFAULT_BOARD_COUNT;
+  check_config.max_steps    = CHECK_DEFAULT_MAX_STEPS;
+  check_config.max_col_size = CHECK_DEFAULT_MAX_COLS;
+  check_config.seed         = CHECK_DEFAULT_SEED;
+
+  /* Options: --boards N (each of a random size) --steps N (gravity steps played on each) --max-cols N (widest
+     board, up to BOARD_MAX_COL_SIZE) --seed N */
+  for( int i=1; i<argc; i++ ){
+    if( strcmp( argv[i], "--boards" ) == 0 && i < (argc - 1) ){
+      check_config.board_count = (uint32_t) _check_parse_number( argv[++i], UINT32_MAX, check_config.board_count );
+    }
+    else if( strcmp( argv[i], "--steps" ) == 0 && i < (argc - 1) ){
+      check_config.max_steps = (uint32_t) _check_parse_number( argv[++i], UINT32_MAX, check_config.max_steps );
+    }
+    else if( strcmp( argv[i], "--max-cols" ) == 0 && i < (argc - 1) ){
+      check_config.max_col_size = (uint16_t) _check_parse_number( argv[++i], BOARD_MAX_COL_SIZE, check_config.max_col_size );
+    }
+    else if( strcmp( argv[i], "--seed" ) == 0 && i < (argc - 1) ){
+      check_config.seed = _check_parse_number( argv[++i], UINT64_MAX, check_config.seed );
+    }
+    else{
+      printf( "Unknown option: %s\n", argv[i] );
+      return 1;
+    }
+  }
+
+  if( check_config.max_col_size < BOARD_MIN_COL_SIZE )
+    check_config.max_col_size = BOARD_MIN_COL_SIZE;
+
+  for( uint32_t b=0; b<check_config.board_count; b++ ){
+    /* Every height the search supports, and widths up to max_col_size */
+    rng_state = ( ( check_config.seed + b ) * 0x9E3779B97F4A7C15ull ) | 1;
+    row_size  = (uint16_t) ( BOARD_MIN_ROW_SIZE + _check_rng_next( &rng_state ) %
+                             ( PLACEMENT_MAX_ROW_SIZE - BOARD_MIN_ROW_SIZE + 1 ) );
+    col_size  = (uint16_t) ( BOARD_MIN_COL_SIZE + _check_rng_next( &rng_state ) %
+                             ( check_config.max_col_size - BOARD_MIN_COL_SIZE + 1 ) );
+
+    if( placement_search_init( &search, row_size, col_size ) != TETRIS_RET_OK ){
+      printf( "Failed to initialize the placement search for a %u x %u board\n", row_size, col_size );
+      return 1;
+    }
+
+    if( _check_state_alloc( row_size, col_size ) != TETRIS_RET_OK ||
+        _check_board( &search, row_size, col_size, check_config.seed + b ) != TETRIS_RET_OK ){
+      printf( "Failed to allocate the check of a %u x %u board\n", row_size, col_size );
+      _check_state_free();
+      placement_search_deinit( &search );
+      return 1;
+    }
+
+    _check_state_free();
+    placement_search_deinit( &search );
+  }
+
+  printf( "%u boards, %llu searches, %llu placements, %llu paths: %llu mismatches\n", check_config.board_count,
+          (unsigned long long) check_state.search_count, (unsigned long long) check_state.placement_count,
+          (unsigned long long) check_state.path_count, (unsigned long long) check_state.mismatch_count );
+
+  return ( check_state.mismatch_count == 0 ) ? 0 : 1;
+}
+
+
+/* ==========================================================================================================
+ * Static Functions Declaration
+ */
+
+static int8_t _check_board( PLACEMENT_SEARCH_T *p_search, uint16_t row_size, uint16_t col_size, uint64_t seed ){
+  tetris_game_t *p_game  = game_create( row_size, col_size );
+  tetris_game_t *p_probe = game_create( row_size, col_size );
+  uint8_t *p_state       = NULL;
+  size_t state_size      = 0;
+  uint64_t rng_state     = ( seed ^ 0xD1B54A32D192ED03ull ) | 1;
+
+  if( p_game == NULL || p_probe == NULL ){
+    game_destroy( p_probe );
+    game_destroy( p_game );
+    return TETRIS_RET_ERR;
+  }
+
+  game_set_seed( p_game, seed );
+  state_size = game_state_size( p_game );
+  p_state    = malloc( state_size );
+
+  if( p_state == NULL ){
+    game_destroy( p_probe );
+    game_destroy( p_game );
+    return TETRIS_RET_ERR;
+  }
+
+  /* Random moves between the gravity steps leave uneven stacks, with holes and overhangs to reach under */
+  for( uint32_t step=0; step<check_config.max_steps; step++ ){
+    game_apply_command( p_game, (uint8_t) ( _check_rng_next( &rng_state ) % GAME_COMMAND_LAST_IDX ) );
+
+    if( game_step( p_game ) != TETRIS_GAME_NOT_OVER )
+      break;
+
+    if( !p_game->board.has_current_piece )
+      continue;
+
+    game_save_state( p_game, p_state );
+    game_load_state( p_probe, p_state, state_size );
+
+    if( !_check_search( p_search, p_game, p_probe ) ){
+      check_state.mismatch_count++;
+
+      if( check_state.mismatch_count <= CHECK_MAX_REPORTS ){
+        printf( "Mismatch on a %u x %u board, seed %llu, step %u, piece %u\n", row_size, col_size,
+                (unsigned long long) seed, step, p_game->board.current_piece.type );
+        board_print( p_game );
+      }
+    }
+  }
+
+  free( p_state );
+  game_destroy( p_probe );
+  game_destroy( p_game );
+
+  return TETRIS_RET_OK;
+}
+
+
+static bool _check_search( PLACEMENT_SEARCH_T *p_search, tetris_game_t *p_game, tetris_game_t *p_probe ){
+  const PIECE_STRUCT_T start = p_game->board.current_piece;
+  PIECE_STRUCT_T *p_piece    = &p_probe->board.current_piece;
+  uint32_t expected_count    = 0;
+  uint16_t command_count     = 0;
+  bool is_matching           = true;
+  bool is_reported           = ( check_state.mismatch_count < CHECK_MAX_REPORTS );
+
+  check_state.search_count++;
+
+  if( placement_find_all( p_search, p_game, &start ) != TETRIS_RET_OK )
+    return false;
+
+  expected_count = _check_brute_force( p_probe );
+  if( expected_count == UINT32_MAX || expected_count != p_search->placement_count ){
+    if( is_reported )
+      printf( "%u placements found, %u expected\n", p_search->placement_count, expected_count );
+    return false;
+  }
+
+  /* The search keeps one placement per set of cells, so the sorted sets must be the same with no repeat */
+  for( uint32_t i=0; i<p_search->placement_count; i++ ){
+    *p_piece              = start;
+    p_piece->rotation     = p_search->placements[i].rotation;
+    p_piece->position_row = p_search->placements[i].position_row;
+    p_piece->position_col = p_search->placements[i].position_col;
+    _check_get_cells( p_piece, &check_state.p_found[i] );
+  }
+
+  qsort( check_state.p_found, p_search->placement_count, sizeof( CHECK_CELLS_T ), _check_compare_cells );
+
+  for( uint32_t i=0; i<p_search->placement_count; i++ ){
+    if( _check_compare_cells( &check_state.p_found[i], &check_state.p_expected[i] ) != 0 ){
+      if( is_reported )
+        printf( "Placement %u differs from the brute force\n", i );
+      return false;
+    }
+  }
+
+  /* A path must bring the piece from its start to the placement, where it cannot move down */
+  for( uint32_t i=0; i<p_search->placement_count; i++ ){
+    const PLACEMENT_T *p_placement = &p_search->placements[i];
+
+    if( placement_get_path( p_search, p_placement, check_state.p_path, check_state.path_size,
+                            &command_count ) != TETRIS_RET_OK ){
+      if( is_reported )
+        printf( "No path to placement %u\n", i );
+      is_matching = false;
+      continue;
+    }
+
+    *p_piece = start;
+
+    for( uint16_t c=0; c<command_count; c++ ){
+      game_apply_command( p_probe, check_state.p_path[c] );
+    }
+
+    if( p_piece->rotation != p_placement->rotation || p_piece->position_row != p_placement->position_row ||
+        p_piece->position_col != p_placement->position_col ||
+        move_current_piece_through_board( p_probe, BOARD_DIRECTION_DOWN ) == TETRIS_RET_OK ){
+      if( is_reported )
+        printf( "The path to placement %u ends at rotation %u, row %d, col %d\n", i, p_piece->rotation,
+                p_piece->position_row, p_piece->position_col );
+      is_matching = false;
+    }
+
+    check_state.path_count++;
+  }
+
+  check_state.placement_count += p_search->placement_count;
+  *p_piece = start;
+
+  return is_matching;
+}
+
+
+static uint32_t _check_brute_force( tetris_game_t *p_probe ){
+  PIECE_STRUCT_T *p_piece    = &p_probe->board.current_piece;
+  const PIECE_STRUCT_T start = *p_piece;
+  PIECE_STRUCT_T state;
+  uint32_t queue_head = 0;
+  uint32_t queue_tail = 0;
+  uint32_t count      = 0;
+  uint32_t index      = 0;
+
+  memset( check_state.p_seen, 0, check_state.state_count );
+
+  if( !_check_state_index( &start, &index ) )
+    return UINT32_MAX;
+
+  check_state.p_seen[index]           = 1;
+  check_state.p_queue[queue_tail++]   = index;
+
+  /* Each state is rebuilt from its index, over the start piece */
+  while( queue_head < queue_tail ){
+    index          = check_state.p_queue[queue_head++];
+    state          = start;
+    state.rotation = (uint8_t) ( index / ( (uint32_t) ( check_state.row_size + CHECK_MARGIN ) *
+                                           ( check_state.col_size + CHECK_MARGIN ) ) );
+    state.position_row = (int16_t) ( ( index / ( check_state.col_size + CHECK_MARGIN ) ) %
+                                     ( check_state.row_size + CHECK_MARGIN ) ) - CHECK_MARGIN;
+    state.position_col = (int16_t) ( index % ( check_state.col_size + CHECK_MARGIN ) ) - CHECK_MARGIN;
+
+    *p_piece = state;
+    if( move_current_piece_through_board( p_probe, BOARD_DIRECTION_DOWN ) != TETRIS_RET_OK ){
+      *p_piece = state;
+      _check_get_cells( p_piece, &check_state.p_expected[count++] );
+    }
+
+    for( uint8_t c=0; c<GAME_COMMAND_LAST_IDX; c++ ){
+      *p_piece = state;
+      game_apply_command( p_probe, c );
+
+      if( !_check_state_index( p_piece, &index ) ){
+        *p_piece = start;
+        return UINT32_MAX;
+      }
+
+      if( !check_state.p_seen[index] ){
+        check_state.p_seen[index]         = 1;
+        check_state.p_queue[queue_tail++] = index;
+      }
+    }
+  }
+
+  *p_piece = start;
+
+  /* Positions that fill the same cells count once */
+  qsort( check_state.p_expected, count, sizeof( CHECK_CELLS_T ), _check_compare_cells );
+
+  uint32_t unique_count = ( count > 0 ) ? 1 : 0;
+
+  for( uint32_t i=1; i<count; i++ ){
+    if( _check_compare_cells( &check_state.p_expected[i], &check_state.p_expected[unique_count - 1] ) != 0 ){
+      check_state.p_expected[unique_count++] = check_state.p_expected[i];
+    }
+  }
+
+  return unique_count;
+}
+
+
+static bool _check_state_index( const PIECE_STRUCT_T *p_piece, uint32_t *p_index ){
+  int32_t row = p_piece->position_row + CHECK_MARGIN;
+  int32_t col = p_piece->position_col + CHECK_MARGIN;
+
+  if( row < 0 || row >= check_state.row_size + CHECK_MARGIN || col < 0 || col >= check_state.col_size + CHECK_MARGIN )
+    return false;
+
+  *p_index = ( (uint32_t) p_piece->rotation * ( check_state.row_size + CHECK_MARGIN ) + (uint32_t) row ) *
+             ( check_state.col_size + CHECK_MARGIN ) + (uint32_t) col;
+
+  return true;
+}
+
+
+static void _check_get_cells( const PIECE_STRUCT_T *p_piece, CHECK_CELLS_T *p_cells ){
+  const PIECE_ORIENTATION_T *p_orientation = PIECE_ORIENTATION( p_piece );
+
+  memset( p_cells, 0, sizeof( CHECK_CELLS_T ) );
+
+  for( uint8_t r=0; r<PIECE_LARGEST_MATRIX_ORDER; r++ ){
+    for( uint8_t c=0; c<PIECE_LARGEST_MATRIX_ORDER; c++ ){
+      if( ( p_orientation->row_mask[r] >> c ) & 1 ){
+        p_cells->cells[p_cells->count++] =
+          (uint32_t) ( p_piece->position_row + r + CHECK_MARGIN ) * ( check_state.col_size + 2 * CHECK_MARGIN ) +
+          (uint32_t) ( p_piece->position_col + c + CHECK_MARGIN );
+      }
+    }
+  }
+}
+
+
+static int _check_compare_cells( const void *p_a, const void *p_b ){
+  return memcmp( p_a, p_b, sizeof( CHECK_CELLS_T ) );
+}
+
+
+static int8_t _check_state_alloc( uint16_t row_size, uint16_t col_size ){
+  check_state.row_size    = row_size;
+  check_state.col_size    = col_size;
+  check_state.state_count = (uint32_t) PIECE_ROTATION_COUNT * ( row_size + CHECK_MARGIN ) * ( col_size + CHECK_MARGIN );
+
+  /* A path visits each state at most once, so it never holds more commands than there are states */
+  check_state.p_seen     = malloc( check_state.state_count );
+  check_state.p_queue    = malloc( check_state.state_count * sizeof( uint32_t ) );
+  check_state.p_expected = malloc( check_state.state_count * sizeof( CHECK_CELLS_T ) );
+  check_state.p_found    = malloc( check_state.state_count * sizeof( CHECK_CELLS_T ) );
+  check_state.path_size  = (uint16_t) ( ( check_state.state_count < UINT16_MAX ) ? check_state.state_count : UINT16_MAX );
+  check_state.p_path     = malloc( check_state.path_size );
+
+  if( check_state.p_seen == NULL || check_state.p_queue == NULL || check_state.p_expected == NULL ||
+      check_state.p_found == NULL || check_state.p_path == NULL )
+    return TETRIS_RET_ERR;
+
+  return TETRIS_RET_OK;
+}
+
+
+static void _check_state_free( void ){
+  free( check_state.p_path );
+  free( check_state.p_found );
+  free( check_state.p_expected );
+  free( check_state.p_queue );
+  free( check_state.p_seen );
+
+  check_state.p_path     = NULL;
+  check_state.p_found    = NULL;
+  check_state.p_expected = NULL;
+  check_state.p_queue    = NULL;
+  check_state.p_seen     = NULL;
+}
+
+
+static uint64_t _check_rng_next( uint64_t *p_state ){
+  uint64_t x = *p_state;
+
+  x ^= x >> 12;
+  x ^= x << 25;
+  x ^= x >> 27;
+  *p_state = x;
+
+  return x * 0x2545F4914F6CDD1Dull;
+}
+
+
+static uint64_t _check_parse_number( const char *p_value, uint64_t max_value, uint64_t default_value ){
+  char *p_end = NULL;
+  unsigned long long value = strtoull( p_value, &p_end, 10 );
+
+  if( p_end == p_value || *p_end != '\0' || value > max_value )
+    return default_value;
+
+  return (uint64_t) value;
+}
@@ -0,0 +1,161 @@
+/*
+ *  tetris_replay.c
+ *
+ *  Created on: 17-Oct-2026
+ *      Author: lucas-noce
+ */
+
+/* ==========================================================================================================
+ * Includes
+ */
+
+#include <stdlib.h>
+#include <stdio.h>
+#include <stdint.h>
+#include <stdbool.h>
+#include <string.h>
+
+#include "main.h"
+#include "board.h"
+#include "score.h"
+#include "game.h"
+#include "platform.h"
+#include "replay.h"
+
+
+/* ==========================================================================================================
+ * Static Function Prototypes
+ */
+
+/*!
+  @brief        Plays a replay again from the start and checks it against its keyframes and end record.
+
+  @param[in]    p_map: the mapped replay file.
+
+  @returns      0 if the replay verifies, 1 otherwise.
+*/
+static int _replay_run_verify( const PLATFORM_FILE_MAP_T *p_map );
+
+/*!
+  @brief        Brings the game of a replay to a tick and prints it.
+
+  @param[in]    p_reader: reader opened on the replay.
+  @param[in]    tick: the tick.
+
+  @returns      0 on success, 1 otherwise.
+*/
+static int _replay_run_seek( REPLAY_READER_T *p_reader, uint64_t tick );
+
+
+/* ==========================================================================================================
+ * Global Functions Declaration
+ */
+
+int main( int argc, char *argv[] ){
+  PLATFORM_FILE_MAP_T map;
+  REPLAY_READER_T reader;
+  char *p_end   = NULL;
+  uint64_t tick = 0;
+  int ret       = 0;
+
+  /* Options: REPLAY_FILE [--seek TICK] */
+  if( argc != 2 && !( argc == 4 && strcmp( argv[2], "--seek" ) == 0 ) ){
+    printf( "Usage: %s REPLAY_FILE [--seek TICK]\n", argv[0] );
+    return 1;
+  }
+
+  if( argc == 4 ){
+    tick = strtoull( argv[3], &p_end, 10 );
+
+    if( p_end == argv[3] || *p_end != '\0' ){
+      printf( "Invalid tick: %s\n", argv[3] );
+      return 1;
+    }
+  }
+
+  /* The file is mapped, a seek only touches the pages of the index, one keyframe and the records after it */
+  if( platform_file_map( &map, argv[1] ) != TETRIS_RET_OK ){
+    printf( "Failed to read %s\n", argv[1] );
+    return 1;
+  }
+
+  if( replay_reader_open( &reader, map.p_data, map.size ) != TETRIS_RET_OK ){
+    printf( "Invalid replay: %s\n", argv[1] );
+    platform_file_unmap( &map );
+    return 1;
+  }
+
+  printf( "Seed %llu, board %u x %u, difficulty %u, %zu bytes, %u keyframes indexed\n",
+          (unsigned long long) reader.header.seed, reader.header.row_size, reader.header.col_size,
+          reader.header.difficulty, map.size, reader.index_count );
+
+  ret = ( argc == 4 ) ? _replay_run_seek( &reader, tick ) : _replay_run_verify( &map );
+
+  platform_file_unmap( &map );
+
+  return ret;
+}
+
+
+/* ==========================================================================================================
+ * Static Functions Declaration
+ */
+
+static int _replay_run_verify( const PLATFORM_FILE_MAP_T *p_map ){
+  REPLAY_RESULT_T result;
+  int8_t ret = replay_verify( p_map->p_data, p_map->size, &result );
+
+  printf( "Commands: %llu, keyframes: %u, ticks: %llu, pieces: %u, score: %u, status: %s\n",
+          (unsigned long long) result.command_count, result.keyframe_count, (unsigned long long) result.tick,
+          result.piece_count, result.score, ( result.game_status == TETRIS_GAME_OVER ) ? "game over" :
+                                            ( result.game_status == TETRIS_GAME_WON ) ? "won" : "quit" );
+
+  if( ret != TETRIS_RET_OK ){
+    printf( "MISMATCH: expected tick %llu, pieces %u, score %u, board hash %016llx, zobrist %016llx, got board hash "
+            "%016llx, zobrist %016llx%s\n",
+            (unsigned long long) result.expected.tick, result.expected.piece_count, result.expected.score,
+            (unsigned long long) result.expected.board_hash, (unsigned long long) result.expected.zobrist_hash,
+            (unsigned long long) result.board_hash, (unsigned long long) result.zobrist_hash,
+            result.is_hash_consistent ? "" : " (inconsistent with the board)" );
+    return 1;
+  }
+
+  printf( "OK: board hash %016llx, zobrist %016llx\n", (unsigned long long) result.board_hash,
+          (unsigned long long) result.zobrist_hash );
+
+  return 0;
+}
+
+
+static int _replay_run_seek( REPLAY_READER_T *p_reader, uint64_t tick ){
+  tetris_game_t *p_game = replay_create_game( p_reader );
+  uint8_t game_status   = TETRIS_GAME_NOT_OVER;
+  uint64_t start_ns     = 0;
+  uint64_t elapsed_ns   = 0;
+
+  if( p_game == NULL )
+    return 1;
+
+  start_ns = platform_get_time_ns();
+
+  if( replay_seek( p_reader, p_game, tick, &game_status ) != TETRIS_RET_OK ){
+    printf( "Seek to tick %llu failed\n", (unsigned long long) tick );
+    game_destroy( p_game );
+    return 1;
+  }
+
+  elapsed_ns = platform_get_time_ns() - start_ns;
+
+  board_print( p_game );
+  score_print( p_game );
+
+  printf( "Tick %llu, pieces %u, status: %s, board hash %016llx, zobrist %016llx (seek took %.1f us)\n",
+          (unsigned long long) p_game->clock.tick, p_game->board.piece_count,
+          ( game_status == TETRIS_GAME_OVER ) ? "game over" : ( game_status == TETRIS_GAME_WON ) ? "won" : "running",
+          (unsigned long long) board_hash( p_game ), (unsigned long long) board_get_zobrist_hash( p_game ),
+          (double) elapsed_ns / 1000.0 );
+
+  game_destroy( p_game );
+
+  return 0;
+}
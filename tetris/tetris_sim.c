@@ -0,0 +1,489 @@
+/*
+ *  tetris_sim.c
+ *
+ *  Created on: 17-Oct-2026
+ *      Author: lucas-noce
+ */
+
+/* ==========================================================================================================
+ * Includes
+ */
+
+#include <stdlib.h>
+#include <stdio.h>
+#include <stdint.h>
+#include <stdbool.h>
+#include <string.h>
+#include <stdatomic.h>
+
+#include "main.h"
+#include "game_config.h"
+#include "board.h"
+#include "score.h"
+#include "game.h"
+#include "command.h"
+#include "platform.h"
+#include "autoplay.h"
+
+
+/* ==========================================================================================================
+ * Definitions
+ */
+
+#define SIM_DEFAULT_GAME_COUNT  1000
+#define SIM_DEFAULT_MAX_STEPS   100000   // a scripted policy may never end the game by itself
+#define SIM_DEFAULT_SEED        1
+
+#define SIM_NS_PER_SEC          1e9
+
+
+/* ==========================================================================================================
+ * Static Typedefs
+ */
+
+/*!
+  @brief        Indicates where the moves of the simulated player come from.
+*/
+typedef enum{
+  SIM_POLICY_RANDOM = 0,
+  SIM_POLICY_SCRIPT,
+  SIM_POLICY_AUTOPLAY,
+  SIM_POLICY_LAST_IDX,
+} SIM_POLICIES_E;
+
+/*!
+  @brief        Settings shared (read only) by every worker.
+
+  @param        game_total: number of games to play.
+  @param        max_steps: gravity steps after which a game still running is stopped.
+  @param        seed: seed of the first game, game N is seeded with seed + N (pieces and random policy).
+  @param        row_size: number of board rows, bottom border included.
+  @param        col_size: number of board columns, borders included.
+  @param        policy: one of the SIM_POLICIES_E values.
+  @param        p_script: keys played one per gravity step, in a loop (SIM_POLICY_SCRIPT only).
+  @param        script_size: number of keys in `p_script`.
+  @param        difficulty: difficulty of every game (from GAME_DIFFICULTIES_E). It sets the gravity schedule of the
+                games of the automatic player, the other policies play one move per gravity step whatever the speed,
+                so it only changes their score.
+  @param        autoplay: depth and width of the search of the automatic player (SIM_POLICY_AUTOPLAY only).
+  @param        budget_ns: time the automatic player may search each move on top of its node budget, 0 for no limit
+                (a limit makes the games depend on the machine).
+*/
+typedef struct SIM_CONFIG_TAG{
+  uint32_t   game_total;
+  uint32_t   max_steps;
+  uint64_t   seed;
+  uint16_t   row_size;
+  uint16_t   col_size;
+  uint8_t    policy;
+  const char *p_script;
+  size_t     script_size;
+  uint8_t    difficulty;
+  AUTOPLAY_CONFIG_T autoplay;
+  uint64_t   budget_ns;
+} SIM_CONFIG_T;
+
+/*!
+  @brief        State of one worker thread. Each worker plays whole games on its own game, so the workers share
+                nothing but the index of the next game to play.
+
+  @param        thread: the worker thread.
+  @param        game_count: number of games played.
+  @param        over_count: number of games lost (the others were won or stopped at max_steps).
+  @param        piece_count: number of pieces spawned, over all games.
+  @param        row_count: number of rows cleared, over all games.
+  @param        step_count: number of gravity steps run, over all games.
+  @param        score_sum: sum of the final scores.
+  @param        score_min, score_max: lowest and highest final scores.
+  @param        autoplay_stats: search counters of the automatic player, over all games.
+  @param        is_failed: whether the worker could not allocate its game.
+
+  @note         Each worker starts on its own cache line, the counters are written at every game.
+*/
+typedef struct SIM_WORKER_TAG{
+  _Alignas( GAME_CONFIG_CACHE_LINE_SIZE ) PLATFORM_THREAD_T thread;
+  uint64_t game_count;
+  uint64_t over_count;
+  uint64_t piece_count;
+  uint64_t row_count;
+  uint64_t step_count;
+  uint64_t score_sum;
+  uint32_t score_min;
+  uint32_t score_max;
+  AUTOPLAY_STATS_T autoplay_stats;
+  bool     is_failed;
+} SIM_WORKER_T;
+
+
+/* ==========================================================================================================
+ * Static variables
+ */
+
+static const char *sim_policy_names[SIM_POLICY_LAST_IDX] = { "random", "script", "autoplay" };
+
+static SIM_CONFIG_T sim_config;
+static atomic_uint sim_next_game;
+
+
+/* ==========================================================================================================
+ * Static Function Prototypes
+ */
+
+/*!
+  @brief        Plays games until every game of the run was taken by a worker.
+
+  @param[in]    data: pointer to the SIM_WORKER_T of the worker.
+
+  @returns      0 on success, 1 if the game could not be allocated.
+*/
+static uint32_t _sim_worker_thread( void *data );
+
+/*!
+  @brief        Moves a piece just spawned to the placement the automatic player chooses (SIM_POLICY_AUTOPLAY only).
+
+  @param[in]    p_autoplay: the automatic player of the worker.
+  @param[in]    p_game: the game.
+  @param[in]    p_piece_count: number of pieces already moved, updated when the current piece is new.
+
+  @returns      void
+*/
+static void _sim_autoplay_piece( AUTOPLAY_STRUCT_T *p_autoplay, tetris_game_t *p_game, uint32_t *p_piece_count );
+
+/*!
+  @brief        Picks the command the policy plays before a gravity step.
+
+  @param[in]    p_rng_state: state of the random generator of the game (SIM_POLICY_RANDOM only).
+  @param[in]    step: index of the gravity step in the game (SIM_POLICY_SCRIPT only).
+
+  @returns      One of the GAME_COMMANDS_E values, GAME_COMMAND_LAST_IDX for no command.
+*/
+static uint8_t _sim_policy_next_command( uint64_t *p_rng_state, uint32_t step );
+
+/*!
+  @brief        Advances a xorshift64* generator.
+
+  @param[in]    p_state: state of the generator (never 0).
+
+  @returns      The next random value.
+*/
+static uint64_t _sim_rng_next( uint64_t *p_state );
+
+/*!
+  @brief        Parses a decimal option value.
+
+  @param[in]    p_value: the option value.
+  @param[in]    max_value: largest accepted value.
+  @param[in]    default_value: value returned if `p_value` is not a number up to `max_value`.
+
+  @returns      The parsed value, or `default_value`.
+*/
+static uint64_t _sim_parse_number( const char *p_value, uint64_t max_value, uint64_t default_value );
+
+
+/* ==========================================================================================================
+ * Global Functions Declaration
+ */
+
+int main( int argc, char *argv[] ){
+  uint32_t thread_count = platform_get_cpu_count();
+  SIM_WORKER_T *p_workers = NULL;
+  SIM_WORKER_T total = { .score_min = UINT32_MAX };
+  uint64_t start_ns = 0;
+  double elapsed_s = 0;
+
+  sim_config.game_total = SIM_DEFAULT_GAME_COUNT;
+  sim_config.max_steps  = SIM_DEFAULT_MAX_STEPS;
+  sim_config.seed       = SIM_DEFAULT_SEED;
+  sim_config.row_size   = GAME_CONFIG_BOARD_ROW_SIZE;
+  sim_config.col_size   = GAME_CONFIG_BOARD_COL_SIZE;
+  sim_config.policy     = SIM_POLICY_RANDOM;
+  sim_config.difficulty = GAME_DIFFICULTY_EASY;
+  sim_config.autoplay   = (AUTOPLAY_CONFIG_T){ .max_workers = 0, .depth = 1, .beam_width = AUTOPLAY_DEFAULT_BEAM_WIDTH };
+  sim_config.budget_ns  = 0;
+
+  /* Options: --games N --threads N --rows N --cols N --seed N --max-steps N --script KEYS (plays the keys instead
+     of random moves, any key not bound to a command skips a step) --autoplay (the automatic player moves every
+     piece, --lookahead N searches N pieces of the preview, keeping the --beam N best boards at each of them, within
+     the node budget of the gravity period and --budget-ms N per move) --difficulty N (from 0, easy, to 3, expert) */
+  for( int i=1; i<argc; i++ ){
+    if( strcmp( argv[i], "--games" ) == 0 && i < (argc - 1) ){
+      sim_config.game_total = (uint32_t) _sim_parse_number( argv[++i], UINT32_MAX, sim_config.game_total );
+    }
+    else if( strcmp( argv[i], "--threads" ) == 0 && i < (argc - 1) ){
+      thread_count = (uint32_t) _sim_parse_number( argv[++i], UINT16_MAX, thread_count );
+    }
+    else if( strcmp( argv[i], "--rows" ) == 0 && i < (argc - 1) ){
+      sim_config.row_size = (uint16_t) _sim_parse_number( argv[++i], UINT16_MAX, sim_config.row_size );
+    }
+    else if( strcmp( argv[i], "--cols" ) == 0 && i < (argc - 1) ){
+      sim_config.col_size = (uint16_t) _sim_parse_number( argv[++i], UINT16_MAX, sim_config.col_size );
+    }
+    else if( strcmp( argv[i], "--seed" ) == 0 && i < (argc - 1) ){
+      sim_config.seed = _sim_parse_number( argv[++i], UINT64_MAX, sim_config.seed );
+    }
+    else if( strcmp( argv[i], "--max-steps" ) == 0 && i < (argc - 1) ){
+      sim_config.max_steps = (uint32_t) _sim_parse_number( argv[++i], UINT32_MAX, sim_config.max_steps );
+    }
+    else if( strcmp( argv[i], "--script" ) == 0 && i < (argc - 1) ){
+      sim_config.policy      = SIM_POLICY_SCRIPT;
+      sim_config.p_script    = argv[++i];
+      sim_config.script_size = strlen( sim_config.p_script );
+    }
+    else if( strcmp( argv[i], "--autoplay" ) == 0 ){
+      sim_config.policy = SIM_POLICY_AUTOPLAY;
+    }
+    else if( strcmp( argv[i], "--lookahead" ) == 0 && i < (argc - 1) ){
+      sim_config.autoplay.depth = (uint8_t) ( 1 + _sim_parse_number( argv[++i], AUTOPLAY_MAX_DEPTH - 1, sim_config.autoplay.depth - 1 ) );
+    }
+    else if( strcmp( argv[i], "--beam" ) == 0 && i < (argc - 1) ){
+      sim_config.autoplay.beam_width = (uint16_t) _sim_parse_number( argv[++i], AUTOPLAY_MAX_BEAM_WIDTH, sim_config.autoplay.beam_width );
+    }
+    else if( strcmp( argv[i], "--budget-ms" ) == 0 && i < (argc - 1) ){
+      sim_config.budget_ns = _sim_parse_number( argv[++i], UINT32_MAX, sim_config.budget_ns / 1000000 ) * 1000000;
+    }
+    else if( strcmp( argv[i], "--difficulty" ) == 0 && i < (argc - 1) ){
+      sim_config.difficulty = (uint8_t) _sim_parse_number( argv[++i], GAME_DIFFICULTY_LAST_IDX - 1, sim_config.difficulty );
+    }
+    else{
+      printf( "Unknown option: %s\n", argv[i] );
+      return 1;
+    }
+  }
+
+  if( thread_count == 0 )
+    thread_count = 1;
+
+  if( thread_count > sim_config.game_total && sim_config.game_total > 0 )
+    thread_count = sim_config.game_total;
+
+  if( sim_config.policy == SIM_POLICY_SCRIPT && sim_config.script_size == 0 ){
+    printf( "Empty script\n" );
+    return 1;
+  }
+
+  /* Checks the board size once, so the workers do not have to report it */
+  tetris_game_t *p_game = game_create( sim_config.row_size, sim_config.col_size );
+  if( p_game == NULL ){
+    printf( "Invalid board size: %u x %u\n", sim_config.row_size, sim_config.col_size );
+    return 1;
+  }
+  game_destroy( p_game );
+
+  p_workers = game_aligned_alloc( thread_count * sizeof( SIM_WORKER_T ) );
+  if( p_workers == NULL ){
+    printf( "Failed to allocate %u workers\n", thread_count );
+    return 1;
+  }
+
+  memset( p_workers, 0, thread_count * sizeof( SIM_WORKER_T ) );
+  atomic_init( &sim_next_game, 0 );
+
+  start_ns = platform_get_time_ns();
+
+  for( uint32_t i=0; i<thread_count; i++ ){
+    if( platform_thread_create( &p_workers[i].thread, _sim_worker_thread, &p_workers[i] ) != TETRIS_RET_OK ){
+      LOG_WRN( "Failed to create worker %u\n", i );
+      p_workers[i].is_failed = true;
+    }
+  }
+
+  for( uint32_t i=0; i<thread_count; i++ ){
+    if( !p_workers[i].is_failed ){
+      platform_thread_join( &p_workers[i].thread );
+    }
+  }
+
+  elapsed_s = (double) ( platform_get_time_ns() - start_ns ) / SIM_NS_PER_SEC;
+
+  for( uint32_t i=0; i<thread_count; i++ ){
+    total.game_count  += p_workers[i].game_count;
+    total.over_count  += p_workers[i].over_count;
+    total.piece_count += p_workers[i].piece_count;
+    total.row_count   += p_workers[i].row_count;
+    total.step_count  += p_workers[i].step_count;
+    total.score_sum   += p_workers[i].score_sum;
+    total.score_min    = ( p_workers[i].score_min < total.score_min ) ? p_workers[i].score_min : total.score_min;
+    total.score_max    = ( p_workers[i].score_max > total.score_max ) ? p_workers[i].score_max : total.score_max;
+
+    total.autoplay_stats.move_count      += p_workers[i].autoplay_stats.move_count;
+    total.autoplay_stats.node_count      += p_workers[i].autoplay_stats.node_count;
+    total.autoplay_stats.depth_sum       += p_workers[i].autoplay_stats.depth_sum;
+    total.autoplay_stats.timeout_count   += p_workers[i].autoplay_stats.timeout_count;
+    total.autoplay_stats.duplicate_count += p_workers[i].autoplay_stats.duplicate_count;
+    total.autoplay_stats.elapsed_ns      += p_workers[i].autoplay_stats.elapsed_ns;
+  }
+
+  game_aligned_free( p_workers );
+
+  if( total.game_count < sim_config.game_total ){
+    printf( "Only %llu of %u games were played\n", (unsigned long long) total.game_count, sim_config.game_total );
+    return 1;
+  }
+
+  if( elapsed_s <= 0 )
+    elapsed_s = 1 / SIM_NS_PER_SEC;
+
+  printf( "Board %u x %u, %u threads, %s policy, difficulty %u\n", sim_config.row_size, sim_config.col_size,
+          thread_count, sim_policy_names[sim_config.policy], sim_config.difficulty );
+  printf( "Games:  %llu (%llu lost) in %.3f s\n",
+          (unsigned long long) total.game_count, (unsigned long long) total.over_count, elapsed_s );
+  printf( "Pieces: %llu, rows: %llu, steps: %llu, average score: %.1f\n",
+          (unsigned long long) total.piece_count, (unsigned long long) total.row_count,
+          (unsigned long long) total.step_count,
+          ( total.game_count > 0 ) ? (double) total.score_sum / (double) total.game_count : 0.0 );
+  printf( "Scores: min %u, max %u\n", ( total.game_count > 0 ) ? total.score_min : 0, total.score_max );
+  printf( "games/s: %.1f  pieces/s: %.1f  lines/s: %.1f\n",
+          (double) total.game_count / elapsed_s, (double) total.piece_count / elapsed_s,
+          (double) total.row_count / elapsed_s );
+
+  /* The search time is summed over the workers, so the rate printed below is the rate of one worker */
+  if( sim_config.policy == SIM_POLICY_AUTOPLAY ){
+    printf( "nodes/s: %.1f (all workers)\n", (double) total.autoplay_stats.node_count / elapsed_s );
+    autoplay_stats_print( &total.autoplay_stats, sim_config.autoplay.depth );
+  }
+
+  return 0;
+}
+
+
+/* ==========================================================================================================
+ * Static Functions Declaration
+ */
+
+static uint32_t _sim_worker_thread( void *data ){
+  SIM_WORKER_T *p_worker = (SIM_WORKER_T *) data;
+  tetris_game_t *p_game  = game_create( sim_config.row_size, sim_config.col_size );
+  AUTOPLAY_STRUCT_T autoplay;
+  uint8_t game_status    = TETRIS_GAME_NOT_OVER;
+  uint8_t command_type   = GAME_COMMAND_LAST_IDX;
+  uint64_t rng_state     = 0;
+  uint32_t game_idx      = 0;
+  uint32_t step          = 0;
+  uint32_t piece_count   = 0;
+
+  if( p_game == NULL ){
+    p_worker->is_failed = true;
+    return 1;
+  }
+
+  /* The workers already use every core, each player scores its placements on its own thread */
+  if( sim_config.policy == SIM_POLICY_AUTOPLAY &&
+      autoplay_init( &autoplay, sim_config.row_size, sim_config.col_size, &sim_config.autoplay ) != TETRIS_RET_OK ){
+    game_destroy( p_game );
+    p_worker->is_failed = true;
+    return 1;
+  }
+
+  p_worker->score_min = UINT32_MAX;
+
+  while( ( game_idx = atomic_fetch_add_explicit( &sim_next_game, 1, memory_order_relaxed ) ) < sim_config.game_total ){
+    /* The board storage is kept from one game to the next, only the state is reset */
+    board_init( p_game, sim_config.row_size, sim_config.col_size );
+    score_set_difficulty( p_game, sim_config.difficulty );
+    game_clock_init( p_game );
+
+    /* The pieces and the moves of a game only depend on the seed and the game index, not on the worker */
+    game_set_seed( p_game, sim_config.seed + game_idx );
+    rng_state   = ( sim_config.seed ^ ( 0x9E3779B97F4A7C15ull * ( (uint64_t) game_idx + 1 ) ) ) | 1;
+    game_status = TETRIS_GAME_NOT_OVER;
+    piece_count = 0;
+
+    /* The automatic player runs through the ticks, so the gravity schedule of the difficulty sets the node budget
+       of each search. No sleeping: the ticks run back to back */
+    if( sim_config.policy == SIM_POLICY_AUTOPLAY ){
+      while( p_game->clock.step_count < sim_config.max_steps && game_status == TETRIS_GAME_NOT_OVER ){
+        _sim_autoplay_piece( &autoplay, p_game, &piece_count );
+        game_status = game_tick( p_game );
+      }
+
+      step = (uint32_t) p_game->clock.step_count;
+    }
+    else{
+      /* The other policies move once per gravity step, the steps run back to back with the moves in between */
+      for( step=0; step<sim_config.max_steps && game_status == TETRIS_GAME_NOT_OVER; step++ ){
+        command_type = _sim_policy_next_command( &rng_state, step );
+
+        if( command_type != GAME_COMMAND_LAST_IDX ){
+          game_apply_command( p_game, command_type );
+        }
+
+        game_status = game_step( p_game );
+      }
+    }
+
+    p_worker->game_count++;
+    p_worker->over_count  += ( game_status == TETRIS_GAME_OVER ) ? 1 : 0;
+    p_worker->piece_count += p_game->board.piece_count;
+    p_worker->row_count   += score_get_complete_row_count( p_game );
+    p_worker->step_count  += step;
+    p_worker->score_sum   += score_get_game_score( p_game );
+    p_worker->score_min    = ( score_get_game_score( p_game ) < p_worker->score_min ) ? score_get_game_score( p_game ) : p_worker->score_min;
+    p_worker->score_max    = ( score_get_game_score( p_game ) > p_worker->score_max ) ? score_get_game_score( p_game ) : p_worker->score_max;
+  }
+
+  if( sim_config.policy == SIM_POLICY_AUTOPLAY ){
+    p_worker->autoplay_stats = autoplay.stats;
+    autoplay_deinit( &autoplay );
+  }
+
+  game_destroy( p_game );
+
+  return 0;
+}
+
+
+static void _sim_autoplay_piece( AUTOPLAY_STRUCT_T *p_autoplay, tetris_game_t *p_game, uint32_t *p_piece_count ){
+  const uint8_t *p_path = NULL;
+  uint16_t path_count   = 0;
+  uint64_t deadline_ns  = AUTOPLAY_NO_DEADLINE;
+
+  if( !p_game->board.has_current_piece || p_game->board.piece_count == *p_piece_count )
+    return;
+
+  *p_piece_count = p_game->board.piece_count;
+
+  if( sim_config.budget_ns > 0 ){
+    deadline_ns = platform_get_time_ns() + sim_config.budget_ns;
+  }
+
+  if( autoplay_choose( p_autoplay, p_game, deadline_ns, autoplay_get_node_budget( p_game ), &p_path,
+                       &path_count ) != TETRIS_RET_OK )
+    return;
+
+  for( uint16_t i=0; i<path_count; i++ ){
+    game_apply_command( p_game, p_path[i] );
+  }
+}
+
+
+static uint8_t _sim_policy_next_command( uint64_t *p_rng_state, uint32_t step ){
+  if( sim_config.policy == SIM_POLICY_SCRIPT ){
+    return command_from_key( sim_config.p_script[step % sim_config.script_size] );
+  }
+
+  /* GAME_COMMAND_LAST_IDX is one of the picks: the player does nothing on that step */
+  return (uint8_t) ( _sim_rng_next( p_rng_state ) % ( GAME_COMMAND_LAST_IDX + 1 ) );
+}
+
+
+static uint64_t _sim_rng_next( uint64_t *p_state ){
+  uint64_t x = *p_state;
+
+  x ^= x >> 12;
+  x ^= x << 25;
+  x ^= x >> 27;
+  *p_state = x;
+
+  return x * 0x2545F4914F6CDD1Dull;
+}
+
+
+static uint64_t _sim_parse_number( const char *p_value, uint64_t max_value, uint64_t default_value ){
+  char *p_end = NULL;
+  unsigned long long value = strtoull( p_value, &p_end, 10 );
+
+  if( p_end == p_value || *p_end != '\0' || value > max_value )
+    return default_value;
+
+  return (uint64_t) value;
+}
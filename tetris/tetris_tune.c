@@ -0,0 +1,985 @@
+/*
+ *  tetris_tune.c
+ *
+ *  Created on: 17-Oct-2026
+ *      Author: lucas-noce
+ */
+
+/* ==========================================================================================================
+ * Includes
+ */
+
+#include <stdlib.h>
+#include <stdio.h>
+#include <stdint.h>
+#include <stdbool.h>
+#include <stddef.h>
+#include <string.h>
+#include <stdatomic.h>
+
+#include "main.h"
+#include "game_config.h"
+#include "board.h"
+#include "score.h"
+#include "game.h"
+#include "platform.h"
+#include "autoplay.h"
+
+
+/* ==========================================================================================================
+ * Definitions
+ */
+
+#define TUNE_DEFAULT_POPULATION    32
+#define TUNE_DEFAULT_GENERATIONS   20
+#define TUNE_DEFAULT_GAME_COUNT    64
+#define TUNE_DEFAULT_MAX_STEPS     20000   // a good player may never end the game by itself
+#define TUNE_DEFAULT_SEED          1
+#define TUNE_DEFAULT_CHECKPOINT    "tetris_tune.ckpt"
+
+#define TUNE_MAX_POPULATION        1024
+#define TUNE_ELITE_DIVISOR         8       // the best eighth of a generation is kept as is
+#define TUNE_TOURNAMENT_SIZE       3
+#define TUNE_MUTATION_RATE         0.2f
+#define TUNE_MUTATION_STEP         0.2f
+
+#define TUNE_REPORT_SEED_OFFSET    0x100000000ull   // the report games never use the seeds of a generation
+
+#define TUNE_CHECKPOINT_MAGIC      "TETRIS_TUNE"
+#define TUNE_CHECKPOINT_VERSION    2
+
+#define TUNE_NS_PER_SEC            1e9
+
+#define TUNE_WEIGHT_COUNT          5
+#define TUNE_WEIGHT( p_weights, k )  ( *(float *) ( (uint8_t *) (p_weights) + tune_weight_offsets[k] ) )
+
+
+/* ==========================================================================================================
+ * Static Typedefs
+ */
+
+/*!
+  @brief        Settings of the run.
+
+  @param        population_size: number of weight vectors of a generation.
+  @param        generation_total: generation after which the run stops, a resumed run counts the generations done.
+  @param        game_count: games played by every weight vector of a generation, and at every difficulty by the
+                best one at the end.
+  @param        max_steps: gravity steps after which a game still running is stopped.
+  @param        seed: seed of the run, game N of generation G is seeded with seed + G * game_count + N.
+  @param        row_size: number of board rows, bottom border included.
+  @param        col_size: number of board columns, borders included.
+  @param        difficulty: difficulty the weights are tuned at (from GAME_DIFFICULTIES_E), which sets the gravity
+                schedule of the games and so the node budget of each move.
+  @param        autoplay: depth and width of the search of the automatic player.
+  @param        p_checkpoint_path: file the population is written to after every generation.
+  @param        p_resume_path: checkpoint the run starts from, NULL for a new run.
+*/
+typedef struct TUNE_CONFIG_TAG{
+  uint16_t   population_size;
+  uint32_t   generation_total;
+  uint32_t   game_count;
+  uint32_t   max_steps;
+  uint64_t   seed;
+  uint16_t   row_size;
+  uint16_t   col_size;
+  uint8_t    difficulty;
+  AUTOPLAY_CONFIG_T autoplay;
+  const char *p_checkpoint_path;
+  const char *p_resume_path;
+} TUNE_CONFIG_T;
+
+/*!
+  @brief        Games played by the workers at once: every weight vector plays the same games, so the vectors of a
+                generation are compared on the same pieces.
+
+  @param        p_weights: the weight vectors.
+  @param        candidate_count: number of entries in `p_weights`.
+  @param        difficulty: difficulty of every game (from GAME_DIFFICULTIES_E).
+  @param        seed: seed of the first game, game N is seeded with seed + N.
+  @param        p_scores: final score of each game, entry N * candidate_count + C for game N of vector C.
+  @param        task_count: number of games, game_count per vector.
+*/
+typedef struct TUNE_BATCH_TAG{
+  const AUTOPLAY_WEIGHTS_T *p_weights;
+  uint16_t                 candidate_count;
+  uint8_t                  difficulty;
+  uint64_t                 seed;
+  uint32_t                 *p_scores;
+  uint32_t                 task_count;
+} TUNE_BATCH_T;
+
+/*!
+  @brief        The population and the planes a generation is played and bred with.
+
+  @param        p_population: the vectors of the generation being played.
+  @param        p_next: the vectors of the next generation, while it is bred.
+  @param        p_scores: score of each game of the generation (see TUNE_BATCH_T).
+  @param        p_fitness: mean score of each vector of the generation.
+  @param        p_order: the vectors of the generation, from the best.
+  @param        generation: index of the generation being played.
+  @param        rng_state: state of the random generator of the run, only used by the main thread.
+
+  @note         The planes of the vectors are sized for TUNE_MAX_POPULATION vectors, the size of a resumed
+                population is only known once its checkpoint is read.
+*/
+typedef struct TUNE_STATE_TAG{
+  AUTOPLAY_WEIGHTS_T *p_population;
+  AUTOPLAY_WEIGHTS_T *p_next;
+  uint32_t           *p_scores;
+  double             *p_fitness;
+  uint16_t           *p_order;
+  uint32_t           generation;
+  uint64_t           rng_state;
+} TUNE_STATE_T;
+
+/*!
+  @brief        State of one worker thread. Each worker plays whole games on its own game and automatic player, so
+                the workers share nothing but the index of the next game to play.
+
+  @param        thread: the worker thread.
+  @param        game_count: number of games played in the batch.
+  @param        piece_count: number of pieces spawned in the batch.
+  @param        timeout_count: moves of the batch whose search was cut short by the node budget.
+  @param        is_failed: whether the worker could not allocate its game or its player.
+
+  @note         Each worker starts on its own cache line, the counters are written at every game.
+*/
+typedef struct TUNE_WORKER_TAG{
+  _Alignas( GAME_CONFIG_CACHE_LINE_SIZE ) PLATFORM_THREAD_T thread;
+  uint64_t game_count;
+  uint64_t piece_count;
+  uint64_t timeout_count;
+  bool     is_failed;
+} TUNE_WORKER_T;
+
+
+/* ==========================================================================================================
+ * Static variables
+ */
+
+static const size_t tune_weight_offsets[TUNE_WEIGHT_COUNT] = {
+  offsetof( AUTOPLAY_WEIGHTS_T, aggregate_height ),
+  offsetof( AUTOPLAY_WEIGHTS_T, holes ),
+  offsetof( AUTOPLAY_WEIGHTS_T, bumpiness ),
+  offsetof( AUTOPLAY_WEIGHTS_T, wells ),
+  offsetof( AUTOPLAY_WEIGHTS_T, lines ),
+};
+
+static const char *tune_weight_names[TUNE_WEIGHT_COUNT] = { "aggregate_height", "holes", "bumpiness", "wells", "lines" };
+static const char *tune_difficulty_names[GAME_DIFFICULTY_LAST_IDX] = { "easy", "medium", "hard", "expert" };
+
+static TUNE_CONFIG_T tune_config;
+static TUNE_BATCH_T tune_batch;
+static TUNE_STATE_T tune_state;
+static atomic_uint tune_next_task;
+
+
+/* ==========================================================================================================
+ * Static Function Prototypes
+ */
+
+/*!
+  @brief        Plays and breeds generations until generation_total, writing a checkpoint after each.
+
+  @param[in]    p_workers: the workers.
+  @param[in]    thread_count: number of workers.
+
+  @returns      One of the possible TETRIS_RET_x macro values (defined in main.h).
+*/
+static int8_t _tune_evolve( TUNE_WORKER_T *p_workers, uint32_t thread_count );
+
+/*!
+  @brief        Plays the games of the batch on every worker, and waits for them.
+
+  @param[in]    p_workers: the workers.
+  @param[in]    thread_count: number of workers.
+
+  @returns      One of the possible TETRIS_RET_x macro values (defined in main.h), TETRIS_RET_ERR if a game was not
+                played.
+*/
+static int8_t _tune_run_batch( TUNE_WORKER_T *p_workers, uint32_t thread_count );
+
+/*!
+  @brief        Plays games of the batch until every game was taken by a worker.
+
+  @param[in]    data: pointer to the TUNE_WORKER_T of the worker.
+
+  @returns      0 on success, 1 if the game or the player could not be allocated.
+*/
+static uint32_t _tune_worker_thread( void *data );
+
+/*!
+  @brief        Plays a whole game with the automatic player, tick by tick as the game loops do: the difficulty sets
+                how fast the gravity speeds up, and each search has until half the gravity period, as in the game.
+
+  @param[in]    p_autoplay: the automatic player, with the weights to play with.
+  @param[in]    p_game: the game, reset here.
+  @param[in]    seed: seed of the pieces.
+  @param[in]    difficulty: difficulty of the game (from GAME_DIFFICULTIES_E).
+
+  @returns      void
+
+  @note         The ticks run back to back, and the search of each move is bounded by nodes instead of time: a game
+                is the same on every run, whatever the load of the machine or the number of threads.
+*/
+static void _tune_play_game( AUTOPLAY_STRUCT_T *p_autoplay, tetris_game_t *p_game, uint64_t seed, uint8_t difficulty );
+
+/*!
+  @brief        Breeds the next generation into p_next: the best vectors are kept, the best one first, the others
+                are the blend of two vectors won by tournament, weighted by their fitness, with a random change of one
+                weight now and then.
+
+  @returns      void
+*/
+static void _tune_breed( void );
+
+/*!
+  @brief        Picks the best of TUNE_TOURNAMENT_SIZE random vectors of the generation.
+
+  @returns      Index of the vector.
+*/
+static uint16_t _tune_tournament( void );
+
+/*!
+  @brief        Scales a vector so the absolute values of its weights sum to 1. Only the ratios of the weights change
+                the placements played, so every vector is kept on the same scale.
+
+  @param[in]    p_weights: the vector, updated.
+
+  @returns      void
+*/
+static void _tune_normalize( AUTOPLAY_WEIGHTS_T *p_weights );
+
+/*!
+  @brief        Writes the generation to play next to the checkpoint file, through a temporary file so an
+                interrupted write keeps the previous checkpoint.
+
+  @returns      One of the possible TETRIS_RET_x macro values (defined in main.h).
+*/
+static int8_t _tune_checkpoint_save( void );
+
+/*!
+  @brief        Reads the generation to play next from the checkpoint file to resume from.
+
+  @returns      One of the possible TETRIS_RET_x macro values (defined in main.h), TETRIS_RET_ERR if the checkpoint
+                was written with other settings. The population size of the configuration is set to the one of the
+                checkpoint.
+*/
+static int8_t _tune_checkpoint_load( void );
+
+/*!
+  @brief        Reads the generation from an open checkpoint file.
+
+  @param[in]    p_file: the checkpoint file.
+
+  @returns      One of the possible TETRIS_RET_x macro values (defined in main.h).
+*/
+static int8_t _tune_checkpoint_read( FILE *p_file );
+
+/*!
+  @brief        Plays game_count games with a weight vector at every difficulty and prints the distribution of the
+                scores of each, with the moves whose search ran out of nodes.
+
+  @param[in]    p_weights: the vector.
+  @param[in]    p_workers: the workers.
+  @param[in]    thread_count: number of workers.
+  @param[in]    p_scores: game_count entries for the scores.
+
+  @returns      One of the possible TETRIS_RET_x macro values (defined in main.h).
+*/
+static int8_t _tune_report( const AUTOPLAY_WEIGHTS_T *p_weights, TUNE_WORKER_T *p_workers, uint32_t thread_count,
+                            uint32_t *p_scores );
+
+/*!
+  @brief        Prints the weights of a vector on one line.
+
+  @param[in]    p_label: text printed before the weights.
+  @param[in]    p_weights: the vector.
+
+  @returns      void
+*/
+static void _tune_print_weights( const char *p_label, const AUTOPLAY_WEIGHTS_T *p_weights );
+
+/*!
+  @brief        Orders two scores for qsort, from the lowest.
+
+  @param[in]    p_a, p_b: pointers to the scores.
+
+  @returns      A negative value, 0 or a positive value if the first score is lower, equal or higher.
+*/
+static int _tune_compare_scores( const void *p_a, const void *p_b );
+
+/*!
+  @brief        Advances a xorshift64* generator.
+
+  @param[in]    p_state: state of the generator (never 0).
+
+  @returns      The next random value.
+*/
+static uint64_t _tune_rng_next( uint64_t *p_state );
+
+/*!
+  @brief        Draws a uniform value in [0, 1).
+
+  @param[in]    p_state: state of the generator.
+
+  @returns      The value.
+*/
+static float _tune_rng_float( uint64_t *p_state );
+
+/*!
+  @brief        Draws a value of mean 0 and deviation 1, from the sum of 12 uniform values (close enough to normal
+                for a mutation, and needs no math library).
+
+  @param[in]    p_state: state of the generator.
+
+  @returns      The value.
+*/
+static float _tune_rng_gaussian( uint64_t *p_state );
+
+/*!
+  @brief        Parses a decimal option value.
+
+  @param[in]    p_value: the option value.
+  @param[in]    max_value: largest accepted value.
+  @param[in]    default_value: value returned if `p_value` is not a number up to `max_value`.
+
+  @returns      The parsed value, or `default_value`.
+*/
+static uint64_t _tune_parse_number( const char *p_value, uint64_t max_value, uint64_t default_value );
+
+
+/* ==========================================================================================================
+ * Global Functions Declaration
+ */
+
+int main( int argc, char *argv[] ){
+  uint32_t thread_count = platform_get_cpu_count();
+  TUNE_WORKER_T *p_workers = NULL;
+  int ret = 1;
+
+  tune_config.population_size   = TUNE_DEFAULT_POPULATION;
+  tune_config.generation_total  = TUNE_DEFAULT_GENERATIONS;
+  tune_config.game_count        = TUNE_DEFAULT_GAME_COUNT;
+  tune_config.max_steps         = TUNE_DEFAULT_MAX_STEPS;
+  tune_config.seed              = TUNE_DEFAULT_SEED;
+  tune_config.row_size          = GAME_CONFIG_BOARD_ROW_SIZE;
+  tune_config.col_size          = GAME_CONFIG_BOARD_COL_SIZE;
+  tune_config.difficulty        = GAME_DIFFICULTY_EASY;
+  tune_config.autoplay          = (AUTOPLAY_CONFIG_T){ .max_workers = 0, .depth = 1, .beam_width = AUTOPLAY_DEFAULT_BEAM_WIDTH };
+  tune_config.p_checkpoint_path = TUNE_DEFAULT_CHECKPOINT;
+  tune_config.p_resume_path     = NULL;
+
+  /* Options: --population N --generations N --games N (per vector and generation) --threads N --rows N --cols N
+     --seed N --max-steps N --lookahead N --beam N (search of the automatic player) --difficulty N (from 0, easy,
+     to 3, expert, the gravity schedule tuned at) --checkpoint FILE (written after every generation) --resume FILE */
+  for( int i=1; i<argc; i++ ){
+    if( strcmp( argv[i], "--population" ) == 0 && i < (argc - 1) ){
+      tune_config.population_size = (uint16_t) _tune_parse_number( argv[++i], TUNE_MAX_POPULATION, tune_config.population_size );
+    }
+    else if( strcmp( argv[i], "--generations" ) == 0 && i < (argc - 1) ){
+      tune_config.generation_total = (uint32_t) _tune_parse_number( argv[++i], UINT32_MAX, tune_config.generation_total );
+    }
+    else if( strcmp( argv[i], "--games" ) == 0 && i < (argc - 1) ){
+      tune_config.game_count = (uint32_t) _tune_parse_number( argv[++i], UINT16_MAX, tune_config.game_count );
+    }
+    else if( strcmp( argv[i], "--threads" ) == 0 && i < (argc - 1) ){
+      thread_count = (uint32_t) _tune_parse_number( argv[++i], UINT16_MAX, thread_count );
+    }
+    else if( strcmp( argv[i], "--rows" ) == 0 && i < (argc - 1) ){
+      tune_config.row_size = (uint16_t) _tune_parse_number( argv[++i], UINT16_MAX, tune_config.row_size );
+    }
+    else if( strcmp( argv[i], "--cols" ) == 0 && i < (argc - 1) ){
+      tune_config.col_size = (uint16_t) _tune_parse_number( argv[++i], UINT16_MAX, tune_config.col_size );
+    }
+    else if( strcmp( argv[i], "--seed" ) == 0 && i < (argc - 1) ){
+      tune_config.seed = _tune_parse_number( argv[++i], UINT64_MAX, tune_config.seed );
+    }
+    else if( strcmp( argv[i], "--max-steps" ) == 0 && i < (argc - 1) ){
+      tune_config.max_steps = (uint32_t) _tune_parse_number( argv[++i], UINT32_MAX, tune_config.max_steps );
+    }
+    else if( strcmp( argv[i], "--lookahead" ) == 0 && i < (argc - 1) ){
+      tune_config.autoplay.depth = (uint8_t) ( 1 + _tune_parse_number( argv[++i], AUTOPLAY_MAX_DEPTH - 1, tune_config.autoplay.depth - 1 ) );
+    }
+    else if( strcmp( argv[i], "--beam" ) == 0 && i < (argc - 1) ){
+      tune_config.autoplay.beam_width = (uint16_t) _tune_parse_number( argv[++i], AUTOPLAY_MAX_BEAM_WIDTH, tune_config.autoplay.beam_width );
+    }
+    else if( strcmp( argv[i], "--difficulty" ) == 0 && i < (argc - 1) ){
+      tune_config.difficulty = (uint8_t) _tune_parse_number( argv[++i], GAME_DIFFICULTY_LAST_IDX - 1, tune_config.difficulty );
+    }
+    else if( strcmp( argv[i], "--checkpoint" ) == 0 && i < (argc - 1) ){
+      tune_config.p_checkpoint_path = argv[++i];
+    }
+    else if( strcmp( argv[i], "--resume" ) == 0 && i < (argc - 1) ){
+      tune_config.p_resume_path = argv[++i];
+    }
+    else{
+      printf( "Unknown option: %s\n", argv[i] );
+      return 1;
+    }
+  }
+
+  if( thread_count == 0 )
+    thread_count = 1;
+
+  if( tune_config.population_size < 2 || tune_config.game_count == 0 ){
+    printf( "At least 2 vectors and 1 game per vector are needed\n" );
+    return 1;
+  }
+
+  /* Checks the board size once, so the workers do not have to report it */
+  tetris_game_t *p_game = game_create( tune_config.row_size, tune_config.col_size );
+  if( p_game == NULL ){
+    printf( "Invalid board size: %u x %u\n", tune_config.row_size, tune_config.col_size );
+    return 1;
+  }
+  game_destroy( p_game );
+
+  p_workers                = game_aligned_alloc( thread_count * sizeof( TUNE_WORKER_T ) );
+  tune_state.p_population  = malloc( TUNE_MAX_POPULATION * sizeof( AUTOPLAY_WEIGHTS_T ) );
+  tune_state.p_next        = malloc( TUNE_MAX_POPULATION * sizeof( AUTOPLAY_WEIGHTS_T ) );
+  tune_state.p_fitness     = malloc( TUNE_MAX_POPULATION * sizeof( double ) );
+  tune_state.p_order       = malloc( TUNE_MAX_POPULATION * sizeof( uint16_t ) );
+
+  if( p_workers == NULL || tune_state.p_population == NULL || tune_state.p_next == NULL ||
+      tune_state.p_fitness == NULL || tune_state.p_order == NULL ){
+    printf( "Failed to allocate the population\n" );
+  }
+  else if( tune_config.p_resume_path != NULL && _tune_checkpoint_load() != TETRIS_RET_OK ){
+    printf( "Invalid checkpoint: %s\n", tune_config.p_resume_path );
+  }
+  /* The scores are only sized once the population size is known, a checkpoint may change it */
+  else if( ( tune_state.p_scores = malloc( (size_t) tune_config.population_size * tune_config.game_count *
+                                           sizeof( uint32_t ) ) ) == NULL ){
+    printf( "Failed to allocate the scores of %u games\n", tune_config.population_size * tune_config.game_count );
+  }
+  else if( _tune_evolve( p_workers, thread_count ) == TETRIS_RET_OK ){
+    /* The first vector is the best of the last generation played (or the default weights if none was) */
+    _tune_print_weights( "Best weights:", &tune_state.p_population[0] );
+
+    if( _tune_report( &tune_state.p_population[0], p_workers, thread_count, tune_state.p_scores ) == TETRIS_RET_OK ){
+      ret = 0;
+    }
+    else{
+      printf( "The report games could not be played\n" );
+    }
+  }
+
+  free( tune_state.p_order );
+  free( tune_state.p_fitness );
+  free( tune_state.p_scores );
+  free( tune_state.p_next );
+  free( tune_state.p_population );
+  game_aligned_free( p_workers );
+
+  return ret;
+}
+
+
+/* ==========================================================================================================
+ * Static Functions Declaration
+ */
+
+static int8_t _tune_evolve( TUNE_WORKER_T *p_workers, uint32_t thread_count ){
+  AUTOPLAY_WEIGHTS_T *p_swap = NULL;
+  uint64_t start_ns      = 0;
+  uint64_t piece_count   = 0;
+  uint64_t timeout_count = 0;
+  double elapsed_s       = 0;
+  double fitness_sum     = 0;
+  uint16_t count         = 0;
+  uint16_t pos           = 0;
+
+  if( tune_config.p_resume_path != NULL ){
+    printf( "Resumed at generation %u from %s\n", tune_state.generation, tune_config.p_resume_path );
+  }
+  else{
+    /* The default weights are one of the vectors, the others are drawn at random */
+    tune_state.generation = 0;
+    tune_state.rng_state  = ( tune_config.seed ^ 0x9E3779B97F4A7C15ull ) | 1;
+    autoplay_get_default_weights( &tune_state.p_population[0] );
+    _tune_normalize( &tune_state.p_population[0] );
+
+    for( uint16_t i=1; i<tune_config.population_size; i++ ){
+      for( uint8_t k=0; k<TUNE_WEIGHT_COUNT; k++ ){
+        TUNE_WEIGHT( &tune_state.p_population[i], k ) = 2.0f * _tune_rng_float( &tune_state.rng_state ) - 1.0f;
+      }
+
+      _tune_normalize( &tune_state.p_population[i] );
+    }
+  }
+
+  count = tune_config.population_size;
+
+  printf( "Board %u x %u, %u threads, %u vectors, %u games each, depth %u, difficulty %u\n", tune_config.row_size,
+          tune_config.col_size, thread_count, count, tune_config.game_count, tune_config.autoplay.depth,
+          tune_config.difficulty );
+
+  for( ; tune_state.generation<tune_config.generation_total; tune_state.generation++ ){
+    /* Every vector of the generation plays the same games, and no other generation plays them */
+    tune_batch.p_weights       = tune_state.p_population;
+    tune_batch.candidate_count = count;
+    tune_batch.difficulty      = tune_config.difficulty;
+    tune_batch.seed            = tune_config.seed + (uint64_t) tune_state.generation * tune_config.game_count;
+    tune_batch.p_scores        = tune_state.p_scores;
+    tune_batch.task_count      = count * tune_config.game_count;
+
+    start_ns = platform_get_time_ns();
+
+    if( _tune_run_batch( p_workers, thread_count ) != TETRIS_RET_OK ){
+      printf( "The games of generation %u could not be played\n", tune_state.generation );
+      return TETRIS_RET_ERR;
+    }
+
+    elapsed_s     = (double) ( platform_get_time_ns() - start_ns ) / TUNE_NS_PER_SEC;
+    piece_count   = 0;
+    timeout_count = 0;
+    fitness_sum   = 0;
+
+    for( uint32_t i=0; i<thread_count; i++ ){
+      piece_count   += p_workers[i].piece_count;
+      timeout_count += p_workers[i].timeout_count;
+    }
+
+    for( uint16_t c=0; c<count; c++ ){
+      tune_state.p_fitness[c] = 0;
+
+      for( uint32_t g=0; g<tune_config.game_count; g++ ){
+        tune_state.p_fitness[c] += tune_state.p_scores[(size_t) g * count + c];
+      }
+
+      tune_state.p_fitness[c] /= tune_config.game_count;
+      fitness_sum             += tune_state.p_fitness[c];
+    }
+
+    /* Insertion sort from the best, ties keep the order of the vectors so the run does not depend on the threads */
+    for( uint16_t c=0; c<count; c++ ){
+      pos = c;
+
+      while( pos > 0 && tune_state.p_fitness[tune_state.p_order[pos - 1]] < tune_state.p_fitness[c] ){
+        tune_state.p_order[pos] = tune_state.p_order[pos - 1];
+        pos--;
+      }
+
+      tune_state.p_order[pos] = c;
+    }
+
+    if( elapsed_s <= 0 )
+      elapsed_s = 1 / TUNE_NS_PER_SEC;
+
+    printf( "Generation %u: best %.1f, mean %.1f, %u games in %.3f s (%.1f games/s, %.1f pieces/s), %llu timeouts\n",
+            tune_state.generation, tune_state.p_fitness[tune_state.p_order[0]], fitness_sum / count,
+            tune_batch.task_count, elapsed_s, (double) tune_batch.task_count / elapsed_s,
+            (double) piece_count / elapsed_s, (unsigned long long) timeout_count );
+    _tune_print_weights( "  best:", &tune_state.p_population[tune_state.p_order[0]] );
+
+    _tune_breed();
+
+    p_swap                  = tune_state.p_population;
+    tune_state.p_population = tune_state.p_next;
+    tune_state.p_next       = p_swap;
+
+    /* A run stopped at any point resumes from the last generation played, and plays on as if never stopped */
+    tune_state.generation++;
+
+    if( _tune_checkpoint_save() != TETRIS_RET_OK ){
+      LOG_WRN( "Failed to write the checkpoint %s\n", tune_config.p_checkpoint_path );
+    }
+
+    tune_state.generation--;
+  }
+
+  return TETRIS_RET_OK;
+}
+
+
+static int8_t _tune_run_batch( TUNE_WORKER_T *p_workers, uint32_t thread_count ){
+  uint64_t game_count = 0;
+
+  memset( p_workers, 0, thread_count * sizeof( TUNE_WORKER_T ) );
+  atomic_init( &tune_next_task, 0 );
+
+  for( uint32_t i=0; i<thread_count; i++ ){
+    if( platform_thread_create( &p_workers[i].thread, _tune_worker_thread, &p_workers[i] ) != TETRIS_RET_OK ){
+      LOG_WRN( "Failed to create worker %u\n", i );
+      p_workers[i].is_failed = true;
+    }
+  }
+
+  for( uint32_t i=0; i<thread_count; i++ ){
+    if( !p_workers[i].is_failed ){
+      platform_thread_join( &p_workers[i].thread );
+    }
+
+    game_count += p_workers[i].game_count;
+  }
+
+  return ( game_count == tune_batch.task_count ) ? TETRIS_RET_OK : TETRIS_RET_ERR;
+}
+
+
+static uint32_t _tune_worker_thread( void *data ){
+  TUNE_WORKER_T *p_worker = (TUNE_WORKER_T *) data;
+  tetris_game_t *p_game   = game_create( tune_config.row_size, tune_config.col_size );
+  AUTOPLAY_STRUCT_T autoplay;
+  uint32_t task           = 0;
+  uint32_t game_idx       = 0;
+  uint16_t candidate      = 0;
+
+  if( p_game == NULL ){
+    p_worker->is_failed = true;
+    return 1;
+  }
+
+  /* The workers already use every core, each player scores its placements on its own thread */
+  if( autoplay_init( &autoplay, tune_config.row_size, tune_config.col_size, &tune_config.autoplay ) != TETRIS_RET_OK ){
+    game_destroy( p_game );
+    p_worker->is_failed = true;
+    return 1;
+  }
+
+  /* The games of a vector are spread over the batch, so the long games of the good vectors do not all come last */
+  while( ( task = atomic_fetch_add_explicit( &tune_next_task, 1, memory_order_relaxed ) ) < tune_batch.task_count ){
+    game_idx  = task / tune_batch.candidate_count;
+    candidate = (uint16_t) ( task % tune_batch.candidate_count );
+
+    autoplay_set_weights( &autoplay, &tune_batch.p_weights[candidate] );
+    _tune_play_game( &autoplay, p_game, tune_batch.seed + game_idx, tune_batch.difficulty );
+
+    tune_batch.p_scores[task] = score_get_game_score( p_game );
+    p_worker->game_count++;
+    p_worker->piece_count += p_game->board.piece_count;
+  }
+
+  p_worker->timeout_count = autoplay.stats.timeout_count;
+  autoplay_deinit( &autoplay );
+  game_destroy( p_game );
+
+  return 0;
+}
+
+
+static void _tune_play_game( AUTOPLAY_STRUCT_T *p_autoplay, tetris_game_t *p_game, uint64_t seed, uint8_t difficulty ){
+  const uint8_t *p_path = NULL;
+  uint16_t path_count   = 0;
+  uint32_t piece_count  = 0;
+  uint8_t game_status   = TETRIS_GAME_NOT_OVER;
+
+  /* The board storage is kept from one game to the next, only the state is reset */
+  board_init( p_game, tune_config.row_size, tune_config.col_size );
+  score_set_difficulty( p_game, difficulty );
+  game_clock_init( p_game );
+  game_set_seed( p_game, seed );
+
+  /* Played through the ticks, not the gravity steps alone: the gravity schedule of the difficulty sets the
+     node budget of each search, so a harder game is also played with less lookahead */
+  while( p_game->clock.step_count < tune_config.max_steps && game_status == TETRIS_GAME_NOT_OVER ){
+    if( p_game->board.has_current_piece && p_game->board.piece_count != piece_count ){
+      piece_count = p_game->board.piece_count;
+
+      if( autoplay_choose( p_autoplay, p_game, AUTOPLAY_NO_DEADLINE, autoplay_get_node_budget( p_game ), &p_path,
+                           &path_count ) == TETRIS_RET_OK ){
+        for( uint16_t i=0; i<path_count; i++ ){
+          game_apply_command( p_game, p_path[i] );
+        }
+      }
+    }
+
+    game_status = game_tick( p_game );
+  }
+}
+
+
+static void _tune_breed( void ){
+  const AUTOPLAY_WEIGHTS_T *p_population = tune_state.p_population;
+  const double *p_fitness                = tune_state.p_fitness;
+  AUTOPLAY_WEIGHTS_T *p_next             = tune_state.p_next;
+  uint16_t elite_count = tune_config.population_size / TUNE_ELITE_DIVISOR;
+  uint16_t a = 0;
+  uint16_t b = 0;
+  float share = 0.0f;
+
+  if( elite_count == 0 )
+    elite_count = 1;
+
+  for( uint16_t i=0; i<elite_count; i++ ){
+    p_next[i] = p_population[tune_state.p_order[i]];
+  }
+
+  for( uint16_t i=elite_count; i<tune_config.population_size; i++ ){
+    a = _tune_tournament();
+    b = _tune_tournament();
+
+    /* The better parent gives more of its weights, a parent that scored nothing gives none */
+    share = ( p_fitness[a] + p_fitness[b] > 0 ) ? (float) ( p_fitness[a] / ( p_fitness[a] + p_fitness[b] ) ) : 0.5f;
+
+    for( uint8_t k=0; k<TUNE_WEIGHT_COUNT; k++ ){
+      TUNE_WEIGHT( &p_next[i], k ) = share * TUNE_WEIGHT( &p_population[a], k ) +
+                                     ( 1.0f - share ) * TUNE_WEIGHT( &p_population[b], k );
+    }
+
+    if( _tune_rng_float( &tune_state.rng_state ) < TUNE_MUTATION_RATE ){
+      TUNE_WEIGHT( &p_next[i], _tune_rng_next( &tune_state.rng_state ) % TUNE_WEIGHT_COUNT ) +=
+        TUNE_MUTATION_STEP * _tune_rng_gaussian( &tune_state.rng_state );
+    }
+
+    _tune_normalize( &p_next[i] );
+  }
+}
+
+
+static uint16_t _tune_tournament( void ){
+  const double *p_fitness = tune_state.p_fitness;
+  uint16_t best = (uint16_t) ( _tune_rng_next( &tune_state.rng_state ) % tune_config.population_size );
+  uint16_t idx  = 0;
+
+  for( uint8_t i=1; i<TUNE_TOURNAMENT_SIZE; i++ ){
+    idx = (uint16_t) ( _tune_rng_next( &tune_state.rng_state ) % tune_config.population_size );
+
+    if( p_fitness[idx] > p_fitness[best] || ( p_fitness[idx] == p_fitness[best] && idx < best ) ){
+      best = idx;
+    }
+  }
+
+  return best;
+}
+
+
+static void _tune_normalize( AUTOPLAY_WEIGHTS_T *p_weights ){
+  float sum = 0.0f;
+
+  for( uint8_t k=0; k<TUNE_WEIGHT_COUNT; k++ ){
+    sum += ( TUNE_WEIGHT( p_weights, k ) < 0 ) ? -TUNE_WEIGHT( p_weights, k ) : TUNE_WEIGHT( p_weights, k );
+  }
+
+  /* A vector of zeros plays like any other, the default weights take its place */
+  if( sum == 0.0f ){
+    autoplay_get_default_weights( p_weights );
+    _tune_normalize( p_weights );
+    return;
+  }
+
+  for( uint8_t k=0; k<TUNE_WEIGHT_COUNT; k++ ){
+    TUNE_WEIGHT( p_weights, k ) /= sum;
+  }
+}
+
+
+static int8_t _tune_checkpoint_save( void ){
+  char tmp_path[FILENAME_MAX];
+  FILE *p_file = NULL;
+  bool is_written = true;
+
+  if( snprintf( tmp_path, sizeof( tmp_path ), "%s.tmp", tune_config.p_checkpoint_path ) >= (int) sizeof( tmp_path ) )
+    return TETRIS_RET_ERR;
+
+  p_file = fopen( tmp_path, "w" );
+  if( p_file == NULL )
+    return TETRIS_RET_ERR;
+
+  /* Text, so a run can be looked at or edited by hand; 9 digits give every float back exactly */
+  is_written &= fprintf( p_file, "%s %u\n", TUNE_CHECKPOINT_MAGIC, TUNE_CHECKPOINT_VERSION ) > 0;
+  is_written &= fprintf( p_file, "seed %llu\ngames %u\ndifficulty %u\nboard %u %u\ndepth %u\nbeam %u\nmax_steps %u\n",
+                         (unsigned long long) tune_config.seed, tune_config.game_count, tune_config.difficulty,
+                         tune_config.row_size, tune_config.col_size, tune_config.autoplay.depth,
+                         tune_config.autoplay.beam_width, tune_config.max_steps ) > 0;
+  is_written &= fprintf( p_file, "generation %u\nrng %016llx\npopulation %u\n", tune_state.generation,
+                         (unsigned long long) tune_state.rng_state, tune_config.population_size ) > 0;
+
+  for( uint16_t i=0; i<tune_config.population_size; i++ ){
+    for( uint8_t k=0; k<TUNE_WEIGHT_COUNT; k++ ){
+      is_written &= fprintf( p_file, ( k + 1 < TUNE_WEIGHT_COUNT ) ? "%.9g " : "%.9g\n",
+                             (double) TUNE_WEIGHT( &tune_state.p_population[i], k ) ) > 0;
+    }
+  }
+
+  is_written &= ( fclose( p_file ) == 0 );
+
+  if( !is_written ){
+    remove( tmp_path );
+    return TETRIS_RET_ERR;
+  }
+
+#ifdef _WIN32
+  /* rename does not replace an existing file on Windows */
+  remove( tune_config.p_checkpoint_path );
+#endif /* _WIN32 */
+
+  return ( rename( tmp_path, tune_config.p_checkpoint_path ) == 0 ) ? TETRIS_RET_OK : TETRIS_RET_ERR;
+}
+
+
+static int8_t _tune_checkpoint_load( void ){
+  FILE *p_file = fopen( tune_config.p_resume_path, "r" );
+  int8_t ret   = TETRIS_RET_ERR;
+
+  if( p_file == NULL )
+    return TETRIS_RET_ERR;
+
+  ret = _tune_checkpoint_read( p_file );
+  fclose( p_file );
+
+  return ret;
+}
+
+
+static int8_t _tune_checkpoint_read( FILE *p_file ){
+  char magic[sizeof( TUNE_CHECKPOINT_MAGIC )];
+  unsigned int version = 0;
+  unsigned int generation = 0;
+  unsigned int population_size = 0;
+  unsigned long long rng_state = 0;
+  unsigned long long seed = 0;
+  unsigned int game_count = 0;
+  unsigned int difficulty = 0;
+  unsigned int row_size = 0;
+  unsigned int col_size = 0;
+  unsigned int depth = 0;
+  unsigned int beam_width = 0;
+  unsigned int max_steps = 0;
+  float weight = 0.0f;
+
+  if( fscanf( p_file, "%11s %u", magic, &version ) != 2 || strcmp( magic, TUNE_CHECKPOINT_MAGIC ) != 0 ||
+      version != TUNE_CHECKPOINT_VERSION )
+    return TETRIS_RET_ERR;
+
+  if( fscanf( p_file, " seed %llu games %u difficulty %u board %u %u depth %u beam %u max_steps %u", &seed, &game_count,
+              &difficulty, &row_size, &col_size, &depth, &beam_width, &max_steps ) != 8 )
+    return TETRIS_RET_ERR;
+
+  /* The fitness of the population was measured on these games, a run on other games would mix two scales */
+  if( seed != tune_config.seed || game_count != tune_config.game_count || difficulty != tune_config.difficulty ||
+      row_size != tune_config.row_size || col_size != tune_config.col_size || depth != tune_config.autoplay.depth ||
+      beam_width != tune_config.autoplay.beam_width || max_steps != tune_config.max_steps ){
+    printf( "The checkpoint was written with --seed %llu --games %u --difficulty %u --rows %u --cols %u "
+            "--lookahead %u --beam %u --max-steps %u\n", seed, game_count, difficulty, row_size, col_size,
+            ( depth > 0 ) ? depth - 1 : 0, beam_width, max_steps );
+    return TETRIS_RET_ERR;
+  }
+
+  if( fscanf( p_file, " generation %u rng %llx population %u", &generation, &rng_state, &population_size ) != 3 ||
+      rng_state == 0 || population_size < 2 || population_size > TUNE_MAX_POPULATION )
+    return TETRIS_RET_ERR;
+
+  for( uint16_t i=0; i<population_size; i++ ){
+    for( uint8_t k=0; k<TUNE_WEIGHT_COUNT; k++ ){
+      if( fscanf( p_file, "%f", &weight ) != 1 )
+        return TETRIS_RET_ERR;
+
+      TUNE_WEIGHT( &tune_state.p_population[i], k ) = weight;
+    }
+  }
+
+  if( population_size != tune_config.population_size ){
+    LOG_WRN( "The checkpoint holds %u vectors, --population is ignored\n", population_size );
+  }
+
+  tune_config.population_size = (uint16_t) population_size;
+  tune_state.generation       = generation;
+  tune_state.rng_state        = rng_state;
+
+  return TETRIS_RET_OK;
+}
+
+
+static int8_t _tune_report( const AUTOPLAY_WEIGHTS_T *p_weights, TUNE_WORKER_T *p_workers, uint32_t thread_count,
+                            uint32_t *p_scores ){
+  uint32_t count         = tune_config.game_count;
+  uint64_t timeout_count = 0;
+  double sum             = 0;
+
+  printf( "%-10s %8s %10s %8s %8s %8s %8s %8s %8s %8s %9s\n", "difficulty", "games", "mean", "min", "p10", "p25",
+          "p50", "p75", "p90", "max", "timeouts" );
+
+  /* Every difficulty deals the same pieces, but plays them at its own gravity schedule: besides the points of a
+     row, a harder game leaves the player less time to search each move */
+  for( uint8_t d=0; d<GAME_DIFFICULTY_LAST_IDX; d++ ){
+    tune_batch.p_weights       = p_weights;
+    tune_batch.candidate_count = 1;
+    tune_batch.difficulty      = d;
+    tune_batch.seed            = tune_config.seed + TUNE_REPORT_SEED_OFFSET;
+    tune_batch.p_scores        = p_scores;
+    tune_batch.task_count      = count;
+
+    if( _tune_run_batch( p_workers, thread_count ) != TETRIS_RET_OK )
+      return TETRIS_RET_ERR;
+
+    qsort( p_scores, count, sizeof( uint32_t ), _tune_compare_scores );
+
+    sum           = 0;
+    timeout_count = 0;
+
+    for( uint32_t g=0; g<count; g++ ){
+      sum += p_scores[g];
+    }
+
+    for( uint32_t i=0; i<thread_count; i++ ){
+      timeout_count += p_workers[i].timeout_count;
+    }
+
+    printf( "%-10s %8u %10.1f %8u %8u %8u %8u %8u %8u %8u %9llu\n", tune_difficulty_names[d], count, sum / count,
+            p_scores[0], p_scores[count / 10], p_scores[count / 4], p_scores[count / 2], p_scores[count * 3 / 4],
+            p_scores[count * 9 / 10], p_scores[count - 1], (unsigned long long) timeout_count );
+  }
+
+  return TETRIS_RET_OK;
+}
+
+
+static void _tune_print_weights( const char *p_label, const AUTOPLAY_WEIGHTS_T *p_weights ){
+  printf( "%s", p_label );
+
+  for( uint8_t k=0; k<TUNE_WEIGHT_COUNT; k++ ){
+    printf( " %s %.6f", tune_weight_names[k], (double) TUNE_WEIGHT( p_weights, k ) );
+  }
+
+  printf( "\n" );
+}
+
+
+static int _tune_compare_scores( const void *p_a, const void *p_b ){
+  uint32_t a = *(const uint32_t *) p_a;
+  uint32_t b = *(const uint32_t *) p_b;
+
+  return ( a > b ) - ( a < b );
+}
+
+
+static uint64_t _tune_rng_next( uint64_t *p_state ){
+  uint64_t x = *p_state;
+
+  x ^= x >> 12;
+  x ^= x << 25;
+  x ^= x >> 27;
+  *p_state = x;
+
+  return x * 0x2545F4914F6CDD1Dull;
+}
+
+
+static float _tune_rng_float( uint64_t *p_state ){
+  return (float) ( _tune_rng_next( p_state ) >> 40 ) / (float) ( 1u << 24 );
+}
+
+
+static float _tune_rng_gaussian( uint64_t *p_state ){
+  float sum = 0.0f;
+
+  for( uint8_t i=0; i<12; i++ ){
+    sum += _tune_rng_float( p_state );
+  }
+
+  return sum - 6.0f;
+}
+
+
+static uint64_t _tune_parse_number( const char *p_value, uint64_t max_value, uint64_t default_value ){
+  char *p_end = NULL;
+  unsigned long long value = strtoull( p_value, &p_end, 10 );
+
+  if( p_end == p_value || *p_end != '\0' || value > max_value )
+    return default_value;
+
+  return (uint64_t) value;
+}
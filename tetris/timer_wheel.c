@@ -0,0 +1,257 @@
+/*
+ *  timer_wheel.c
+ *
+ *  Created on: 17-Oct-2026
+ *      Author: lucas-noce
+ */
+
+/* ==========================================================================================================
+ * Includes
+ */
+
+#include <stdlib.h>
+#include <stdint.h>
+#include <stdbool.h>
+
+#include "main.h"
+#include "timer_wheel.h"
+
+
+/* ==========================================================================================================
+ * Definitions
+ */
+
+#define TIMER_WHEEL_SLOT_MASK             ( TIMER_WHEEL_SLOT_COUNT - 1 )
+#define TIMER_WHEEL_LEVEL_SHIFT( level )  ( TIMER_WHEEL_SLOT_BITS * ( level ) )
+#define TIMER_WHEEL_LEVEL_SPAN( level )   ( (uint64_t) 1 << TIMER_WHEEL_LEVEL_SHIFT( ( level ) + 1 ) )
+
+
+/* ==========================================================================================================
+ * Static Function Prototypes
+ */
+
+/*!
+  @brief        Links a timer into the slot matching its expire tick, relative to the wheel current tick.
+
+  @param[in]    p_wheel: pointer to the wheel.
+  @param[in]    p_timer: pointer to the timer (not linked).
+
+  @returns      void
+*/
+static void _insert_timer( TIMER_WHEEL_T *p_wheel, TIMER_STRUCT_T *p_timer );
+
+/*!
+  @brief        Unlinks a timer from its slot.
+
+  @param[in]    p_timer: pointer to the timer (linked).
+
+  @returns      void
+*/
+static void _unlink_timer( TIMER_STRUCT_T *p_timer );
+
+/*!
+  @brief        Moves the whole list of a slot to another list head, leaving the slot empty.
+
+  @param[in]    p_slot: pointer to the slot.
+  @param[out]   p_list: pointer to the list head that receives the timers.
+
+  @returns      void
+*/
+static void _take_slot( TIMER_STRUCT_T *p_slot, TIMER_STRUCT_T *p_list );
+
+/*!
+  @brief        Re-inserts the timers of an upper level slot, which moves them down as they get closer.
+
+  @param[in]    p_wheel: pointer to the wheel.
+  @param[in]    level: level of the slot (1 or above).
+  @param[in]    index: index of the slot in its level.
+
+  @returns      void
+*/
+static void _cascade_slot( TIMER_WHEEL_T *p_wheel, uint8_t level, uint32_t index );
+
+
+/* ==========================================================================================================
+ * Global Functions Declaration
+ */
+
+void timer_wheel_init( TIMER_WHEEL_T *p_wheel, uint64_t start_tick ){
+  p_wheel->current_tick = start_tick;
+  p_wheel->timer_count  = 0;
+
+  for( uint8_t level=0; level<TIMER_WHEEL_LEVEL_COUNT; level++ ){
+    for( uint32_t i=0; i<TIMER_WHEEL_SLOT_COUNT; i++ ){
+      p_wheel->slots[level][i].p_next = &p_wheel->slots[level][i];
+      p_wheel->slots[level][i].p_prev = &p_wheel->slots[level][i];
+    }
+  }
+}
+
+
+void timer_init( TIMER_STRUCT_T *p_timer, timer_callback_t callback, void *p_arg ){
+  p_timer->p_next      = NULL;
+  p_timer->p_prev      = NULL;
+  p_timer->expire_tick = 0;
+  p_timer->callback    = callback;
+  p_timer->p_arg       = p_arg;
+}
+
+
+void timer_wheel_add( TIMER_WHEEL_T *p_wheel, TIMER_STRUCT_T *p_timer, uint64_t expire_tick ){
+  timer_wheel_cancel( p_wheel, p_timer );
+
+  p_timer->expire_tick = expire_tick;
+  _insert_timer( p_wheel, p_timer );
+  p_wheel->timer_count++;
+}
+
+
+void timer_wheel_cancel( TIMER_WHEEL_T *p_wheel, TIMER_STRUCT_T *p_timer ){
+  if( !timer_is_pending( p_timer ) )
+    return;
+
+  _unlink_timer( p_timer );
+  p_wheel->timer_count--;
+}
+
+
+bool timer_is_pending( const TIMER_STRUCT_T *p_timer ){
+  return ( p_timer->p_next != NULL );
+}
+
+
+void timer_wheel_advance( TIMER_WHEEL_T *p_wheel, uint64_t now_tick ){
+  TIMER_STRUCT_T expired;
+  TIMER_STRUCT_T *p_timer = NULL;
+  uint32_t index          = 0;
+
+  while( p_wheel->current_tick <= now_tick ){
+    /* Nothing to fire on the way, jump straight to now */
+    if( p_wheel->timer_count == 0 ){
+      p_wheel->current_tick = now_tick + 1;
+      return;
+    }
+
+    index = (uint32_t) ( p_wheel->current_tick & TIMER_WHEEL_SLOT_MASK );
+
+    /* Level 0 wrapped around: the next slot of each upper level comes in range (as long as the level below
+       wrapped too) */
+    if( index == 0 ){
+      for( uint8_t level=1; level<TIMER_WHEEL_LEVEL_COUNT; level++ ){
+        uint32_t level_index = (uint32_t) ( ( p_wheel->current_tick >> TIMER_WHEEL_LEVEL_SHIFT( level ) ) & TIMER_WHEEL_SLOT_MASK );
+
+        _cascade_slot( p_wheel, level, level_index );
+
+        if( level_index != 0 )
+          break;
+      }
+    }
+
+    _take_slot( &p_wheel->slots[0][index], &expired );
+
+    /* The tick is consumed before the callbacks run, so a timer re-armed for now fires on the next tick instead
+       of a whole wheel turn later */
+    p_wheel->current_tick++;
+
+    while( expired.p_next != &expired ){
+      p_timer = expired.p_next;
+      _unlink_timer( p_timer );
+      p_wheel->timer_count--;
+
+      p_timer->callback( p_timer->p_arg );
+    }
+  }
+}
+
+
+uint64_t timer_wheel_ticks_to_next( const TIMER_WHEEL_T *p_wheel ){
+  uint32_t index = (uint32_t) ( p_wheel->current_tick & TIMER_WHEEL_SLOT_MASK );
+
+  if( p_wheel->timer_count == 0 )
+    return TIMER_WHEEL_NO_TIMER;
+
+  /* The upper levels are moved down while this tick is processed, they may hold a timer expiring right now */
+  if( index == 0 )
+    return 0;
+
+  for( uint32_t i=index; i<TIMER_WHEEL_SLOT_COUNT; i++ ){
+    if( p_wheel->slots[0][i].p_next != &p_wheel->slots[0][i] )
+      return i - index;
+  }
+
+  /* Nothing left in this turn of level 0, the upper levels must be looked at again when it wraps */
+  return TIMER_WHEEL_SLOT_COUNT - index;
+}
+
+
+/* ==========================================================================================================
+ * Static Functions Declaration
+ */
+
+static void _insert_timer( TIMER_WHEEL_T *p_wheel, TIMER_STRUCT_T *p_timer ){
+  uint64_t expire_tick = p_timer->expire_tick;
+  uint64_t delta       = 0;
+  uint8_t level        = 0;
+  TIMER_STRUCT_T *p_slot = NULL;
+
+  /* A timer already due goes to the slot processed next */
+  if( expire_tick < p_wheel->current_tick )
+    expire_tick = p_wheel->current_tick;
+
+  delta = expire_tick - p_wheel->current_tick;
+
+  while( level < ( TIMER_WHEEL_LEVEL_COUNT - 1 ) && delta >= TIMER_WHEEL_LEVEL_SPAN( level ) ){
+    level++;
+  }
+
+  /* Out of range: parked in the furthest slot of the last level, moved down when that slot comes in range */
+  if( delta >= TIMER_WHEEL_LEVEL_SPAN( level ) ){
+    expire_tick = p_wheel->current_tick + TIMER_WHEEL_LEVEL_SPAN( level ) - 1;
+  }
+
+  p_slot = &p_wheel->slots[level][( expire_tick >> TIMER_WHEEL_LEVEL_SHIFT( level ) ) & TIMER_WHEEL_SLOT_MASK];
+
+  p_timer->p_next         = p_slot;
+  p_timer->p_prev         = p_slot->p_prev;
+  p_slot->p_prev->p_next  = p_timer;
+  p_slot->p_prev          = p_timer;
+}
+
+
+static void _unlink_timer( TIMER_STRUCT_T *p_timer ){
+  p_timer->p_prev->p_next = p_timer->p_next;
+  p_timer->p_next->p_prev = p_timer->p_prev;
+  p_timer->p_next         = NULL;
+  p_timer->p_prev         = NULL;
+}
+
+
+static void _take_slot( TIMER_STRUCT_T *p_slot, TIMER_STRUCT_T *p_list ){
+  if( p_slot->p_next == p_slot ){
+    p_list->p_next = p_list;
+    p_list->p_prev = p_list;
+    return;
+  }
+
+  p_list->p_next         = p_slot->p_next;
+  p_list->p_prev         = p_slot->p_prev;
+  p_list->p_next->p_prev = p_list;
+  p_list->p_prev->p_next = p_list;
+
+  p_slot->p_next = p_slot;
+  p_slot->p_prev = p_slot;
+}
+
+
+static void _cascade_slot( TIMER_WHEEL_T *p_wheel, uint8_t level, uint32_t index ){
+  TIMER_STRUCT_T cascaded;
+  TIMER_STRUCT_T *p_timer = NULL;
+
+  _take_slot( &p_wheel->slots[level][index], &cascaded );
+
+  while( cascaded.p_next != &cascaded ){
+    p_timer = cascaded.p_next;
+    _unlink_timer( p_timer );
+    _insert_timer( p_wheel, p_timer );
+  }
+}
@@ -0,0 +1,150 @@
+/*
+ *  timer_wheel.h
+ *
+ *  Created on: 17-Oct-2026
+ *      Author: lucas-noce
+ */
+
+#ifndef _TIMER_WHEEL_H_
+#define _TIMER_WHEEL_H_
+
+
+/* ==========================================================================================================
+ * Includes
+ */
+
+#include <stdint.h>
+#include <stdbool.h>
+
+#include "main.h"
+
+
+/* ==========================================================================================================
+ * Definitions
+ */
+
+#define TIMER_WHEEL_LEVEL_COUNT  4
+#define TIMER_WHEEL_SLOT_BITS    6
+#define TIMER_WHEEL_SLOT_COUNT   ( 1u << TIMER_WHEEL_SLOT_BITS )
+
+#define TIMER_WHEEL_NO_TIMER     UINT64_MAX
+
+
+/* ==========================================================================================================
+ * Typedefs
+ */
+
+typedef void (*timer_callback_t)( void *p_arg );
+
+/*!
+  @brief        A timer, owned by the caller and linked into a wheel while pending.
+
+  @param        p_next: next timer in the same wheel slot.
+  @param        p_prev: previous timer in the same wheel slot (or the slot itself).
+  @param        expire_tick: wheel tick at which the timer fires.
+  @param        callback: function called when the timer fires. It may add timers, this one included.
+  @param        p_arg: argument passed to the callback.
+*/
+typedef struct TIMER_STRUCT_TAG{
+  struct TIMER_STRUCT_TAG *p_next;
+  struct TIMER_STRUCT_TAG *p_prev;
+  uint64_t                expire_tick;
+  timer_callback_t        callback;
+  void                    *p_arg;
+} TIMER_STRUCT_T;
+
+/*!
+  @brief        Hierarchical timer wheel. Level 0 has one slot per tick, each next level has one slot per whole
+                turn of the level below, so adding, cancelling and firing a timer are O(1) whatever the number of
+                pending timers.
+
+  @param        current_tick: next tick to be processed. Timers expiring before it have fired already.
+  @param        timer_count: number of pending timers.
+  @param        slots: circular lists of pending timers, the slot itself being the list head.
+
+  @note         Timers further than TIMER_WHEEL_SLOT_COUNT^TIMER_WHEEL_LEVEL_COUNT ticks away are parked in the
+                last level and moved down until they are in range.
+*/
+typedef struct TIMER_WHEEL_TAG{
+  uint64_t       current_tick;
+  uint32_t       timer_count;
+  TIMER_STRUCT_T slots[TIMER_WHEEL_LEVEL_COUNT][TIMER_WHEEL_SLOT_COUNT];
+} TIMER_WHEEL_T;
+
+
+/* ==========================================================================================================
+ * Global Functions
+ */
+
+/*!
+  @brief        Empties a timer wheel.
+
+  @param[in]    p_wheel: pointer to the wheel.
+  @param[in]    start_tick: tick the wheel starts at.
+
+  @returns      void
+*/
+void timer_wheel_init( TIMER_WHEEL_T *p_wheel, uint64_t start_tick );
+
+/*!
+  @brief        Initializes a timer, not pending.
+
+  @param[in]    p_timer: pointer to the timer.
+  @param[in]    callback: function called when the timer fires.
+  @param[in]    p_arg: argument passed to the callback.
+
+  @returns      void
+*/
+void timer_init( TIMER_STRUCT_T *p_timer, timer_callback_t callback, void *p_arg );
+
+/*!
+  @brief        Arms a timer. A timer that is already pending is moved to the new tick.
+
+  @param[in]    p_wheel: pointer to the wheel.
+  @param[in]    p_timer: pointer to the timer.
+  @param[in]    expire_tick: tick at which the timer fires. A tick already processed fires on the next advance.
+
+  @returns      void
+*/
+void timer_wheel_add( TIMER_WHEEL_T *p_wheel, TIMER_STRUCT_T *p_timer, uint64_t expire_tick );
+
+/*!
+  @brief        Disarms a timer, if it is pending.
+
+  @param[in]    p_wheel: pointer to the wheel.
+  @param[in]    p_timer: pointer to the timer.
+
+  @returns      void
+*/
+void timer_wheel_cancel( TIMER_WHEEL_T *p_wheel, TIMER_STRUCT_T *p_timer );
+
+/*!
+  @brief        Checks whether a timer is armed and has not fired yet.
+
+  @param[in]    p_timer: pointer to the timer.
+
+  @returns      true if the timer is pending.
+*/
+bool timer_is_pending( const TIMER_STRUCT_T *p_timer );
+
+/*!
+  @brief        Processes every tick up to now_tick (included), firing the timers that expire on them.
+
+  @param[in]    p_wheel: pointer to the wheel.
+  @param[in]    now_tick: current tick.
+
+  @returns      void
+*/
+void timer_wheel_advance( TIMER_WHEEL_T *p_wheel, uint64_t now_tick );
+
+/*!
+  @brief        Gets how long the caller may sleep before calling timer_wheel_advance again.
+
+  @param[in]    p_wheel: pointer to the wheel.
+
+  @returns      Ticks until the next timer expires or until timers must be moved down a level (whichever comes
+                first), or TIMER_WHEEL_NO_TIMER if no timer is pending.
+*/
+uint64_t timer_wheel_ticks_to_next( const TIMER_WHEEL_T *p_wheel );
+
+#endif /* _TIMER_WHEEL_H_ */
@@ -0,0 +1,223 @@
+/*
+ *  transposition.c
+ *
+ *  Created on: 17-Oct-2026
+ *      Author: lucas-noce
+ */
+
+/* ==========================================================================================================
+ * Includes
+ */
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <string.h>
+#include <stdatomic.h>
+
+#include "main.h"
+#include "game_config.h"
+#include "game.h"
+#include "transposition.h"
+
+
+/* ==========================================================================================================
+ * Definitions
+ */
+
+#define TRANSPOSITION_DATA( value_bits, age, hash )  \
+  ( (uint64_t) (value_bits) | ( (uint64_t) (age) << 32 ) | ( (hash) & 0xFFFF000000000000ull ) )
+
+#define TRANSPOSITION_DATA_AGE( data )      ( (uint16_t) ( (data) >> 32 ) )
+#define TRANSPOSITION_DATA_MATCHES( data, age, hash ) \
+  ( TRANSPOSITION_DATA_AGE( data ) == (age) && ( ( (data) ^ (hash) ) & 0xFFFF000000000000ull ) == 0 )
+
+#define TRANSPOSITION_MAX_BUCKETS  ( 1u << 31 )
+
+/* Key 0 marks an unused entry, but it is also the hash of the empty board: that board is keyed with a fixed odd
+   constant instead, which collides with another board as rarely as any two hashes do */
+#define TRANSPOSITION_ZERO_HASH_KEY  0x9E3779B97F4A7C15ull
+#define TRANSPOSITION_KEY( hash )    ( ( (hash) != 0 ) ? (hash) : TRANSPOSITION_ZERO_HASH_KEY )
+
+
+/* ==========================================================================================================
+ * Static Function Prototypes
+ */
+
+/*!
+  @brief        Finds the entry of a board in its bucket, or takes the entry of the oldest search for it.
+
+  @param[in]    p_table: pointer to the table.
+  @param[in]    hash: hash of the board, already mapped by TRANSPOSITION_KEY (not 0).
+
+  @returns      The entry, or NULL if every entry holds another board of the current search.
+*/
+static TRANSPOSITION_ENTRY_T *_claim_entry( TRANSPOSITION_TABLE_T *p_table, uint64_t hash );
+
+/*!
+  @brief        Gets the float held in the low bits of an entry data.
+
+  @param[in]    data: the data.
+
+  @returns      The value.
+*/
+static float _data_value( uint64_t data );
+
+
+/* ==========================================================================================================
+ * Global Functions Declaration
+ */
+
+int8_t transposition_init( TRANSPOSITION_TABLE_T *p_table, uint32_t bucket_count ){
+  uint32_t count = 1;
+
+  memset( p_table, 0, sizeof( TRANSPOSITION_TABLE_T ) );
+
+  while( count < bucket_count && count < TRANSPOSITION_MAX_BUCKETS ){
+    count <<= 1;
+  }
+
+  p_table->storage_size = (size_t) count * sizeof( TRANSPOSITION_BUCKET_T );
+  p_table->p_storage    = game_aligned_alloc( p_table->storage_size );
+
+  if( p_table->p_storage == NULL ){
+    LOG_WRN( "Failed to allocate %zu bytes for the transposition table\n", p_table->storage_size );
+    p_table->storage_size = 0;
+    return TETRIS_RET_ERR;
+  }
+
+  /* An all zero entry is an unused one */
+  memset( p_table->p_storage, 0, p_table->storage_size );
+
+  p_table->buckets     = (TRANSPOSITION_BUCKET_T *) p_table->p_storage;
+  p_table->bucket_mask = count - 1;
+  p_table->age         = 1;
+
+  return TETRIS_RET_OK;
+}
+
+
+void transposition_deinit( TRANSPOSITION_TABLE_T *p_table ){
+  game_aligned_free( p_table->p_storage );
+  p_table->p_storage    = NULL;
+  p_table->storage_size = 0;
+  p_table->buckets      = NULL;
+}
+
+
+void transposition_new_search( TRANSPOSITION_TABLE_T *p_table ){
+  p_table->age++;
+
+  /* Age 0 is the age of the unused entries */
+  if( p_table->age == 0 )
+    p_table->age = 1;
+}
+
+
+bool transposition_store( TRANSPOSITION_TABLE_T *p_table, uint64_t hash, float value ){
+  TRANSPOSITION_ENTRY_T *p_entry = NULL;
+  uint32_t value_bits = 0;
+  uint64_t data       = 0;
+  uint64_t new_data   = 0;
+
+  hash    = TRANSPOSITION_KEY( hash );
+  p_entry = _claim_entry( p_table, hash );
+
+  if( p_entry == NULL )
+    return false;
+
+  memcpy( &value_bits, &value, sizeof( value_bits ) );
+  new_data = TRANSPOSITION_DATA( value_bits, p_table->age, hash );
+  data     = atomic_load_explicit( &p_entry->data, memory_order_relaxed );
+
+  /* The highest value wins whatever the order of the threads, so the search gives the same result on any pool */
+  do{
+    if( TRANSPOSITION_DATA_MATCHES( data, p_table->age, hash ) && _data_value( data ) >= value )
+      return true;
+  } while( !atomic_compare_exchange_weak_explicit( &p_entry->data, &data, new_data, memory_order_relaxed,
+                                                   memory_order_relaxed ) );
+
+  return true;
+}
+
+
+bool transposition_probe( TRANSPOSITION_TABLE_T *p_table, uint64_t hash, float *p_value ){
+  TRANSPOSITION_BUCKET_T *p_bucket = NULL;
+  uint64_t data = 0;
+  bool is_found = false;
+
+  hash     = TRANSPOSITION_KEY( hash );
+  p_bucket = &p_table->buckets[hash & p_table->bucket_mask];
+
+  /* Two threads that stored the same new board at once may have taken two entries, the best of them is the value */
+  for( uint8_t i=0; i<TRANSPOSITION_BUCKET_ENTRIES; i++ ){
+    if( atomic_load_explicit( &p_bucket->entries[i].key, memory_order_relaxed ) != hash )
+      continue;
+
+    data = atomic_load_explicit( &p_bucket->entries[i].data, memory_order_relaxed );
+
+    if( !TRANSPOSITION_DATA_MATCHES( data, p_table->age, hash ) )
+      continue;
+
+    if( !is_found || _data_value( data ) > *p_value ){
+      *p_value = _data_value( data );
+    }
+
+    is_found = true;
+  }
+
+  return is_found;
+}
+
+
+/* ==========================================================================================================
+ * Static Functions Declaration
+ */
+
+static TRANSPOSITION_ENTRY_T *_claim_entry( TRANSPOSITION_TABLE_T *p_table, uint64_t hash ){
+  TRANSPOSITION_BUCKET_T *p_bucket = &p_table->buckets[hash & p_table->bucket_mask];
+  uint64_t key         = 0;
+  uint64_t victim_key  = 0;
+  uint32_t distance    = 0;
+  uint32_t best        = 0;
+  uint8_t victim       = 0;
+
+  while( 1 ){
+    best = 0;
+
+    for( uint8_t i=0; i<TRANSPOSITION_BUCKET_ENTRIES; i++ ){
+      key = atomic_load_explicit( &p_bucket->entries[i].key, memory_order_relaxed );
+
+      if( key == hash )
+        return &p_bucket->entries[i];
+
+      /* Unused entries first, then the entries of the oldest search */
+      distance = ( key == 0 ) ? UINT16_MAX + 1u :
+                 (uint16_t) ( p_table->age -
+                              TRANSPOSITION_DATA_AGE( atomic_load_explicit( &p_bucket->entries[i].data, memory_order_relaxed ) ) );
+
+      if( distance > best ){
+        best       = distance;
+        victim     = i;
+        victim_key = key;
+      }
+    }
+
+    if( best == 0 )
+      return NULL;
+
+    /* Another thread may take the same entry first, the bucket is then looked at again */
+    if( atomic_compare_exchange_strong_explicit( &p_bucket->entries[victim].key, &victim_key, hash,
+                                                 memory_order_relaxed, memory_order_relaxed ) )
+      return &p_bucket->entries[victim];
+  }
+}
+
+
+static float _data_value( uint64_t data ){
+  uint32_t value_bits = (uint32_t) data;
+  float value         = 0.0f;
+
+  memcpy( &value, &value_bits, sizeof( value ) );
+
+  return value;
+}
@@ -0,0 +1,130 @@
+/*
+ *  transposition.h
+ *
+ *  Created on: 17-Oct-2026
+ *      Author: lucas-noce
+ */
+
+#ifndef _TRANSPOSITION_H_
+#define _TRANSPOSITION_H_
+
+
+/* ==========================================================================================================
+ * Includes
+ */
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdatomic.h>
+
+#include "main.h"
+#include "game_config.h"
+
+
+/* ==========================================================================================================
+ * Definitions
+ */
+
+#define TRANSPOSITION_BUCKET_ENTRIES  4   // entries of a bucket, which fills one cache line
+
+
+/* ==========================================================================================================
+ * Typedefs
+ */
+
+/*!
+  @brief        An entry of the table. The entry is written without locks: `key` is the hash of the board, `data` packs
+                the value with the search it belongs to and the top bits of the hash, so a `data` written for another
+                key, or left by an older search, is read as a miss.
+
+  @param        key: the hash of the board, a fixed non-zero key for hash 0 (0 when the entry was never used).
+  @param        data: value (bits 0 to 31, a float), age of the search (bits 32 to 47) and bits 48 to 63 of the hash.
+*/
+typedef struct TRANSPOSITION_ENTRY_TAG{
+  atomic_uint_least64_t key;
+  atomic_uint_least64_t data;
+} TRANSPOSITION_ENTRY_T;
+
+/*!
+  @brief        The entries that a hash may use, on their own cache line.
+*/
+typedef struct TRANSPOSITION_BUCKET_TAG{
+  _Alignas( GAME_CONFIG_CACHE_LINE_SIZE ) TRANSPOSITION_ENTRY_T entries[TRANSPOSITION_BUCKET_ENTRIES];
+} TRANSPOSITION_BUCKET_T;
+
+/*!
+  @brief        Fixed-size table of the best value found for each board of a search, shared by the threads of the
+                search without locks.
+
+  @param        buckets: bucket_mask + 1 buckets, a hash uses the bucket of its low bits.
+  @param        bucket_mask: number of buckets minus one (the number of buckets is a power of 2).
+  @param        age: the current search, entries of older searches are replaced first and never read.
+  @param        p_storage: cache-aligned allocation that backs `buckets`.
+  @param        storage_size: size in bytes of `p_storage`.
+*/
+typedef struct TRANSPOSITION_TABLE_TAG{
+  TRANSPOSITION_BUCKET_T *buckets;
+  uint32_t               bucket_mask;
+  uint16_t               age;
+  void                   *p_storage;
+  size_t                 storage_size;
+} TRANSPOSITION_TABLE_T;
+
+
+/* ==========================================================================================================
+ * Global Functions
+ */
+
+/*!
+  @brief        Allocates an empty table.
+
+  @param[out]   p_table: pointer to the table.
+  @param[in]    bucket_count: number of buckets, rounded up to a power of 2.
+
+  @returns      One of the possible TETRIS_RET_x macro values (defined in main.h).
+*/
+int8_t transposition_init( TRANSPOSITION_TABLE_T *p_table, uint32_t bucket_count );
+
+/*!
+  @brief        Releases the table.
+
+  @param[in]    p_table: pointer to the table.
+
+  @returns      void
+*/
+void transposition_deinit( TRANSPOSITION_TABLE_T *p_table );
+
+/*!
+  @brief        Starts a new search: the entries stored so far are no longer read, and are the first ones replaced.
+
+  @param[in]    p_table: pointer to the table, not used by any thread meanwhile.
+
+  @returns      void
+*/
+void transposition_new_search( TRANSPOSITION_TABLE_T *p_table );
+
+/*!
+  @brief        Stores the value of a board, keeping the highest value stored for it during the current search. May
+                be called by several threads at once.
+
+  @param[in]    p_table: pointer to the table.
+  @param[in]    hash: hash of the board, any value (0, the hash of the empty board, included).
+  @param[in]    value: the value.
+
+  @returns      true, or false if every entry of the bucket already holds another board of the current search.
+*/
+bool transposition_store( TRANSPOSITION_TABLE_T *p_table, uint64_t hash, float value );
+
+/*!
+  @brief        Gets the highest value stored for a board during the current search.
+
+  @param[in]    p_table: pointer to the table.
+  @param[in]    hash: hash of the board.
+  @param[out]   p_value: the value, if found.
+
+  @returns      Whether the board was stored during the current search.
+*/
+bool transposition_probe( TRANSPOSITION_TABLE_T *p_table, uint64_t hash, float *p_value );
+
+#endif /* _TRANSPOSITION_H_ */